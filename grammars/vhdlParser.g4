@@ -28,9 +28,11 @@ actual_parameter_part
     : association_list
     ;
 
+// The conversion-function form `name LPAREN actual_designator RPAREN` is
+// covered by `actual_designator` (a name with a call part), so it was dropped
+// to keep the decision SLL-resolvable without scanning to the closing paren.
 actual_part
-    : name LPAREN actual_designator RPAREN
-    | actual_designator
+    : actual_designator
     ;
 
 adding_operator
@@ -223,10 +225,11 @@ case_statement_alternative
     : WHEN choices ARROW sequence_of_statements
     ;
 
+// `identifier` and `simple_expression` are both covered by `discrete_range`
+// (via `explicit_range`); listing them separately forced full-context
+// prediction on every case/selected-assignment choice.
 choice
-    : identifier
-    | discrete_range
-    | simple_expression
+    : discrete_range
     | OTHERS
     ;
 
@@ -777,8 +780,10 @@ selected_name
     : identifier (DOT suffix)*
     ;
 
+// One suffix per part; `(DOT suffix)+` was ambiguous with the enclosing
+// `name_part*` loop.
 selected_name_part
-    : (DOT suffix)+
+    : DOT suffix
     ;
 
 function_call_or_indexed_name_part
@@ -902,10 +907,11 @@ port_map_aspect
     : PORT MAP LPAREN association_list RPAREN
     ;
 
+// A parenthesized expression is a single positional `aggregate`; the translator
+// tells the two apart so prediction never has to scan the whole parenthesis.
 primary
     : literal
     | qualified_expression
-    | LPAREN expression RPAREN
     | allocator
     | aggregate
     | name
@@ -998,9 +1004,9 @@ quantity_specification
     : quantity_list COLON name
     ;
 
+// `name` (e.g. `x'range`) is already reachable through `explicit_range`.
 range_decl
     : explicit_range
-    | name
     ;
 
 explicit_range
@@ -1,6 +1,7 @@
 #ifndef AST_NODE_HPP
 #define AST_NODE_HPP
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <span>
@@ -36,11 +37,29 @@ struct NodeTrivia final
     std::optional<Comment> inline_comment;
 };
 
+/// @brief Where a node was parsed from: its inclusive token index range and the bytes from
+///        its first to its last token, excluding any trivia.
+/// @note Nodes that were not built from a parse context keep the empty default span.
+struct SourceSpan final
+{
+    std::size_t first_token{0};
+    std::size_t last_token{0};
+    std::size_t begin{0}; ///< Byte offset of the first token
+    std::size_t end{0};   ///< Byte offset one past the last token
+
+    [[nodiscard]]
+    auto empty() const -> bool
+    {
+        return begin == end;
+    }
+};
+
 /// @brief Abstract base class for all AST nodes - Do not instantiate directly.
 /// @note There is no virtual destructor to leverage aggregate initialization.
 struct NodeBase
 {
     std::unique_ptr<NodeTrivia> trivia;
+    SourceSpan span{};
 
     auto addLeading(Trivia t) -> void
     {
@@ -6,6 +6,7 @@
 #include "ast/nodes/declarations/interface.hpp"
 #include "ast/nodes/statements.hpp"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <variant>
@@ -81,6 +82,10 @@ struct DesignUnit final : NodeBase
 {
     std::vector<ContextItem> context;
     LibraryUnit unit;
+
+    /// Structural hash over the unit's tokens and trivia, 0 if the unit was not translated
+    /// from a token stream. Equal hashes format to equal text under the same config.
+    std::uint64_t hash{0};
 };
 
 } // namespace ast
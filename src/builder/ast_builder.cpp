@@ -1,7 +1,11 @@
 #include "builder/ast_builder.hpp"
 
+#include "builder/prediction_cache.hpp"
+#include "builder/token_store.hpp"
 #include "builder/translator.hpp"
+#include "common/cancellation.hpp"
 #include "common/logger.hpp"
+#include "common/stats.hpp"
 #include "nodes/design_file.hpp"
 
 #include <antlr4-runtime/ANTLRInputStream.h>
@@ -10,11 +14,14 @@
 #include <antlr4-runtime/CommonTokenStream.h>
 #include <antlr4-runtime/DefaultErrorStrategy.h>
 #include <antlr4-runtime/Exceptions.h>
+#include <antlr4-runtime/Parser.h>
 #include <antlr4-runtime/Recognizer.h>
 #include <antlr4-runtime/Token.h>
 #include <antlr4-runtime/atn/ParserATNSimulator.h>
 #include <antlr4-runtime/atn/PredictionMode.h>
+#include <antlr4-runtime/tree/ParseTree.h>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
 #include <format>
@@ -41,11 +48,26 @@ auto initializeContext(Context& ctx, std::unique_ptr<antlr4::ANTLRInputStream> i
     ctx.lexer->removeErrorListeners();
 
     ctx.tokens = std::make_unique<antlr4::CommonTokenStream>(ctx.lexer.get());
-    ctx.tokens->fill();
+    {
+        // Lexing extends the shared lexer DFA
+        const auto lease = PredictionCache::instance().lease();
+        const common::stats::Timer timer{common::stats::Phase::LEX};
+        ctx.tokens->fill();
+    }
 
     ctx.parser = std::make_unique<vhdlParser>(ctx.tokens.get());
 }
 
+// Parse tree nodes for --stats; only walked when statistics are collected
+auto countNodes(const antlr4::tree::ParseTree& tree) -> std::uint64_t
+{
+    std::uint64_t count{1};
+    for (const auto* child : tree.children) {
+        count += countNodes(*child);
+    }
+    return count;
+}
+
 class ThrowingErrorListener final : public antlr4::BaseErrorListener
 {
   public:
@@ -61,6 +83,75 @@ class ThrowingErrorListener final : public antlr4::BaseErrorListener
     }
 };
 
+/// @brief Error strategy that doubles as a cancellation point: the generated parser calls
+///        sync() ahead of every loop iteration and alternative it predicts.
+template<typename Strategy>
+class CancellableStrategy final : public Strategy
+{
+  public:
+    explicit CancellableStrategy(common::CancellationToken cancellation)
+        : cancellation_{std::move(cancellation)}
+    {}
+
+    auto sync(antlr4::Parser* recognizer) -> void override
+    {
+        cancellation_.poll();
+        Strategy::sync(recognizer);
+    }
+
+  private:
+    common::CancellationToken cancellation_;
+};
+
+/// @brief Runs a parser rule with SLL prediction, falling back to full LL if that fails.
+/// @note The rule restarts from the token it started on, so this also works mid-stream.
+template<typename Rule>
+auto parseWithFallback(Context& ctx, Rule rule) -> decltype(rule())
+{
+    const auto lease = PredictionCache::instance().lease();
+
+    auto* interpreter = ctx.parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+    const auto start = ctx.tokens->index();
+
+    // 1. Try SLL
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    ctx.parser->setErrorHandler(
+      std::make_shared<CancellableStrategy<antlr4::BailErrorStrategy>>(ctx.cancellation));
+    ctx.parser->removeErrorListeners();
+
+    try {
+        const common::stats::Timer timer{common::stats::Phase::SLL_PARSE};
+        return rule();
+    }
+    catch (const antlr4::ParseCancellationException&) {
+        common::Logger::instance().trace(
+          "SLL parsing failed (ambiguity). Falling back to LL mode.");
+    }
+
+    // 2. Fallback to LL
+    ctx.used_ll_fallback = true;
+    common::stats::count(common::stats::Counter::LL_FALLBACKS);
+    const common::stats::Timer timer{common::stats::Phase::LL_PARSE};
+    ctx.parser->reset();
+    ctx.tokens->seek(start);
+
+    ctx.parser->removeErrorListeners();
+
+    // Add custom ThrowingListener (aborts immediately on error)
+    ThrowingErrorListener throwing_listener;
+    ctx.parser->addErrorListener(&throwing_listener);
+
+    ctx.parser->setErrorHandler(
+      std::make_shared<CancellableStrategy<antlr4::DefaultErrorStrategy>>(ctx.cancellation));
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+
+    auto tree = rule();
+
+    // The listener goes out of scope with this frame
+    ctx.parser->removeErrorListeners();
+    return tree;
+}
+
 } // namespace
 
 // --- Fine-grained Implementation ---
@@ -86,45 +177,104 @@ auto createContext(std::string_view source) -> Context
     return ctx;
 }
 
-auto build(Context& ctx) -> ast::DesignFile
+auto loadContext(Context& ctx, std::string_view source) -> void
 {
-    auto* interpreter = ctx.parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+    if (ctx.input == nullptr || ctx.lexer == nullptr) {
+        ctx = createContext(source);
+        return;
+    }
 
-    // 1. Try SLL
-    interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
-    ctx.parser->setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
-    ctx.parser->removeErrorListeners();
+    ctx.input->load(source.data(), source.size(), false);
+    ctx.lexer->setInputStream(ctx.input.get());
+    ctx.tokens->setTokenSource(ctx.lexer.get());
+    {
+        // Lexing extends the shared lexer DFA
+        const auto lease = PredictionCache::instance().lease();
+        const common::stats::Timer timer{common::stats::Phase::LEX};
+        ctx.tokens->fill();
+    }
 
-    vhdlParser::Design_fileContext* tree = nullptr;
+    ctx.parser->setTokenStream(ctx.tokens.get());
+    ctx.used_ll_fallback = false;
+}
 
-    try {
-        tree = ctx.parser->design_file();
-    }
-    catch (const antlr4::ParseCancellationException&) {
-        common::Logger::instance().trace(
-          "SLL parsing failed (ambiguity). Falling back to LL mode.");
+auto createContext(const TokenStore& store, std::size_t begin, std::size_t end) -> Context
+{
+    Context ctx{};
+    ctx.replay = store.replay(begin, end);
+    ctx.tokens = std::make_unique<antlr4::CommonTokenStream>(ctx.replay.get());
+    ctx.tokens->fill();
+    ctx.parser = std::make_unique<vhdlParser>(ctx.tokens.get());
+    return ctx;
+}
 
-        // 2. Fallback to LL
-        (*ctx.tokens).reset();
-        (*ctx.parser).reset();
+auto parse(Context& ctx) -> vhdlParser::Design_fileContext*
+{
+    auto* tree = parseWithFallback(ctx, [&ctx] { return ctx.parser->design_file(); });
+    PredictionCache::instance().enforceCeiling();
 
-        ctx.parser->removeErrorListeners();
+    if (tree == nullptr) {
+        throw std::runtime_error("Parser returned null tree.");
+    }
 
-        // Add custom ThrowingListener (aborts immediately on error)
-        ThrowingErrorListener throwing_listener;
-        ctx.parser->addErrorListener(&throwing_listener);
+    return tree;
+}
 
-        ctx.parser->setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
-        interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+auto build(Context& ctx) -> ast::DesignFile
+{
+    auto* tree = parse(ctx);
 
-        tree = ctx.parser->design_file();
+    if (common::stats::enabled()) {
+        common::stats::count(common::stats::Counter::TOKENS, ctx.tokens->size());
+        common::stats::count(common::stats::Counter::CST_NODES, countNodes(*tree));
     }
 
-    if (tree == nullptr) {
-        throw std::runtime_error("Parser returned null tree.");
+    const common::stats::Timer timer{common::stats::Phase::TRANSLATE};
+    return Translator{*ctx.tokens}.buildDesignFile(tree);
+}
+
+auto buildIncremental(Context& ctx, const DesignUnitSink& sink) -> void
+{
+    // One translator for the whole stream: trivia ownership spans unit boundaries
+    Translator translator{*ctx.tokens};
+    common::stats::count(common::stats::Counter::TOKENS, ctx.tokens->size());
+
+    while (ctx.tokens->LA(1) != antlr4::Token::EOF) {
+        ctx.cancellation.check();
+
+        auto* unit = parseWithFallback(ctx, [&ctx] { return ctx.parser->design_unit(); });
+
+        if (unit == nullptr) {
+            throw std::runtime_error("Parser returned null tree.");
+        }
+
+        PredictionCache::instance().enforceCeiling();
+        if (common::stats::enabled()) {
+            common::stats::count(common::stats::Counter::CST_NODES, countNodes(*unit));
+        }
+
+        auto translated = [&] {
+            const common::stats::Timer timer{common::stats::Phase::TRANSLATE};
+            return translator.buildDesignUnit(unit);
+        }();
+        sink(std::move(translated),
+             TokenSpan{.start = unit->getStart()->getTokenIndex(),
+                       .stop = unit->getStop()->getTokenIndex()});
+
+        // Release the unit's parse tree before the next one is built
+        const auto next = ctx.tokens->index();
+        ctx.parser->reset();
+        ctx.tokens->seek(next);
     }
+}
 
-    return Translator{*ctx.tokens}.buildDesignFile(tree);
+auto buildIncremental(Context& ctx) -> ast::DesignFile
+{
+    ast::DesignFile root{};
+    buildIncremental(ctx, [&root](ast::DesignUnit unit, TokenSpan /*span*/) {
+        root.units.push_back(std::move(unit));
+    });
+    return root;
 }
 
 // --- High-level Wrapper Implementation ---
@@ -4,10 +4,15 @@
 #include "CommonTokenStream.h"
 #include "antlr4-runtime/ANTLRInputStream.h"
 #include "ast/nodes/design_file.hpp"
+#include "builder/token_store.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+#include "common/cancellation.hpp"
 #include "vhdlLexer.h"
 #include "vhdlParser.h"
 
+#include <cstddef>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string_view>
 
@@ -19,10 +24,22 @@ struct Context
 {
     std::unique_ptr<antlr4::ANTLRInputStream> input;
     std::unique_ptr<vhdlLexer> lexer;
+    std::unique_ptr<antlr4::TokenSource> replay; ///< Stands in for the lexer, see TokenStore
     std::unique_ptr<antlr4::CommonTokenStream> tokens;
     std::unique_ptr<vhdlParser> parser;
+
+    /// @brief Polled while parsing; parse() and buildIncremental() throw common::Cancelled
+    ///        once it is cancelled.
+    common::CancellationToken cancellation{};
+
+    /// @brief Set by parse() when SLL prediction failed and the full LL pass was needed.
+    bool used_ll_fallback{false};
 };
 
+/// @brief Receives each design unit as soon as it has been translated, along with the
+///        token span it was parsed from.
+using DesignUnitSink = std::function<void(ast::DesignUnit, TokenSpan)>;
+
 // ============================================================================
 // Fine-grained API (For advanced usage / verification)
 // ============================================================================
@@ -35,11 +52,38 @@ auto createContext(const std::filesystem::path& path) -> Context;
 [[nodiscard]]
 auto createContext(std::string_view source) -> Context;
 
+/// @brief Loads a new source into a context, reusing its input buffer, lexer, token buffer and
+///        parser if it has them; an empty context is set up like createContext() does.
+/// @note Any tree parsed from the previous source is released.
+auto loadContext(Context& ctx, std::string_view source) -> void;
+
+/// @brief Creates a parsing context over the bytes [begin, end) of an already lexed buffer.
+/// @note Token offsets are relative to `begin`, as if the range had been lexed on its own.
+/// @throws std::runtime_error if a token straddles either end of the range.
+[[nodiscard]]
+auto createContext(const TokenStore& store, std::size_t begin, std::size_t end) -> Context;
+
+/// @brief Parses the token stream of an existing context into a concrete syntax tree.
+/// @note Tries the fast SLL prediction first and only falls back to full LL on failure.
+///       The tree is owned by the context's parser.
+[[nodiscard]]
+auto parse(Context& ctx) -> vhdlParser::Design_fileContext*;
+
 /// @brief Builds the AST from an existing context.
 /// @note This keeps the context alive, allowing access to tokens after build.
 [[nodiscard]]
 auto build(Context& ctx) -> ast::DesignFile;
 
+/// @brief Parses and translates one design unit at a time.
+/// @note Each unit's parse tree is released before the next unit is parsed, so peak memory
+///       holds the largest unit's CST instead of the whole file's. SLL/LL fallback is
+///       decided per unit.
+auto buildIncremental(Context& ctx, const DesignUnitSink& sink) -> void;
+
+/// @brief Incremental counterpart of build(), collecting the units into a design file.
+[[nodiscard]]
+auto buildIncremental(Context& ctx) -> ast::DesignFile;
+
 // ============================================================================
 // High-level API (For standard usage / tests)
 // ============================================================================
@@ -0,0 +1,694 @@
+#include "builder/expression_parser.hpp"
+
+#include "CommonTokenStream.h"
+#include "Token.h"
+#include "ast/nodes/expressions.hpp"
+#include "builder/node_builder.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+#include "builder/trivia/utils.hpp"
+#include "vhdlParser.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace builder {
+
+namespace {
+
+template<typename... Ts>
+[[nodiscard]]
+constexpr auto tokenTypes(Ts... types) -> std::array<std::size_t, sizeof...(Ts)>
+{
+    return {static_cast<std::size_t>(types)...};
+}
+
+// clang-format off
+constexpr auto LOGICAL_OPERATORS = tokenTypes(
+  vhdlParser::AND, vhdlParser::OR, vhdlParser::NAND, vhdlParser::NOR, vhdlParser::XOR, vhdlParser::XNOR);
+constexpr auto RELATIONAL_OPERATORS = tokenTypes(
+  vhdlParser::EQ, vhdlParser::NEQ, vhdlParser::LOWERTHAN, vhdlParser::LE, vhdlParser::GREATERTHAN, vhdlParser::GE);
+constexpr auto SHIFT_OPERATORS = tokenTypes(
+  vhdlParser::SLL, vhdlParser::SRL, vhdlParser::SLA, vhdlParser::SRA, vhdlParser::ROL, vhdlParser::ROR);
+constexpr auto ADDING_OPERATORS = tokenTypes(vhdlParser::PLUS, vhdlParser::MINUS, vhdlParser::AMPERSAND);
+constexpr auto MULTIPLYING_OPERATORS = tokenTypes(vhdlParser::MUL, vhdlParser::DIV, vhdlParser::MOD, vhdlParser::REM);
+constexpr auto SIGNS = tokenTypes(vhdlParser::PLUS, vhdlParser::MINUS);
+constexpr auto PREFIX_OPERATORS = tokenTypes(vhdlParser::ABS, vhdlParser::NOT);
+constexpr auto DIRECTIONS = tokenTypes(vhdlParser::TO, vhdlParser::DOWNTO);
+constexpr auto IDENTIFIERS = tokenTypes(vhdlParser::BASIC_IDENTIFIER, vhdlParser::EXTENDED_IDENTIFIER);
+constexpr auto ABSTRACT_LITERALS = tokenTypes(vhdlParser::INTEGER, vhdlParser::REAL_LITERAL, vhdlParser::BASE_LITERAL);
+constexpr auto OTHER_LITERALS = tokenTypes(vhdlParser::NULL_, vhdlParser::BIT_STRING_LITERAL, vhdlParser::CHARACTER_LITERAL);
+constexpr auto SUFFIXES = tokenTypes(
+  vhdlParser::BASIC_IDENTIFIER, vhdlParser::EXTENDED_IDENTIFIER, vhdlParser::CHARACTER_LITERAL,
+  vhdlParser::STRING_LITERAL, vhdlParser::ALL);
+constexpr auto ATTRIBUTE_DESIGNATORS = tokenTypes(
+  vhdlParser::BASIC_IDENTIFIER, vhdlParser::EXTENDED_IDENTIFIER, vhdlParser::RANGE, vhdlParser::REVERSE_RANGE,
+  vhdlParser::ACROSS, vhdlParser::THROUGH, vhdlParser::REFERENCE, vhdlParser::TOLERANCE);
+
+// Tokens that always need the CST translation (named associations, allocators, signatures, ...)
+constexpr auto DECLINED = tokenTypes(
+  vhdlParser::ARROW, vhdlParser::NEW, vhdlParser::OPEN, vhdlParser::LBRACKET, vhdlParser::OTHERS,
+  vhdlParser::BAR, vhdlParser::BOX);
+// clang-format on
+
+template<std::size_t N>
+[[nodiscard]]
+constexpr auto isAnyOf(std::size_t type, const std::array<std::size_t, N>& types) -> bool
+{
+    return std::ranges::find(types, type) != std::ranges::end(types);
+}
+
+[[nodiscard]]
+auto makeBinary(TriviaBinder& trivia,
+                TokenSpan span,
+                std::string op,
+                ast::Expr left,
+                ast::Expr right) -> ast::BinaryExpr
+{
+    return NodeBuilder<ast::BinaryExpr>(span, trivia)
+      .set(&ast::BinaryExpr::op, std::move(op))
+      .setBox(&ast::BinaryExpr::left, std::move(left))
+      .setBox(&ast::BinaryExpr::right, std::move(right))
+      .build();
+}
+
+[[nodiscard]]
+auto makeUnary(TriviaBinder& trivia, TokenSpan span, std::string op, ast::Expr value)
+  -> ast::UnaryExpr
+{
+    return NodeBuilder<ast::UnaryExpr>(span, trivia)
+      .set(&ast::UnaryExpr::op, std::move(op))
+      .setBox(&ast::UnaryExpr::value, std::move(value))
+      .build();
+}
+
+[[nodiscard]]
+auto makeToken(TriviaBinder& trivia, TokenSpan span, std::string text) -> ast::TokenExpr
+{
+    return NodeBuilder<ast::TokenExpr>(span, trivia)
+      .set(&ast::TokenExpr::text, std::move(text))
+      .build();
+}
+
+} // namespace
+
+ExpressionParser::ExpressionParser(antlr4::CommonTokenStream& tokens, TriviaBinder& trivia) :
+  tokens_(tokens),
+  trivia_(trivia)
+{
+}
+
+auto ExpressionParser::parse(std::size_t start, std::size_t stop) -> std::optional<ast::Expr>
+{
+    toks_.clear();
+    nodes_.clear();
+    pos_ = 0;
+
+    for (auto index = start; index <= stop; ++index) {
+        auto* token = tokens_.get(index);
+
+        // Comments inside the span are rare; leave their placement to the CST walk
+        if (isComment(token)) {
+            return std::nullopt;
+        }
+
+        if (token->getChannel() != antlr4::Token::DEFAULT_CHANNEL) {
+            continue;
+        }
+
+        if (isAnyOf(token->getType(), DECLINED)) {
+            return std::nullopt;
+        }
+
+        toks_.push_back(token);
+    }
+
+    const auto root = parseExpression();
+    if (!root.has_value() || pos_ != toks_.size()) {
+        return std::nullopt;
+    }
+
+    return emit(*root);
+}
+
+// ---------------------------------------------------------------------------
+// Phase 1: shape
+// ---------------------------------------------------------------------------
+
+auto ExpressionParser::parseExpression() -> std::optional<std::size_t>
+{
+    // expression : relation (logical_operator relation)*
+    auto first = parseRelation();
+    if (!first.has_value()) {
+        return std::nullopt;
+    }
+
+    std::vector<std::size_t> operands{*first};
+    std::vector<antlr4::Token*> ops{};
+
+    while (isAnyOf(peekType(), LOGICAL_OPERATORS)) {
+        ops.push_back(toks_.at(pos_++));
+
+        auto next = parseRelation();
+        if (!next.has_value()) {
+            return std::nullopt;
+        }
+        operands.push_back(*next);
+    }
+
+    return chain(std::move(operands), std::move(ops), false);
+}
+
+auto ExpressionParser::parseRelation() -> std::optional<std::size_t>
+{
+    // relation : shift_expression (relational_operator shift_expression)?
+    auto left = parseShift();
+    if (!left.has_value() || !isAnyOf(peekType(), RELATIONAL_OPERATORS)) {
+        return left;
+    }
+
+    auto* op = toks_.at(pos_++);
+
+    auto right = parseShift();
+    if (!right.has_value()) {
+        return std::nullopt;
+    }
+
+    return chain({*left, *right}, {op}, false);
+}
+
+auto ExpressionParser::parseShift() -> std::optional<std::size_t>
+{
+    // shift_expression : simple_expression (shift_operator simple_expression)?
+    auto left = parseSimple();
+    if (!left.has_value() || !isAnyOf(peekType(), SHIFT_OPERATORS)) {
+        return left;
+    }
+
+    auto* op = toks_.at(pos_++);
+
+    auto right = parseSimple();
+    if (!right.has_value()) {
+        return std::nullopt;
+    }
+
+    return chain({*left, *right}, {op}, false);
+}
+
+auto ExpressionParser::parseSimple() -> std::optional<std::size_t>
+{
+    // simple_expression : (PLUS | MINUS)? term (adding_operator term)*
+    std::vector<antlr4::Token*> ops{};
+
+    const bool signed_chain = isAnyOf(peekType(), SIGNS);
+    if (signed_chain) {
+        ops.push_back(toks_.at(pos_++));
+    }
+
+    auto first = parseTerm();
+    if (!first.has_value()) {
+        return std::nullopt;
+    }
+
+    std::vector<std::size_t> operands{*first};
+
+    while (isAnyOf(peekType(), ADDING_OPERATORS)) {
+        ops.push_back(toks_.at(pos_++));
+
+        auto next = parseTerm();
+        if (!next.has_value()) {
+            return std::nullopt;
+        }
+        operands.push_back(*next);
+    }
+
+    return chain(std::move(operands), std::move(ops), signed_chain);
+}
+
+auto ExpressionParser::parseTerm() -> std::optional<std::size_t>
+{
+    // term : factor (multiplying_operator factor)*
+    auto first = parseFactor();
+    if (!first.has_value()) {
+        return std::nullopt;
+    }
+
+    std::vector<std::size_t> operands{*first};
+    std::vector<antlr4::Token*> ops{};
+
+    while (isAnyOf(peekType(), MULTIPLYING_OPERATORS)) {
+        ops.push_back(toks_.at(pos_++));
+
+        auto next = parseFactor();
+        if (!next.has_value()) {
+            return std::nullopt;
+        }
+        operands.push_back(*next);
+    }
+
+    return chain(std::move(operands), std::move(ops), false);
+}
+
+auto ExpressionParser::parseFactor() -> std::optional<std::size_t>
+{
+    // factor : primary (DOUBLESTAR primary)? | ABS primary | NOT primary
+    if (isAnyOf(peekType(), PREFIX_OPERATORS)) {
+        const auto op = pos_++;
+
+        auto operand = parsePrimary();
+        if (!operand.has_value()) {
+            return std::nullopt;
+        }
+
+        return add(Syntax{
+          .kind = Syntax::Kind::PREFIX,
+          .span = {.start = toks_.at(op)->getTokenIndex(), .stop = nodes_.at(*operand).span.stop},
+          .children = {*operand},
+          .ops = {toks_.at(op)},
+        });
+    }
+
+    auto base = parsePrimary();
+    if (!base.has_value() || peekType() != vhdlParser::DOUBLESTAR) {
+        return base;
+    }
+
+    ++pos_;
+
+    auto exponent = parsePrimary();
+    if (!exponent.has_value()) {
+        return std::nullopt;
+    }
+
+    return add(Syntax{
+      .kind = Syntax::Kind::POWER,
+      .span = spanOfNodes(*base, *exponent),
+      .children = {*base, *exponent},
+    });
+}
+
+auto ExpressionParser::parsePrimary() -> std::optional<std::size_t>
+{
+    const auto type = peekType();
+
+    if (type == vhdlParser::LPAREN) {
+        return parseParenthesized();
+    }
+
+    if (isAnyOf(type, IDENTIFIERS) || type == vhdlParser::STRING_LITERAL) {
+        return parseName();
+    }
+
+    if (isAnyOf(type, ABSTRACT_LITERALS) && isAnyOf(peekType(1), IDENTIFIERS)) {
+        pos_ += 2;
+        return add(Syntax{.kind = Syntax::Kind::PHYSICAL, .span = spanOf(pos_ - 2, pos_ - 1)});
+    }
+
+    if (isAnyOf(type, ABSTRACT_LITERALS) || isAnyOf(type, OTHER_LITERALS)) {
+        ++pos_;
+        return add(Syntax{.kind = Syntax::Kind::TOKEN, .span = spanOf(pos_ - 1, pos_ - 1)});
+    }
+
+    // Allocators, qualified expressions, ...
+    return std::nullopt;
+}
+
+auto ExpressionParser::parseParenthesized() -> std::optional<std::size_t>
+{
+    // A discrete range at depth 0 belongs to a named association: not modelled
+    const auto group = scanGroup();
+    if (!group.has_value() || group->has_direction) {
+        return std::nullopt;
+    }
+
+    const auto open = pos_++;
+
+    std::vector<std::size_t> elements{};
+    while (true) {
+        auto element = parseExpression();
+        if (!element.has_value()) {
+            return std::nullopt;
+        }
+        elements.push_back(*element);
+
+        if (peekType() != vhdlParser::COMMA) {
+            break;
+        }
+        ++pos_;
+    }
+
+    if (peekType() != vhdlParser::RPAREN) {
+        return std::nullopt;
+    }
+    ++pos_;
+
+    const auto kind = (elements.size() == 1) ? Syntax::Kind::PAREN : Syntax::Kind::AGGREGATE;
+    return add(Syntax{.kind = kind, .span = spanOf(open, pos_ - 1), .children = std::move(elements)});
+}
+
+auto ExpressionParser::parseName() -> std::optional<std::size_t>
+{
+    // name : (identifier | STRING_LITERAL) name_part*
+    const auto base = pos_++;
+
+    while (peekType() == vhdlParser::DOT) {
+        if (!isAnyOf(peekType(1), SUFFIXES)) {
+            return std::nullopt;
+        }
+        pos_ += 2;
+    }
+
+    const auto prefix = spanOf(base, pos_ - 1);
+
+    std::vector<std::size_t> parts{};
+    while (peekType() == vhdlParser::LPAREN || peekType() == vhdlParser::APOSTROPHE) {
+        auto part = parseNamePart();
+        if (!part.has_value()) {
+            return std::nullopt;
+        }
+        parts.push_back(*part);
+    }
+
+    // Selected parts after a call/slice/attribute are dropped by the CST translation as well
+    if (peekType() == vhdlParser::DOT) {
+        return std::nullopt;
+    }
+
+    if (parts.empty()) {
+        return add(Syntax{.kind = Syntax::Kind::TOKEN, .span = prefix});
+    }
+
+    return add(Syntax{
+      .kind = Syntax::Kind::NAME,
+      .span = {.start = prefix.start, .stop = nodes_.at(parts.back()).span.stop},
+      .prefix = prefix,
+      .children = std::move(parts),
+    });
+}
+
+auto ExpressionParser::parseNamePart() -> std::optional<std::size_t>
+{
+    const auto open = pos_;
+
+    // attribute_name_part : APOSTROPHE attribute_designator (LPAREN expression RPAREN)?
+    if (peekType() == vhdlParser::APOSTROPHE) {
+        // `'(` starts a qualified expression
+        if (!isAnyOf(peekType(1), ATTRIBUTE_DESIGNATORS)) {
+            return std::nullopt;
+        }
+        pos_ += 2;
+
+        std::vector<std::size_t> args{};
+        if (peekType() == vhdlParser::LPAREN) {
+            const auto group = scanGroup();
+            if (!group.has_value() || group->commas != 0 || group->has_direction) {
+                return std::nullopt;
+            }
+            ++pos_;
+
+            auto arg = parseExpression();
+            if (!arg.has_value() || peekType() != vhdlParser::RPAREN) {
+                return std::nullopt;
+            }
+            ++pos_;
+            args.push_back(*arg);
+        }
+
+        return add(Syntax{
+          .kind = Syntax::Kind::ATTRIBUTE,
+          .span = spanOf(open, pos_ - 1),
+          .children = std::move(args),
+          .ops = {toks_.at(open + 1)},
+        });
+    }
+
+    const auto group = scanGroup();
+    if (!group.has_value()) {
+        return std::nullopt;
+    }
+    ++pos_;
+
+    // slice_name_part : LPAREN discrete_range RPAREN (only reachable with a direction)
+    if (group->has_direction) {
+        if (group->commas != 0) {
+            return std::nullopt;
+        }
+
+        auto low = parseSimple();
+        if (!low.has_value() || !isAnyOf(peekType(), DIRECTIONS)) {
+            return std::nullopt;
+        }
+
+        auto* direction = toks_.at(pos_++);
+
+        auto high = parseSimple();
+        if (!high.has_value() || peekType() != vhdlParser::RPAREN) {
+            return std::nullopt;
+        }
+        ++pos_;
+
+        return add(Syntax{
+          .kind = Syntax::Kind::SLICE,
+          .span = spanOf(open, pos_ - 1),
+          .children = {*low, *high},
+          .ops = {direction},
+        });
+    }
+
+    // function_call_or_indexed_name_part : LPAREN actual_parameter_part RPAREN
+    std::vector<std::size_t> args{};
+    while (true) {
+        auto arg = parseExpression();
+        if (!arg.has_value()) {
+            return std::nullopt;
+        }
+        args.push_back(*arg);
+
+        if (peekType() != vhdlParser::COMMA) {
+            break;
+        }
+        ++pos_;
+    }
+
+    if (peekType() != vhdlParser::RPAREN) {
+        return std::nullopt;
+    }
+    ++pos_;
+
+    return add(Syntax{
+      .kind = Syntax::Kind::CALL,
+      .span = spanOf(open, pos_ - 1),
+      .children = std::move(args),
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Phase 2: emission (mirrors the binding order of the Translator)
+// ---------------------------------------------------------------------------
+
+auto ExpressionParser::emit(std::size_t index) -> ast::Expr
+{
+    const auto& node = nodes_.at(index);
+
+    switch (node.kind) {
+        case Syntax::Kind::CHAIN: {
+            auto op = node.ops.begin();
+
+            ast::Expr acc = emit(node.children.front());
+            if (node.signed_chain) {
+                acc = makeUnary(trivia_, node.span, (*op++)->getText(), std::move(acc));
+            }
+
+            for (const auto child : node.children | std::views::drop(1)) {
+                ast::Expr right = emit(child);
+                acc = makeBinary(
+                  trivia_, node.span, (*op++)->getText(), std::move(acc), std::move(right));
+            }
+
+            return acc;
+        }
+
+        case Syntax::Kind::POWER: {
+            ast::Expr base = emit(node.children.at(0));
+            ast::Expr exponent = emit(node.children.at(1));
+            return makeBinary(trivia_, node.span, "**", std::move(base), std::move(exponent));
+        }
+
+        case Syntax::Kind::PREFIX: {
+            const auto* op = (node.ops.front()->getType() == vhdlParser::ABS) ? "abs" : "not";
+            return makeUnary(trivia_, node.span, op, emit(node.children.front()));
+        }
+
+        case Syntax::Kind::TOKEN:
+            return makeToken(trivia_, node.span, spanText(node.span));
+
+        case Syntax::Kind::PHYSICAL:
+            return NodeBuilder<ast::PhysicalLiteral>(node.span, trivia_)
+              .set(&ast::PhysicalLiteral::value, tokens_.get(node.span.start)->getText())
+              .set(&ast::PhysicalLiteral::unit, tokens_.get(node.span.stop)->getText())
+              .build();
+
+        case Syntax::Kind::NAME:
+            return emitName(node);
+
+        case Syntax::Kind::PAREN:
+            return NodeBuilder<ast::ParenExpr>(node.span, trivia_)
+              .setBox(&ast::ParenExpr::inner, emit(node.children.front()))
+              .build();
+
+        case Syntax::Kind::AGGREGATE:
+            return NodeBuilder<ast::GroupExpr>(node.span, trivia_)
+              .collect(&ast::GroupExpr::children,
+                       node.children,
+                       [this](std::size_t child) { return emit(child); })
+              .build();
+
+        case Syntax::Kind::CALL:
+        case Syntax::Kind::SLICE:
+        case Syntax::Kind::ATTRIBUTE:
+            break;
+    }
+
+    // Name parts are only reachable through emitName()
+    return makeToken(trivia_, node.span, spanText(node.span));
+}
+
+auto ExpressionParser::emitName(const Syntax& node) -> ast::Expr
+{
+    ast::Expr base = makeToken(trivia_, node.prefix, spanText(node.prefix));
+
+    for (const auto index : node.children) {
+        const auto& part = nodes_.at(index);
+
+        if (part.kind == Syntax::Kind::CALL) {
+            ast::GroupExpr args{};
+            args.children = part.children
+                          | std::views::transform([this](std::size_t arg) { return emit(arg); })
+                          | std::ranges::to<decltype(args.children)>();
+
+            base = NodeBuilder<ast::CallExpr>(part.span, trivia_)
+                     .setBox(&ast::CallExpr::callee, std::move(base))
+                     .setBox(&ast::CallExpr::args, std::move(args))
+                     .build();
+        } else if (part.kind == Syntax::Kind::SLICE) {
+            base = NodeBuilder<ast::SliceExpr>(part.span, trivia_)
+                     .setBox(&ast::SliceExpr::prefix, std::move(base))
+                     .apply([&](auto& slice) {
+                         ast::Expr low = emit(part.children.at(0));
+                         ast::Expr high = emit(part.children.at(1));
+                         slice.range = std::make_unique<ast::Expr>(
+                           makeBinary(trivia_,
+                                      spanOfNodes(part.children.at(0), part.children.at(1)),
+                                      part.ops.front()->getText(),
+                                      std::move(low),
+                                      std::move(high)));
+                     })
+                     .build();
+        } else {
+            base = NodeBuilder<ast::AttributeExpr>(part.span, trivia_)
+                     .setBox(&ast::AttributeExpr::prefix, std::move(base))
+                     .set(&ast::AttributeExpr::attribute, part.ops.front()->getText())
+                     .apply([&](auto& attr) {
+                         if (!part.children.empty()) {
+                             attr.arg = std::make_unique<ast::Expr>(emit(part.children.front()));
+                         }
+                     })
+                     .build();
+        }
+    }
+
+    return base;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+auto ExpressionParser::peekType(std::size_t offset) const -> std::size_t
+{
+    const auto index = pos_ + offset;
+    return (index < toks_.size()) ? toks_.at(index)->getType() : antlr4::Token::EOF;
+}
+
+auto ExpressionParser::scanGroup() const -> std::optional<Group>
+{
+    Group group{.commas = 0, .has_direction = false};
+    std::size_t depth = 0;
+
+    for (const auto* token : toks_ | std::views::drop(pos_)) {
+        const auto type = token->getType();
+
+        if (type == vhdlParser::LPAREN) {
+            ++depth;
+        } else if (type == vhdlParser::RPAREN) {
+            if (--depth == 0) {
+                return group;
+            }
+        } else if (depth == 1 && type == vhdlParser::COMMA) {
+            ++group.commas;
+        } else if (depth == 1 && isAnyOf(type, DIRECTIONS)) {
+            group.has_direction = true;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto ExpressionParser::spanText(TokenSpan span) const -> std::string
+{
+    std::string text{};
+    for (auto index = span.start; index <= span.stop; ++index) {
+        const auto* token = tokens_.get(index);
+        if (token->getChannel() == antlr4::Token::DEFAULT_CHANNEL) {
+            text += token->getText();
+        }
+    }
+    return text;
+}
+
+auto ExpressionParser::spanOf(std::size_t first, std::size_t last) const -> TokenSpan
+{
+    return {.start = toks_.at(first)->getTokenIndex(), .stop = toks_.at(last)->getTokenIndex()};
+}
+
+auto ExpressionParser::spanOfNodes(std::size_t first, std::size_t last) const -> TokenSpan
+{
+    return {.start = nodes_.at(first).span.start, .stop = nodes_.at(last).span.stop};
+}
+
+auto ExpressionParser::add(Syntax node) -> std::size_t
+{
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1;
+}
+
+auto ExpressionParser::chain(std::vector<std::size_t> operands,
+                             std::vector<antlr4::Token*> ops,
+                             bool signed_chain) -> std::size_t
+{
+    // Levels without an operator produce no node of their own in the CST translation either
+    if (operands.size() == 1 && !signed_chain) {
+        return operands.front();
+    }
+
+    const TokenSpan span{
+      .start = signed_chain ? ops.front()->getTokenIndex() : nodes_.at(operands.front()).span.start,
+      .stop = nodes_.at(operands.back()).span.stop,
+    };
+
+    return add(Syntax{
+      .kind = Syntax::Kind::CHAIN,
+      .span = span,
+      .children = std::move(operands),
+      .ops = std::move(ops),
+      .signed_chain = signed_chain,
+    });
+}
+
+} // namespace builder
@@ -0,0 +1,118 @@
+#ifndef BUILDER_EXPRESSION_PARSER_HPP
+#define BUILDER_EXPRESSION_PARSER_HPP
+
+#include "ast/nodes/expressions.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace antlr4 {
+class CommonTokenStream;
+class Token;
+} // namespace antlr4
+
+namespace builder {
+
+/// @brief Precedence-climbing fast path that translates the tokens of an `expression`
+///        straight into an `ast::Expr`.
+///
+/// Skips the CST ladder (expression → relation → shift_expression → simple_expression →
+/// term → factor → primary → name) the Translator would otherwise walk. Nodes are bound to
+/// the same token spans and in the same order as the CST translation, so both paths yield
+/// identical trees and trivia. Anything outside the supported subset (named associations,
+/// qualified expressions, allocators, signatures, comments inside the span, ...) is declined
+/// and left to the CST walk.
+class ExpressionParser final
+{
+  public:
+    ExpressionParser(antlr4::CommonTokenStream& tokens, TriviaBinder& trivia);
+
+    ~ExpressionParser() = default;
+
+    ExpressionParser(const ExpressionParser&) = delete;
+    auto operator=(const ExpressionParser&) -> ExpressionParser& = delete;
+    ExpressionParser(ExpressionParser&&) = delete;
+    auto operator=(ExpressionParser&&) -> ExpressionParser& = delete;
+
+    /// @brief Translates the expression covering the token indices [start, stop].
+    /// @return The expression, or std::nullopt if the span needs the CST translation.
+    [[nodiscard]]
+    auto parse(std::size_t start, std::size_t stop) -> std::optional<ast::Expr>;
+
+  private:
+    /// @brief Shape of one CST context, recorded before any trivia is bound so that
+    ///        declining leaves the binder untouched.
+    struct Syntax
+    {
+        enum class Kind : std::uint8_t
+        {
+            CHAIN,     ///< Left-folded operators of one precedence level, optional sign
+            POWER,     ///< `a ** b`
+            PREFIX,    ///< `abs a`, `not a`
+            TOKEN,     ///< Literal or plain (selected) name
+            PHYSICAL,  ///< `10 ns`
+            NAME,      ///< Name prefix followed by call/slice/attribute parts
+            PAREN,     ///< `(a)`
+            AGGREGATE, ///< `(a, b)`
+            CALL,      ///< `(a, b)` name part
+            SLICE,     ///< `(a downto b)` name part
+            ATTRIBUTE, ///< `'attr` or `'attr(arg)` name part
+        };
+
+        Kind kind{};
+        TokenSpan span{};                    ///< Span of the mirrored CST context
+        TokenSpan prefix{};                  ///< NAME only: the prefix before the first part
+        std::vector<std::size_t> children{}; ///< Indices into `nodes_`
+        std::vector<antlr4::Token*> ops{};   ///< Operators, sign, direction or designator
+        bool signed_chain{false};            ///< CHAIN only: `ops.front()` is a leading sign
+    };
+
+    /// @brief Depth-0 contents of a parenthesized group.
+    struct Group
+    {
+        std::size_t commas;
+        bool has_direction;
+    };
+
+    antlr4::CommonTokenStream& tokens_;
+    TriviaBinder& trivia_;
+
+    std::vector<antlr4::Token*> toks_{}; ///< Default-channel tokens of the current span
+    std::vector<Syntax> nodes_{};
+    std::size_t pos_{0};
+
+    // Phase 1: shape (no side effects)
+    [[nodiscard]] auto parseExpression() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseRelation() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseShift() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseSimple() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseTerm() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseFactor() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parsePrimary() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseParenthesized() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseName() -> std::optional<std::size_t>;
+    [[nodiscard]] auto parseNamePart() -> std::optional<std::size_t>;
+
+    // Phase 2: build the AST, binding trivia in CST order
+    [[nodiscard]] auto emit(std::size_t index) -> ast::Expr;
+    [[nodiscard]] auto emitName(const Syntax& node) -> ast::Expr;
+
+    [[nodiscard]] auto peekType(std::size_t offset = 0) const -> std::size_t;
+    [[nodiscard]] auto scanGroup() const -> std::optional<Group>;
+    [[nodiscard]] auto spanText(TokenSpan span) const -> std::string;
+    [[nodiscard]] auto spanOf(std::size_t first, std::size_t last) const -> TokenSpan;
+    [[nodiscard]] auto spanOfNodes(std::size_t first, std::size_t last) const -> TokenSpan;
+
+    auto add(Syntax node) -> std::size_t;
+    auto chain(std::vector<std::size_t> operands,
+               std::vector<antlr4::Token*> ops,
+               bool signed_chain) -> std::size_t;
+};
+
+} // namespace builder
+
+#endif /* BUILDER_EXPRESSION_PARSER_HPP */
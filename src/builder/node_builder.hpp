@@ -2,6 +2,7 @@
 #define BUILDER_NODE_BUILDER_HPP
 
 #include "builder/trivia/trivia_binder.hpp"
+#include "common/stats.hpp"
 
 #include <memory>
 #include <ranges>
@@ -165,6 +166,7 @@ class NodeBuilder final
     [[nodiscard]]
     auto build() && -> T
     {
+        common::stats::count(common::stats::Counter::AST_NODES);
         return std::move(node_);
     }
 };
@@ -0,0 +1,184 @@
+#include "builder/prediction_cache.hpp"
+
+#include "builder/warm_up.hpp"
+#include "common/logger.hpp"
+
+#include <antlr4-runtime/atn/ATNConfig.h>
+#include <antlr4-runtime/atn/ATNConfigSet.h>
+#include <antlr4-runtime/atn/LexerATNSimulator.h>
+#include <antlr4-runtime/atn/ParserATNSimulator.h>
+#include <antlr4-runtime/atn/PredictionContext.h>
+#include <antlr4-runtime/atn/PredictionContextCache.h>
+#include <antlr4-runtime/atn/SingletonPredictionContext.h>
+#include <antlr4-runtime/dfa/DFA.h>
+#include <antlr4-runtime/dfa/DFAState.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace builder {
+
+namespace {
+
+using ContextSet = std::unordered_set<const antlr4::atn::PredictionContext*>;
+
+// Key, value pointer and the two links of an unordered_map node
+constexpr std::size_t EDGE_BYTES = sizeof(std::size_t) + (3 * sizeof(void*));
+
+// Control block of the context's shared_ptr and its node in the cache's hash set
+constexpr std::size_t CONTEXT_OVERHEAD_BYTES = 5 * sizeof(void*);
+
+// The context itself, plus a parent pointer and return state per alternative
+auto contextBytes(const antlr4::atn::PredictionContext& context) -> std::size_t
+{
+    return sizeof(antlr4::atn::SingletonPredictionContext) + CONTEXT_OVERHEAD_BYTES
+         + (context.size() * (sizeof(void*) + sizeof(std::size_t)));
+}
+
+// Counts the contexts reachable from `context` that have not been seen yet. Caching a DFA
+// state interns each of its configurations' contexts and their parents, so these are what
+// the PredictionContextCache holds.
+auto countContexts(const antlr4::atn::PredictionContext* context,
+                   ContextSet& seen,
+                   PredictionCacheStats& totals) -> void
+{
+    std::vector<const antlr4::atn::PredictionContext*> pending{context};
+    while (!pending.empty()) {
+        const auto* current = pending.back();
+        pending.pop_back();
+        if (current == nullptr || !seen.insert(current).second) {
+            continue;
+        }
+
+        ++totals.contexts;
+        totals.approx_bytes += contextBytes(*current);
+        for (std::size_t i = 0; i < current->size(); ++i) {
+            pending.push_back(current->getParent(i).get());
+        }
+    }
+}
+
+auto countStates(const antlr4::dfa::DFA& dfa, ContextSet& seen, PredictionCacheStats& totals)
+  -> std::size_t
+{
+    for (const auto* state : dfa.states) {
+        const auto configs = state->configs != nullptr ? state->configs->size() : std::size_t{0};
+
+        totals.configs += configs;
+        totals.edges += state->edges.size();
+        totals.approx_bytes += sizeof(antlr4::dfa::DFAState)
+                             + (configs * sizeof(antlr4::atn::ATNConfig))
+                             + (state->edges.size() * EDGE_BYTES);
+
+        if (state->configs != nullptr) {
+            for (const auto& config : state->configs->configs) {
+                countContexts(config->context.get(), seen, totals);
+            }
+        }
+    }
+
+    return dfa.states.size();
+}
+
+// PredictionContextCache has no clear(). With the DFAs cleared and the lease held
+// exclusively nothing can reach it, so it is rebuilt in place, releasing every context.
+auto resetContexts(antlr4::atn::PredictionContextCache& cache) -> void
+{
+    std::destroy_at(&cache);
+    std::construct_at(&cache);
+}
+
+} // namespace
+
+PredictionCache::PredictionCache()
+  : input_{std::string_view{}},
+    lexer_{&input_},
+    tokens_{&lexer_},
+    parser_{&tokens_}
+{
+}
+
+auto PredictionCache::stats() -> PredictionCacheStats
+{
+    const std::unique_lock lock{mutex_};
+    return collect();
+}
+
+auto PredictionCache::clear() -> void
+{
+    const std::unique_lock lock{mutex_};
+    clearLocked();
+}
+
+auto PredictionCache::enforceCeiling() -> bool
+{
+    const auto limit = ceiling_.load();
+    if (limit == 0) {
+        return false;
+    }
+
+    if (calls_.fetch_add(1) % CHECK_INTERVAL != 0) {
+        return false;
+    }
+
+    {
+        // Never wait for parses on other threads just to measure; a later call will
+        const std::unique_lock lock{mutex_, std::try_to_lock};
+        if (!lock.owns_lock()) {
+            calls_.store(0);
+            return false;
+        }
+
+        const auto bytes = collect().approx_bytes;
+        if (bytes <= limit) {
+            return false;
+        }
+
+        common::Logger::instance().debug(
+          "Prediction caches at ~{} bytes exceed the {} byte ceiling, clearing.", bytes, limit);
+        clearLocked();
+    }
+
+    // Parses during the warm-up may enforce again, but must not recurse into another one
+    if (rewarm_.load() && !rewarming_.exchange(true)) {
+        warmUp();
+        rewarming_.store(false);
+    }
+
+    return true;
+}
+
+auto PredictionCache::collect() -> PredictionCacheStats
+{
+    PredictionCacheStats result{};
+    ContextSet seen{};
+
+    auto* parser = parser_.getInterpreter<antlr4::atn::ParserATNSimulator>();
+    for (const auto& dfa : parser->decisionToDFA) {
+        result.parser_states += countStates(dfa, seen, result);
+    }
+
+    auto* lexer = lexer_.getInterpreter<antlr4::atn::LexerATNSimulator>();
+    for (std::size_t mode = 0; mode < lexer_.getModeNames().size(); ++mode) {
+        result.lexer_states += countStates(lexer->getDFA(mode), seen, result);
+    }
+
+    return result;
+}
+
+auto PredictionCache::clearLocked() -> void
+{
+    auto* lexer = lexer_.getInterpreter<antlr4::atn::LexerATNSimulator>();
+    auto* parser = parser_.getInterpreter<antlr4::atn::ParserATNSimulator>();
+
+    lexer->clearDFA();
+    parser->clearDFA();
+
+    resetContexts(lexer->getSharedContextCache());
+    resetContexts(parser->getSharedContextCache());
+}
+
+} // namespace builder
@@ -0,0 +1,114 @@
+#ifndef BUILDER_PREDICTION_CACHE_HPP
+#define BUILDER_PREDICTION_CACHE_HPP
+
+#include "CommonTokenStream.h"
+#include "antlr4-runtime/ANTLRInputStream.h"
+#include "vhdlLexer.h"
+#include "vhdlParser.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+
+namespace builder {
+
+/// @brief Snapshot of the DFA and prediction context caches shared by every lexer and parser
+///        instance.
+struct PredictionCacheStats
+{
+    std::size_t parser_states{0}; ///< DFA states over all parser decisions
+    std::size_t lexer_states{0};  ///< DFA states over all lexer modes
+    std::size_t configs{0};       ///< ATN configurations held by those states
+    std::size_t edges{0};         ///< Cached DFA transitions
+    std::size_t contexts{0};      ///< Prediction contexts those configurations refer to
+    std::size_t approx_bytes{0};  ///< Lower-bound estimate
+};
+
+/// @brief Observes and bounds the process-wide ANTLR prediction caches.
+///
+/// The generated lexer and parser keep their DFAs and PredictionContextCache in static
+/// storage that only ever grows. Lexing and parsing hold a shared lease; clearing takes the
+/// lease exclusively, so it waits for in-flight parses on other threads instead of pulling
+/// states out from under them.
+class PredictionCache final
+{
+  public:
+    static auto instance() -> PredictionCache&
+    {
+        static PredictionCache instance;
+        return instance;
+    }
+
+    PredictionCache(const PredictionCache&) = delete;
+    auto operator=(const PredictionCache&) -> PredictionCache& = delete;
+    PredictionCache(PredictionCache&&) = delete;
+    auto operator=(PredictionCache&&) -> PredictionCache& = delete;
+    ~PredictionCache() = default;
+
+    /// @brief Held for the duration of anything that reads or extends the DFAs.
+    [[nodiscard]]
+    auto lease() -> std::shared_lock<std::shared_mutex>
+    {
+        return std::shared_lock{mutex_};
+    }
+
+    /// @brief Counts the cached states; waits for in-flight parses to finish.
+    [[nodiscard]]
+    auto stats() -> PredictionCacheStats;
+
+    /// @brief Drops every cached DFA state and prediction context.
+    auto clear() -> void;
+
+    /// @brief Sets the memory ceiling in bytes; 0 disables the governor.
+    /// @note The ceiling starts out at DEFAULT_CEILING.
+    /// @param rewarm Re-prime the caches from the warm-up corpus after a clear.
+    /// @note The next enforceCeiling() checks the new ceiling.
+    auto setCeiling(std::size_t bytes, bool rewarm = true) -> void
+    {
+        ceiling_.store(bytes);
+        rewarm_.store(rewarm);
+        calls_.store(0);
+    }
+
+    [[nodiscard]]
+    auto ceiling() const -> std::size_t
+    {
+        return ceiling_.load();
+    }
+
+    /// @brief Clears the caches if they exceed the ceiling.
+    /// @note Measuring walks every cached state, so only one call in CHECK_INTERVAL measures,
+    ///       and only when no parse is in flight; the others return at once.
+    /// @return Whether the caches were cleared.
+    auto enforceCeiling() -> bool;
+
+    /// @brief Calls to enforceCeiling() per measurement.
+    static constexpr std::size_t CHECK_INTERVAL{64};
+
+    /// @brief Ceiling until setCeiling() is called; bounds the caches over a long session.
+    static constexpr std::size_t DEFAULT_CEILING{256UZ * 1024 * 1024};
+
+  private:
+    PredictionCache();
+
+    // Caller holds `mutex_`
+    auto collect() -> PredictionCacheStats;
+    auto clearLocked() -> void;
+
+    std::shared_mutex mutex_;
+    std::atomic<std::size_t> ceiling_{DEFAULT_CEILING};
+    std::atomic<bool> rewarm_{true};
+    std::atomic<bool> rewarming_{false};
+    std::atomic<std::size_t> calls_{0};
+
+    // Probe recognizers: the DFAs are only reachable through an interpreter instance
+    antlr4::ANTLRInputStream input_;
+    vhdlLexer lexer_;
+    antlr4::CommonTokenStream tokens_;
+    vhdlParser parser_;
+};
+
+} // namespace builder
+
+#endif /* BUILDER_PREDICTION_CACHE_HPP */
@@ -0,0 +1,366 @@
+#include "builder/token_store.hpp"
+
+#include "builder/prediction_cache.hpp"
+#include "builder/trivia/utils.hpp"
+#include "vhdlLexer.h"
+
+#include <algorithm>
+#include <antlr4-runtime/ANTLRInputStream.h>
+#include <antlr4-runtime/CharStream.h>
+#include <antlr4-runtime/CommonToken.h>
+#include <antlr4-runtime/CommonTokenFactory.h>
+#include <antlr4-runtime/IntStream.h>
+#include <antlr4-runtime/Token.h>
+#include <antlr4-runtime/TokenSource.h>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace builder {
+
+namespace {
+
+using TokenPtr = std::unique_ptr<antlr4::CommonToken>;
+using SourcePair = std::pair<antlr4::TokenSource*, antlr4::CharStream*>;
+
+auto countCodePoints(std::string_view text) -> std::size_t
+{
+    constexpr unsigned char CONTINUATION_MASK = 0xC0U;
+    constexpr unsigned char CONTINUATION_BITS = 0x80U;
+
+    return static_cast<std::size_t>(std::ranges::count_if(text, [](char c) {
+        return (static_cast<unsigned char>(c) & CONTINUATION_MASK) != CONTINUATION_BITS;
+    }));
+}
+
+auto countLines(std::string_view text) -> std::size_t
+{
+    return static_cast<std::size_t>(std::ranges::count(text, '\n'));
+}
+
+// Copies the token with its text, so it no longer refers to the lexer input it came from
+auto detach(const antlr4::Token& token, SourcePair source) -> TokenPtr
+{
+    auto copy = std::make_unique<antlr4::CommonToken>(source,
+                                                      token.getType(),
+                                                      token.getChannel(),
+                                                      token.getStartIndex(),
+                                                      token.getStopIndex());
+    copy->setText(token.getText());
+    copy->setLine(token.getLine());
+    copy->setCharPositionInLine(token.getCharPositionInLine());
+    copy->setTokenIndex(token.getTokenIndex());
+    return copy;
+}
+
+// Bytes covered by the token's text; EOF covers none
+auto byteLength(const antlr4::Token& token) -> std::size_t
+{
+    return token.getType() == antlr4::Token::EOF ? 0 : token.getText().size();
+}
+
+/// @brief Lexes the text from a line start, handing every token, already placed in the whole
+///        buffer, and its byte offset to `accept` until it returns false or EOF is reached.
+/// @return Number of tokens lexed.
+template<typename Accept>
+auto lexFrom(std::string_view text,
+             std::size_t byte,
+             std::size_t code_point,
+             std::size_t line,
+             Accept&& accept) -> std::size_t
+{
+    antlr4::ANTLRInputStream input{text.substr(byte)};
+    vhdlLexer lexer{&input};
+    lexer.removeErrorListeners();
+
+    // Lexing extends the shared lexer DFA
+    const auto lease = PredictionCache::instance().lease();
+
+    std::size_t local_point{0};
+    std::size_t count{0};
+
+    while (true) {
+        const auto token = lexer.nextToken();
+        ++count;
+
+        // The lexer only skips spaces, tabs and carriage returns, which are one byte each
+        const auto start = token->getStartIndex();
+        if (start > local_point) {
+            byte += start - local_point;
+            local_point = start;
+        }
+
+        auto placed = detach(*token, SourcePair{nullptr, nullptr});
+        placed->setStartIndex(start + code_point);
+        placed->setStopIndex(token->getStopIndex() + code_point);
+        placed->setLine(token->getLine() + line - 1);
+
+        const auto token_byte = byte;
+        const auto is_eof = token->getType() == antlr4::Token::EOF;
+        if (!is_eof) {
+            byte += byteLength(*token);
+            local_point = token->getStopIndex() + 1;
+        }
+
+        if (!accept(std::move(placed), token_byte) || is_eof) {
+            return count;
+        }
+    }
+}
+
+/// @brief Hands out copies of a slice of the store, moved to start at code point 0.
+class ReplaySource final : public antlr4::TokenSource
+{
+  public:
+    ReplaySource(std::span<const TokenPtr> tokens,
+                 std::size_t base_point,
+                 const antlr4::Token& eof_at,
+                 std::size_t eof_point)
+    {
+        tokens_.reserve(tokens.size() + 1);
+
+        for (const auto& token : tokens) {
+            auto copy = detach(*token, SourcePair{this, nullptr});
+            copy->setStartIndex(token->getStartIndex() - base_point);
+            copy->setStopIndex(token->getStopIndex() - base_point);
+            copy->setTokenIndex(antlr4::INVALID_INDEX);
+            tokens_.push_back(std::move(copy));
+        }
+
+        eof_ = std::make_unique<antlr4::CommonToken>(SourcePair{this, nullptr},
+                                                     antlr4::Token::EOF,
+                                                     antlr4::Token::DEFAULT_CHANNEL,
+                                                     eof_point - base_point,
+                                                     eof_point - base_point - 1);
+        eof_->setText("<EOF>");
+        eof_->setLine(eof_at.getLine());
+        eof_->setCharPositionInLine(eof_at.getCharPositionInLine());
+    }
+
+    auto nextToken() -> std::unique_ptr<antlr4::Token> override
+    {
+        if (next_ < tokens_.size()) {
+            return std::move(tokens_.at(next_++));
+        }
+        return detach(*eof_, SourcePair{this, nullptr});
+    }
+
+    auto getLine() const -> std::size_t override
+    {
+        return peek().getLine();
+    }
+
+    auto getCharPositionInLine() -> std::size_t override
+    {
+        return peek().getCharPositionInLine();
+    }
+
+    auto getInputStream() -> antlr4::CharStream* override
+    {
+        return nullptr;
+    }
+
+    auto getSourceName() -> std::string override
+    {
+        return antlr4::IntStream::UNKNOWN_SOURCE_NAME;
+    }
+
+    auto getTokenFactory() -> antlr4::TokenFactory<antlr4::CommonToken>* override
+    {
+        return antlr4::CommonTokenFactory::DEFAULT.get();
+    }
+
+  private:
+    std::vector<TokenPtr> tokens_{};
+    TokenPtr eof_{};
+    std::size_t next_{0};
+
+    [[nodiscard]]
+    auto peek() const -> const antlr4::Token&
+    {
+        return next_ < tokens_.size() ? *tokens_.at(next_) : *eof_;
+    }
+};
+
+} // namespace
+
+TokenStore::TokenStore(std::string text) :
+  text_{std::move(text)}
+{
+    lexFrom(text_, 0, 0, 1, [this](TokenPtr token, std::size_t byte) -> bool {
+        token->setTokenIndex(tokens_.size());
+        tokens_.push_back(std::move(token));
+        bytes_.push_back(byte);
+        return true;
+    });
+}
+
+auto TokenStore::tokens() const -> std::vector<antlr4::Token*>
+{
+    std::vector<antlr4::Token*> result{};
+    result.reserve(tokens_.size());
+    for (const auto& token : tokens_) {
+        result.push_back(token.get());
+    }
+    return result;
+}
+
+auto TokenStore::restartIndex(std::size_t begin) const -> std::size_t
+{
+    auto index = static_cast<std::size_t>(
+      std::ranges::distance(bytes_.begin(), std::ranges::lower_bound(bytes_, begin)));
+
+    for (; index > 0; --index) {
+        // An apostrophe right before the line break looked ahead into the next line
+        if (isNewline(tokens_.at(index - 1).get())
+            && (index < 2 || tokens_.at(index - 2)->getType() != vhdlLexer::APOSTROPHE))
+        {
+            return index;
+        }
+    }
+
+    return 0;
+}
+
+auto TokenStore::originOf(std::size_t index) const -> Origin
+{
+    if (index == 0) {
+        return Origin{.byte = 0, .code_point = 0, .line = 1};
+    }
+
+    const auto& newline = *tokens_.at(index - 1);
+    return Origin{.byte = bytes_.at(index - 1) + 1,
+                  .code_point = newline.getStopIndex() + 1,
+                  .line = newline.getLine() + 1};
+}
+
+auto TokenStore::applyEdit(std::size_t begin, std::size_t end, std::string_view text) -> Relexed
+{
+    const auto removed = std::string_view{text_}.substr(begin, end - begin);
+    const auto removed_points = countCodePoints(removed);
+    const auto removed_lines = countLines(removed);
+    const auto inserted_points = countCodePoints(text);
+    const auto inserted_lines = countLines(text);
+
+    const auto restart = restartIndex(begin);
+    const auto origin = originOf(restart);
+
+    // Old tokens from here on start behind the replaced bytes
+    const auto first_after = std::ranges::lower_bound(bytes_, end);
+
+    text_.replace(begin, end - begin, text);
+    const auto inserted_end = begin + text.size();
+
+    std::vector<TokenPtr> lexed{};
+    std::vector<std::size_t> lexed_bytes{};
+    auto resync = tokens_.size();
+
+    const auto count = lexFrom(
+      text_, origin.byte, origin.code_point, origin.line, [&](TokenPtr token, std::size_t byte) {
+          // The rest of the text is unchanged, so a token starting where an old one started
+          // behind the edit is followed by exactly the old tokens
+          if (byte >= inserted_end) {
+              const auto old_byte = byte - text.size() + (end - begin);
+              const auto it = std::lower_bound(first_after, bytes_.end(), old_byte);
+              if (it != bytes_.end() && *it == old_byte) {
+                  resync = static_cast<std::size_t>(std::distance(bytes_.begin(), it));
+                  return false;
+              }
+          }
+
+          lexed.push_back(std::move(token));
+          lexed_bytes.push_back(byte);
+          return true;
+      });
+
+    // Tokens before the edit that came out exactly as before do not count as changed
+    std::size_t same{0};
+    while (same < lexed.size() && lexed_bytes.at(same) < begin
+           && bytes_.at(restart + same) == lexed_bytes.at(same)
+           && tokens_.at(restart + same)->getType() == lexed.at(same)->getType()
+           && tokens_.at(restart + same)->getText() == lexed.at(same)->getText())
+    {
+        ++same;
+    }
+
+    Relexed relexed{.begin = begin, .end = inserted_end, .tokens = count};
+    if (same < lexed.size()) {
+        relexed.begin = std::min(begin, lexed_bytes.at(same));
+        relexed.end = std::max(inserted_end, lexed_bytes.back() + byteLength(*lexed.back()));
+    }
+
+    std::vector<TokenPtr> tokens{};
+    std::vector<std::size_t> bytes{};
+    tokens.reserve(restart + lexed.size() + tokens_.size() - resync);
+    bytes.reserve(tokens.capacity());
+
+    for (std::size_t i = 0; i < restart; ++i) {
+        tokens.push_back(std::move(tokens_.at(i)));
+        bytes.push_back(bytes_.at(i));
+    }
+
+    for (std::size_t i = 0; i < lexed.size(); ++i) {
+        tokens.push_back(std::move(lexed.at(i)));
+        bytes.push_back(lexed_bytes.at(i));
+    }
+
+    // Unsigned offsets wrap in between but land on the right value
+    for (auto i = resync; i < tokens_.size(); ++i) {
+        auto& token = tokens_.at(i);
+        token->setStartIndex(token->getStartIndex() + inserted_points - removed_points);
+        token->setStopIndex(token->getStopIndex() + inserted_points - removed_points);
+        token->setLine(token->getLine() + inserted_lines - removed_lines);
+
+        tokens.push_back(std::move(token));
+        bytes.push_back(bytes_.at(i) + text.size() - (end - begin));
+    }
+
+    for (auto i = restart; i < tokens.size(); ++i) {
+        tokens.at(i)->setTokenIndex(i);
+    }
+
+    tokens_ = std::move(tokens);
+    bytes_ = std::move(bytes);
+
+    return relexed;
+}
+
+auto TokenStore::replay(std::size_t begin, std::size_t end) const
+  -> std::unique_ptr<antlr4::TokenSource>
+{
+    const auto index_of = [this](std::size_t byte) -> std::size_t {
+        return static_cast<std::size_t>(
+          std::ranges::distance(bytes_.begin(), std::ranges::lower_bound(bytes_, byte)));
+    };
+
+    const auto first = index_of(begin);
+    const auto last = index_of(end);
+
+    const auto straddles = [this](std::size_t index, std::size_t byte) -> bool {
+        return bytes_.at(index) + byteLength(*tokens_.at(index)) > byte;
+    };
+
+    if ((first > 0 && straddles(first - 1, begin)) || (last > first && straddles(last - 1, end)))
+    {
+        throw std::runtime_error(
+          std::format("Bytes {} to {} do not start and end between tokens", begin, end));
+    }
+
+    // Only skipped whitespace, one byte per code point, lies between a bound and its token
+    const auto& first_token = *tokens_.at(first);
+    const auto& last_token = *tokens_.at(last);
+    const auto base_point = first_token.getStartIndex() - (bytes_.at(first) - begin);
+    const auto eof_point = last_token.getStartIndex() - (bytes_.at(last) - end);
+
+    return std::make_unique<ReplaySource>(
+      std::span{tokens_}.subspan(first, last - first), base_point, last_token, eof_point);
+}
+
+} // namespace builder
@@ -0,0 +1,85 @@
+#ifndef BUILDER_TOKEN_STORE_HPP
+#define BUILDER_TOKEN_STORE_HPP
+
+#include "CommonToken.h"
+#include "TokenSource.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace builder {
+
+/// @brief The token stream of an editor buffer, kept up to date by relexing only the lines
+///        an edit touches.
+///
+/// Every VHDL-93 token ends before the line break that follows it, the lone exception being
+/// an apostrophe that could open a character literal on the next line. An edit is therefore
+/// relexed from the start of its first line until the new tokens line up with the old ones
+/// again; the tokens behind that point are kept and only have their offsets shifted.
+class TokenStore final
+{
+  public:
+    /// @brief The part of the buffer whose tokens changed, in bytes of the edited text.
+    struct Relexed
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t tokens; ///< Number of tokens run through the lexer
+    };
+
+    explicit TokenStore(std::string text);
+
+    [[nodiscard]]
+    auto text() const noexcept -> const std::string&
+    {
+        return text_;
+    }
+
+    /// @brief Number of tokens, including EOF.
+    [[nodiscard]]
+    auto size() const noexcept -> std::size_t
+    {
+        return tokens_.size();
+    }
+
+    /// @brief Every token, in the shape CommonTokenStream::getTokens() returns them.
+    [[nodiscard]]
+    auto tokens() const -> std::vector<antlr4::Token*>;
+
+    /// @brief Replaces the bytes [begin, end) and relexes the lines around them.
+    /// @return The changed region, which covers at least the inserted text.
+    auto applyEdit(std::size_t begin, std::size_t end, std::string_view text) -> Relexed;
+
+    /// @brief A token source that replays the tokens within the bytes [begin, end) followed
+    ///        by EOF, as if the lexer had been run on that part of the buffer alone.
+    /// @throws std::runtime_error if a token straddles either end of the range.
+    [[nodiscard]]
+    auto replay(std::size_t begin, std::size_t end) const -> std::unique_ptr<antlr4::TokenSource>;
+
+  private:
+    /// @brief Where lexing resumes: a line start in bytes, code points and lines.
+    struct Origin
+    {
+        std::size_t byte;
+        std::size_t code_point;
+        std::size_t line;
+    };
+
+    std::string text_;
+    std::vector<std::unique_ptr<antlr4::CommonToken>> tokens_{};
+    std::vector<std::size_t> bytes_{}; ///< Byte offset of every token's first character
+
+    // First token whose lexing cannot have looked at the byte `begin`
+    [[nodiscard]]
+    auto restartIndex(std::size_t begin) const -> std::size_t;
+
+    [[nodiscard]]
+    auto originOf(std::size_t index) const -> Origin;
+};
+
+} // namespace builder
+
+#endif /* BUILDER_TOKEN_STORE_HPP */
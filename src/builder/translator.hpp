@@ -12,6 +12,7 @@
 #include "ast/nodes/statements/sequential.hpp"
 #include "ast/nodes/statements/waveform.hpp"
 #include "ast/nodes/types.hpp"
+#include "builder/expression_parser.hpp"
 #include "builder/node_builder.hpp"
 #include "builder/trivia/trivia_binder.hpp"
 #include "vhdlParser.h"
@@ -27,13 +28,28 @@ namespace builder {
 class Translator final
 {
     TriviaBinder trivia_;
+    ExpressionParser expressions_;
+    bool fast_expressions_;
 
   public:
-    explicit Translator(antlr4::CommonTokenStream& tokens) : trivia_(tokens) {}
+    /// @param fast_expressions Translate expressions from their tokens where possible instead
+    ///                         of walking the CST ladder (see ExpressionParser).
+    explicit Translator(antlr4::CommonTokenStream& tokens, bool fast_expressions = true) :
+      trivia_(tokens),
+      expressions_(tokens, trivia_),
+      fast_expressions_(fast_expressions)
+    {
+    }
 
     /// @brief Build the entire design file by walking the CST
     auto buildDesignFile(vhdlParser::Design_fileContext* ctx) -> ast::DesignFile;
 
+    /// @brief Build a single design unit, for callers that parse one unit at a time
+    auto buildDesignUnit(vhdlParser::Design_unitContext* ctx) -> ast::DesignUnit
+    {
+        return makeDesignUnit(ctx);
+    }
+
     ~Translator() = default;
 
     Translator(const Translator&) = delete;
@@ -34,6 +34,9 @@ auto Translator::makeDesignUnit(vhdlParser::Design_unitContext* ctx) -> ast::Des
         [](auto& cc) { return cc.context_item(); },
         [this](auto* item) { return makeContextItem(item); })
       .set(&ast::DesignUnit::unit, makeLibraryUnit(*lib_unit_ctx))
+      .set(&ast::DesignUnit::hash,
+           trivia_.hashSpan(TokenSpan{.start = ctx->getStart()->getTokenIndex(),
+                                      .stop = ctx->getStop()->getTokenIndex()}))
       .build();
 }
 
@@ -52,14 +52,7 @@ auto Translator::makeChoice(vhdlParser::ChoiceContext& ctx) -> ast::Expr
         return makeToken(ctx, "others");
     }
 
-    if (ctx.identifier() != nullptr) {
-        return makeToken(ctx, ctx.identifier()->getText());
-    }
-
-    if (ctx.simple_expression() != nullptr) {
-        return makeSimpleExpr(*ctx.simple_expression());
-    }
-
+    // Identifiers and single values arrive as a direction-less `explicit_range`
     if (auto* dr = ctx.discrete_range()) {
         return makeDiscreteRange(*dr);
     }
@@ -9,6 +9,13 @@ namespace builder {
 
 auto Translator::makeExpr(vhdlParser::ExpressionContext& ctx) -> ast::Expr
 {
+    if (fast_expressions_) {
+        if (auto expr = expressions_.parse(ctx.getStart()->getTokenIndex(),
+                                           ctx.getStop()->getTokenIndex())) {
+            return std::move(*expr);
+        }
+    }
+
     const auto& relations = ctx.relation();
     if (relations.size() == 1) {
         return makeRelation(*relations.at(0));
@@ -35,36 +35,18 @@ auto Translator::makeCallArgument(vhdlParser::Association_elementContext& ctx) -
         return makeToken(ctx);
     }
 
-    // Resolve the inner content of the actual part
-    ast::Expr content = [&]() -> ast::Expr {
-        auto* designator = actual->actual_designator();
-
-        // If designator is missing, fallback immediately
-        if (designator == nullptr) {
-            return makeToken(*actual);
-        }
-
-        // Check for expression
-        if (auto* expr = designator->expression()) {
-            return makeExpr(*expr);
-        }
-
-        // Fallback: It must be the 'OPEN' keyword
-        return makeToken(*designator);
-    }();
-
-    // 2. Check for function call / type conversion syntax: name(actual_designator)
-    if (auto* name_ctx = actual->name()) {
-        ast::GroupExpr args{};
-        args.children.emplace_back(std::move(content));
+    // Conversion functions (`to_integer(x)`) are regular names with a call part
+    auto* designator = actual->actual_designator();
+    if (designator == nullptr) {
+        return makeToken(*actual);
+    }
 
-        return build<ast::CallExpr>(*actual)
-          .setBox(&ast::CallExpr::callee, makeName(*name_ctx))
-          .setBox(&ast::CallExpr::args, std::move(args))
-          .build();
+    if (auto* expr = designator->expression()) {
+        return makeExpr(*expr);
     }
 
-    return content;
+    // Fallback: It must be the 'OPEN' keyword
+    return makeToken(*designator);
 }
 
 } // namespace builder
@@ -1,8 +1,10 @@
 #include "ast/nodes/expressions.hpp"
 #include "builder/translator.hpp"
+#include "builder/trivia/trivia_binder.hpp"
 #include "vhdlParser.h"
 
 #include <algorithm>
+#include <iterator>
 #include <ranges>
 #include <string>
 #include <utility>
@@ -31,7 +33,20 @@ auto Translator::makeName(vhdlParser::NameContext& ctx) -> ast::Expr
         text += part->getText();
     }
 
-    ast::Expr base = makeToken(ctx, std::move(text));
+    // Without further parts the base spans the whole name. Otherwise it must end at the last
+    // selected part, so trivia after the name binds to the outermost call/slice/attribute.
+    if (split_it == parts.end()) {
+        return makeToken(ctx, std::move(text));
+    }
+
+    TokenSpan prefix{
+      .start = ctx.getStart()->getTokenIndex(),
+      .stop = (split_it == parts.begin())
+              ? ctx.getStart()->getTokenIndex()
+              : (*std::ranges::prev(split_it))->getStop()->getTokenIndex(),
+    };
+
+    ast::Expr base = makeToken(prefix, std::move(text));
 
     // 3. Fold Structure
     for (auto* part : std::ranges::subrange(split_it, parts.end())) {
@@ -6,14 +6,16 @@ namespace builder {
 
 auto Translator::makePrimary(vhdlParser::PrimaryContext& ctx) -> ast::Expr
 {
-    if (ctx.expression() != nullptr) {
-        return build<ast::ParenExpr>(ctx)
-          .setBox(&ast::ParenExpr::inner, makeExpr(*ctx.expression()))
-          .build();
-    }
-
-    if (ctx.aggregate() != nullptr) {
-        return makeAggregate(*ctx.aggregate());
+    if (auto* agg = ctx.aggregate()) {
+        // A single positional association is a parenthesized expression: `(a + b)`
+        const auto elements = agg->element_association();
+        if (elements.size() == 1 && elements.front()->choices() == nullptr) {
+            return build<ast::ParenExpr>(ctx)
+              .setBox(&ast::ParenExpr::inner, makeExpr(*elements.front()->expression()))
+              .build();
+        }
+
+        return makeAggregate(*agg);
     }
 
     if (auto* name_ctx = ctx.name()) {
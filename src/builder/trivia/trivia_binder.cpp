@@ -1,22 +1,106 @@
 #include "builder/trivia/trivia_binder.hpp"
 
+#include "CharStream.h"
 #include "CommonTokenStream.h"
 #include "ParserRuleContext.h"
 #include "Token.h"
+#include "TokenSource.h"
 #include "ast/node.hpp"
 #include "builder/trivia/utils.hpp"
+#include "common/hash.hpp"
+#include "common/stats.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <ranges>
 #include <span>
+#include <sys/types.h>
 #include <utility>
 #include <vector>
 
 namespace builder {
 
-TriviaBinder::TriviaBinder(antlr4::CommonTokenStream& ts) : tokens_(ts), used_(ts.size(), false) {}
+namespace {
+
+// UTF-8 length of the code points [start, stop], read in place rather than copied out as text
+auto utf8Length(antlr4::CharStream& stream, std::size_t start, std::size_t stop) -> std::size_t
+{
+    constexpr std::size_t ONE_BYTE_END = 0x80;
+    constexpr std::size_t TWO_BYTES_END = 0x800;
+    constexpr std::size_t THREE_BYTES_END = 0x10000;
+
+    stream.seek(start);
+
+    std::size_t length{0};
+    for (std::size_t offset = 1; offset <= stop + 1 - start; ++offset) {
+        const auto c = stream.LA(static_cast<ssize_t>(offset));
+        if (c < ONE_BYTE_END) {
+            length += 1;
+        } else if (c < TWO_BYTES_END) {
+            length += 2;
+        } else if (c < THREE_BYTES_END) {
+            length += 3;
+        } else {
+            length += 4;
+        }
+    }
+
+    return length;
+}
+
+} // namespace
+
+TriviaBinder::TriviaBinder(antlr4::CommonTokenStream& ts) :
+  tokens_(ts),
+  used_(ts.size(), false),
+  bytes_(computeBytes(ts))
+{}
+
+auto TriviaBinder::computeBytes(antlr4::CommonTokenStream& ts) -> std::vector<TokenBytes>
+{
+    // Timed once per translation: a timer in bind() would read the clock twice per node
+    const common::stats::Timer timer{common::stats::Phase::TRIVIA_BIND};
+
+    std::vector<TokenBytes> result{};
+    result.reserve(ts.size());
+
+    // Replayed tokens (see TokenStore) have no input, only text of their own
+    auto* stream = ts.getTokenSource()->getInputStream();
+    const auto position = stream != nullptr ? stream->index() : 0;
+
+    std::size_t byte{0};
+    std::size_t code_point{0};
+
+    for (const auto* token : ts.getTokens()) {
+        // The lexer only skips spaces, tabs and carriage returns, which are one byte each
+        const auto start = token->getStartIndex();
+        if (start > code_point) {
+            byte += start - code_point;
+            code_point = start;
+        }
+
+        if (token->getType() == antlr4::Token::EOF) {
+            result.push_back(TokenBytes{.begin = byte, .end = byte});
+            continue;
+        }
+
+        const auto length = stream != nullptr ? utf8Length(*stream, start, token->getStopIndex())
+                                              : token->getText().size();
+        result.push_back(TokenBytes{.begin = byte, .end = byte + length});
+
+        byte += length;
+        code_point = token->getStopIndex() + 1;
+    }
+
+    if (stream != nullptr) {
+        stream->seek(position);
+    }
+
+    return result;
+}
 
 auto TriviaBinder::extractTrivia(std::span<antlr4::Token* const> range) -> std::vector<ast::Trivia>
 {
@@ -51,10 +135,8 @@ auto TriviaBinder::extractTrivia(std::span<antlr4::Token* const> range) -> std::
     return result;
 }
 
-auto TriviaBinder::findContextEnd(const antlr4::ParserRuleContext& ctx) const -> std::size_t
+auto TriviaBinder::findContextEnd(std::size_t stop) const -> std::size_t
 {
-    const auto stop = ctx.getStop()->getTokenIndex();
-
     const auto next = stop + 1;
     if (next >= tokens_.size()) {
         return stop;
@@ -70,8 +152,21 @@ auto TriviaBinder::findContextEnd(const antlr4::ParserRuleContext& ctx) const ->
 
 void TriviaBinder::bind(ast::NodeBase& node, const antlr4::ParserRuleContext& ctx)
 {
-    const auto start_idx = ctx.getStart()->getTokenIndex();
-    const auto stop_idx = findContextEnd(ctx);
+    bind(node, TokenSpan{.start = ctx.getStart()->getTokenIndex(),
+                         .stop = ctx.getStop()->getTokenIndex()});
+}
+
+void TriviaBinder::bind(ast::NodeBase& node, TokenSpan span)
+{
+    const auto start_idx = span.start;
+    const auto stop_idx = findContextEnd(span.stop);
+
+    // Empty rules stop before they start
+    const auto begin = bytes_.at(span.start).begin;
+    node.span = ast::SourceSpan{.first_token = span.start,
+                                .last_token = span.stop,
+                                .begin = begin,
+                                .end = std::max(begin, bytes_.at(span.stop).end)};
 
     // Extract Inline (Immediate Right of stop)
     std::optional<ast::Comment> inline_comment{};
@@ -95,6 +190,33 @@ void TriviaBinder::bind(ast::NodeBase& node, const antlr4::ParserRuleContext& ct
     }
 }
 
+auto TriviaBinder::hashSpan(TokenSpan span) const -> std::uint64_t
+{
+    const auto is_hidden = [this](std::size_t index) -> bool {
+        return tokens_.get(index)->getChannel() != antlr4::Token::DEFAULT_CHANNEL;
+    };
+
+    auto first = span.start;
+    while (first > 0 && is_hidden(first - 1)) {
+        --first;
+    }
+
+    auto last = span.stop + 1;
+    while (last < tokens_.size() && is_hidden(last)) {
+        ++last;
+    }
+
+    // A unit with nothing before it also owns the leading run instead of its predecessor
+    common::Fnv1a hash{};
+    hash.add(first == 0);
+    for (auto index = first; index < last; ++index) {
+        const auto* token = tokens_.get(index);
+        hash.add(token->getType()).add(token->getText());
+    }
+
+    return hash.value();
+}
+
 auto TriviaBinder::isUsed(const antlr4::Token* token) const -> bool
 {
     return used_.at(token->getTokenIndex());
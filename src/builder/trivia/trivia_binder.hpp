@@ -4,6 +4,7 @@
 #include "ast/node.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <span>
 #include <vector>
 
@@ -15,6 +16,13 @@ class Token;
 
 namespace builder {
 
+/// @brief Inclusive range of token indices, for nodes that cover only part of a context.
+struct TokenSpan
+{
+    std::size_t start;
+    std::size_t stop;
+};
+
 class TriviaBinder final
 {
   public:
@@ -30,17 +38,39 @@ class TriviaBinder final
     /// @brief Binds collected trivia to the specified AST node.
     auto bind(ast::NodeBase& node, const antlr4::ParserRuleContext& ctx) -> void;
 
+    /// @brief Binds collected trivia to the specified AST node using an explicit token span.
+    /// @note Also records the span, and the bytes it covers, as the node's source span.
+    auto bind(ast::NodeBase& node, TokenSpan span) -> void;
+
+    /// @brief Hashes the tokens of the span together with the hidden tokens (comments and
+    ///        newlines) on either side of it, i.e. everything its trivia can be bound from.
+    /// @note Whitespace never reaches the token stream, so re-indenting does not change it.
+    [[nodiscard]]
+    auto hashSpan(TokenSpan span) const -> std::uint64_t;
+
   private:
+    /// @brief Byte range of one token's text.
+    struct TokenBytes
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
     antlr4::CommonTokenStream& tokens_;
     std::vector<bool> used_;
+    std::vector<TokenBytes> bytes_;
+
+    // Maps every token to its byte range; ANTLR only knows code point offsets
+    [[nodiscard]]
+    static auto computeBytes(antlr4::CommonTokenStream& ts) -> std::vector<TokenBytes>;
 
     // Returns a vector of trivia from a specific range of tokens
     [[nodiscard]]
     auto extractTrivia(std::span<antlr4::Token* const> range) -> std::vector<ast::Trivia>;
 
-    // Finds the index of the last meaningful token in the context
+    // Finds the index of the last meaningful token, absorbing a trailing separator
     [[nodiscard]]
-    auto findContextEnd(const antlr4::ParserRuleContext& ctx) const -> std::size_t;
+    auto findContextEnd(std::size_t stop) const -> std::size_t;
 
     // Checks if a token is already taken
     [[nodiscard]]
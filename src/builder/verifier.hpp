@@ -6,11 +6,14 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <format>
 #include <ranges>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace builder::verify {
 
@@ -50,17 +53,79 @@ struct VerificationError
     } kind;
 };
 
-/// @brief Verifies that two token streams are strictly equivalent semantically.
-inline auto ensureSafety(antlr4::CommonTokenStream& original, antlr4::CommonTokenStream& formatted)
+/// @brief What verification compares of a source token: enough to check formatted output
+///        against once the token stream and its lexer are gone.
+struct SemanticToken
+{
+    std::size_t type;
+    std::string text;
+    std::size_t line;
+};
+
+/// @brief The semantic tokens of a range, for ensureSafety().
+inline auto collectSemantic(std::span<antlr4::Token* const> tokens) -> std::vector<SemanticToken>
+{
+    std::vector<SemanticToken> result{};
+    for (const auto* t : tokens | std::views::filter(detail::IS_SEMANTIC)) {
+        result.push_back(
+          SemanticToken{.type = t->getType(), .text = t->getText(), .line = t->getLine()});
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+namespace detail {
+
+// Uniform access to the original side, live tokens or semantic ones
+inline auto token(antlr4::Token* t) -> antlr4::Token*
+{
+    return t;
+}
+
+inline auto token(const SemanticToken& /*t*/) -> antlr4::Token*
+{
+    return nullptr;
+}
+
+inline auto type(const antlr4::Token* t) -> std::size_t
+{
+    return t->getType();
+}
+
+inline auto type(const SemanticToken& t) -> std::size_t
+{
+    return t.type;
+}
+
+inline auto text(const antlr4::Token* t) -> std::string
+{
+    return t->getText();
+}
+
+inline auto text(const SemanticToken& t) -> const std::string&
+{
+    return t.text;
+}
+
+inline auto line(const antlr4::Token* t) -> std::size_t
+{
+    return t->getLine();
+}
+
+inline auto line(const SemanticToken& t) -> std::size_t
+{
+    return t.line;
+}
+
+template<std::ranges::view View>
+auto ensureSafety(View orig_view, std::span<antlr4::Token* const> formatted)
   -> std::expected<void, VerificationError>
 {
-    // Create lazy views of the semantic tokens
-    auto orig_view = original.getTokens() | std::views::filter(detail::IS_SEMANTIC);
-    auto fmt_view = formatted.getTokens() | std::views::filter(detail::IS_SEMANTIC);
+    auto fmt_view = formatted | std::views::filter(IS_SEMANTIC);
 
     // Predicate: Do these two tokens match?
-    auto token_match = [](antlr4::Token* t1, antlr4::Token* t2) -> bool {
-        return t1->getType() == t2->getType() && detail::EQUALS(t1->getText(), t2->getText());
+    auto token_match = [](const auto& t1, antlr4::Token* t2) -> bool {
+        return type(t1) == t2->getType() && EQUALS(text(t1), t2->getText());
     };
 
     // Find the first point of divergence
@@ -84,28 +149,28 @@ inline auto ensureSafety(antlr4::CommonTokenStream& original, antlr4::CommonToke
     if (it_fmt == fmt_view.end()) {
         return std::unexpected(VerificationError{
           .message = std::format("Formatted output is truncated. Missing expected token: '{}'",
-                                 (*it_orig)->getText()),
-          .expected = *it_orig,
+                                 text(*it_orig)),
+          .expected = token(*it_orig),
           .actual = nullptr,
           .kind = VerificationError::Kind::MISSING_TOKEN});
     }
 
     // If we are here, both iterators pointed to tokens that didn't match.
     // We inspect the tokens to generate the specific error message (Type vs Text).
-    auto* t_orig = *it_orig;
+    const auto& t_orig = *it_orig;
     auto* t_fmt = *it_fmt;
 
-    if (t_orig->getType() != t_fmt->getType()) {
+    if (type(t_orig) != t_fmt->getType()) {
         return std::unexpected(VerificationError{
           .message = std::format(
             "Token Type Mismatch!\n" "  Original:  '{}' (Type: {}, Line: {})\n" "  Formatted: '{}' (Type: {}, Line: {})",
-            t_orig->getText(),
-            t_orig->getType(),
-            t_orig->getLine(),
+            text(t_orig),
+            type(t_orig),
+            line(t_orig),
             t_fmt->getText(),
             t_fmt->getType(),
             t_fmt->getLine()),
-          .expected = t_orig,
+          .expected = token(t_orig),
           .actual = t_fmt,
           .kind = VerificationError::Kind::TYPE_MISMATCH});
     }
@@ -114,15 +179,45 @@ inline auto ensureSafety(antlr4::CommonTokenStream& original, antlr4::CommonToke
     return std::unexpected(VerificationError{
       .message = std::format(
         "Token Text Mismatch!\n" "  Original:  '{}' (Line: {})\n" "  Formatted: '{}' (Line: {})",
-        t_orig->getText(),
-        t_orig->getLine(),
+        text(t_orig),
+        line(t_orig),
         t_fmt->getText(),
         t_fmt->getLine()),
-      .expected = t_orig,
+      .expected = token(t_orig),
       .actual = t_fmt,
       .kind = VerificationError::Kind::TEXT_MISMATCH});
 }
 
+} // namespace detail
+
+/// @brief Verifies that two token ranges are strictly equivalent semantically.
+/// @note Lets a slice of a larger stream (e.g. one design unit) be checked on its own.
+inline auto ensureSafety(std::span<antlr4::Token* const> original,
+                         std::span<antlr4::Token* const> formatted)
+  -> std::expected<void, VerificationError>
+{
+    return detail::ensureSafety(original | std::views::filter(detail::IS_SEMANTIC), formatted);
+}
+
+/// @brief Verifies formatted tokens against semantic tokens collected from the source.
+/// @note VerificationError::expected is always null, the source tokens being gone.
+inline auto ensureSafety(std::span<const SemanticToken> original,
+                         std::span<antlr4::Token* const> formatted)
+  -> std::expected<void, VerificationError>
+{
+    return detail::ensureSafety(original, formatted);
+}
+
+/// @brief Verifies that two token streams are strictly equivalent semantically.
+inline auto ensureSafety(antlr4::CommonTokenStream& original, antlr4::CommonTokenStream& formatted)
+  -> std::expected<void, VerificationError>
+{
+    const auto original_tokens = original.getTokens();
+    const auto formatted_tokens = formatted.getTokens();
+
+    return ensureSafety(std::span{original_tokens}, std::span{formatted_tokens});
+}
+
 } // namespace builder::verify
 
 #endif /* BUILDER_VERIFIER_HPP */
@@ -0,0 +1,156 @@
+#include "builder/warm_up.hpp"
+
+#include "builder/ast_builder.hpp"
+#include "common/logger.hpp"
+
+#include <exception>
+#include <string_view>
+
+namespace builder {
+
+namespace {
+
+// Covers the statements, declarations and expression shapes that dominate real designs.
+// Every construct here must parse in SLL mode, otherwise warming up would pay for the
+// LL fallback instead (see "Warm-up corpus parses without LL fallback").
+constexpr std::string_view WARM_UP_CORPUS = R"(
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+package warm_pkg is
+    constant DEPTH : natural := 16;
+
+    type state_t is (IDLE, LOAD, RUN, DONE);
+    type word_array_t is array (0 to DEPTH - 1) of std_logic_vector(7 downto 0);
+    type bus_t is record
+        addr  : unsigned(15 downto 0);
+        data  : std_logic_vector(7 downto 0);
+        valid : std_logic;
+    end record;
+    type node_ptr_t is access bus_t;
+    type text_file_t is file of character;
+
+    function parity(v : std_logic_vector) return std_logic;
+end package warm_pkg;
+
+package body warm_pkg is
+    function parity(v : std_logic_vector) return std_logic is
+        variable p : std_logic := '0';
+    begin
+        for i in v'range loop
+            p := p xor v(i);
+        end loop;
+        return p;
+    end function parity;
+end package body warm_pkg;
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use work.warm_pkg.all;
+
+entity warm_core is
+    generic (
+        WIDTH : integer := 8;
+        RESET_VALUE : std_logic := '0'
+    );
+    port (
+        clk      : in  std_logic;
+        rst      : in  std_logic;
+        data_in  : in  std_logic_vector(WIDTH - 1 downto 0);
+        data_out : out std_logic_vector(WIDTH - 1 downto 0);
+        ready    : out std_logic
+    );
+end entity warm_core;
+
+architecture rtl of warm_core is
+    component warm_leaf is
+        port (
+            a : in  std_logic;
+            y : out std_logic
+        );
+    end component;
+
+    signal state : state_t := IDLE;
+    signal count : unsigned(3 downto 0) := (others => '0');
+    signal regs  : word_array_t;
+    signal q, d  : std_logic_vector(WIDTH - 1 downto 0);
+    constant ZERO : std_logic_vector(WIDTH - 1 downto 0) := (others => '0');
+begin
+    ready <= '1' when state = DONE else '0';
+
+    with state select
+        d <= data_in when LOAD,
+             std_logic_vector(unsigned(q) + 1) when RUN,
+             ZERO when others;
+
+    leaf_inst : warm_leaf
+        port map (
+            a => rst,
+            y => open
+        );
+
+    gen_regs : for i in 0 to DEPTH - 1 generate
+        regs(i) <= d(7 downto 0) when rising_edge(clk);
+    end generate gen_regs;
+
+    fsm : process (clk, rst)
+        variable next_count : integer range 0 to 15;
+    begin
+        if rst = '1' then
+            state <= IDLE;
+            count <= (others => '0');
+            q <= (others => RESET_VALUE);
+        elsif rising_edge(clk) then
+            case state is
+                when IDLE =>
+                    state <= LOAD;
+                when LOAD | RUN =>
+                    next_count := to_integer(count) + 1;
+                    if next_count > 10 and q(0) /= '1' then
+                        state <= DONE;
+                    end if;
+                    count <= to_unsigned(next_count, count'length);
+                    q <= d;
+                when others =>
+                    null;
+            end case;
+        end if;
+    end process fsm;
+
+    data_out <= q;
+
+    checker : process
+    begin
+        wait until rising_edge(clk);
+        assert q'length = WIDTH report "width mismatch" severity failure;
+        while state /= DONE loop
+            wait for 10 ns;
+        end loop;
+        wait;
+    end process checker;
+end architecture rtl;
+)";
+
+} // namespace
+
+auto warmUpCorpus() -> std::string_view
+{
+    return WARM_UP_CORPUS;
+}
+
+auto warmUp() -> void
+{
+    // Lexer and parser DFAs are static per grammar, so the throwaway context is enough
+    try {
+        auto ctx = createContext(WARM_UP_CORPUS);
+        static_cast<void>(parse(ctx));
+    }
+    catch (const std::exception& e) {
+        // Only a cache primer: a failure costs the speed-up, never the real run
+        common::Logger::instance().debug("Parser warm-up failed: {}", e.what());
+    }
+}
+
+} // namespace builder
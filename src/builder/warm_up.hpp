@@ -0,0 +1,21 @@
+#ifndef BUILDER_WARM_UP_HPP
+#define BUILDER_WARM_UP_HPP
+
+#include <string_view>
+
+namespace builder {
+
+/// @brief Representative VHDL compiled into the binary to prime the prediction caches.
+[[nodiscard]]
+auto warmUpCorpus() -> std::string_view;
+
+/// @brief Lexes and parses the embedded corpus once so the shared lexer and parser DFAs
+///        already hold the common decisions when the first real file arrives.
+/// @note The ANTLR C++ runtime cannot serialise its DFA, so the caches are rebuilt in
+///       process. This only pays off for callers that format several inputs (editor
+///       integrations, batch runs); a one-shot run would just parse twice.
+auto warmUp() -> void;
+
+} // namespace builder
+
+#endif /* BUILDER_WARM_UP_HPP */
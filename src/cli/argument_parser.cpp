@@ -1,19 +1,25 @@
 #include "argument_parser.hpp"
 
+#include "common/stats.hpp"
 #include "version.hpp"
 
 #include <argparse/argparse.hpp>
 #include <bitset>
+#include <charconv>
+#include <chrono>
 #include <cstddef>
 #include <exception>
 #include <filesystem>
 #include <format>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace cli {
@@ -23,6 +29,90 @@ namespace {
 constexpr std::string_view FLAG_WRITE{"--write"};
 constexpr std::string_view FLAG_CHECK{"--check"};
 constexpr std::string_view FLAG_LOCATION{"--location"};
+constexpr std::string_view FLAG_LSP{"--lsp"};
+constexpr std::string_view FLAG_LINES{"--lines"};
+constexpr std::string_view FLAG_OUTPUT{"--output"};
+constexpr std::string_view FLAG_DIFF{"--diff"};
+constexpr std::string_view FLAG_WATCH{"--watch"};
+constexpr std::string_view FLAG_STREAM{"--stream"};
+constexpr std::string_view FLAG_TIMEOUT_PER_FILE{"--timeout-per-file"};
+constexpr std::string_view FLAG_PREDICTION_CACHE_LIMIT{"--prediction-cache-limit"};
+constexpr std::string_view FLAG_STATS{"--stats"};
+constexpr std::string_view FLAG_EXPLAIN_LAYOUT{"--explain-layout"};
+
+auto parseLineNumber(std::string_view text) -> std::size_t
+{
+    std::size_t value{0};
+    const auto* const last = std::to_address(text.end());
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+
+    if (ec != std::errc{} || ptr != last || value == 0) {
+        throw std::runtime_error(std::format("Invalid line number: '{}'", text));
+    }
+
+    return value;
+}
+
+auto parseLineRange(std::string_view text) -> LineRange
+{
+    const auto colon = text.find(':');
+    if (colon == std::string_view::npos) {
+        throw std::runtime_error(std::format("Expected a line range first:last, got '{}'", text));
+    }
+
+    const LineRange range{.first = parseLineNumber(text.substr(0, colon)),
+                          .last = parseLineNumber(text.substr(colon + 1))};
+
+    if (range.first > range.last) {
+        throw std::runtime_error(std::format("Line range is reversed: '{}'", text));
+    }
+
+    return range;
+}
+
+auto parseTimeout(std::string_view text) -> std::chrono::milliseconds
+{
+    std::chrono::milliseconds::rep value{0};
+    const auto* const last = std::to_address(text.end());
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+
+    if (ec != std::errc{} || ptr != last || value <= 0) {
+        throw std::runtime_error(std::format("Invalid timeout in milliseconds: '{}'", text));
+    }
+
+    return std::chrono::milliseconds{value};
+}
+
+auto parseMebibytes(std::string_view text) -> std::size_t
+{
+    constexpr std::size_t MEBIBYTE{1024UZ * 1024};
+
+    std::size_t value{0};
+    const auto* const last = std::to_address(text.end());
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+
+    if (ec != std::errc{} || ptr != last
+        || value > std::numeric_limits<std::size_t>::max() / MEBIBYTE)
+    {
+        throw std::runtime_error(std::format("Invalid size in MiB: '{}'", text));
+    }
+
+    return value * MEBIBYTE;
+}
+
+auto parseStatsFormat(std::string_view text) -> StatsFormat
+{
+    if (text == "text") {
+        return StatsFormat::TEXT;
+    }
+
+    if (text == "json") {
+        return StatsFormat::JSON;
+    }
+
+    throw std::runtime_error(
+      std::format("Invalid --stats format, expected text or json: '{}'", text));
+}
 
 } // namespace
 
@@ -41,6 +131,33 @@ auto ArgumentParser::getInputPath() const noexcept -> const std::filesystem::pat
     return input_path_;
 }
 
+auto ArgumentParser::getLineRange() const noexcept -> const std::optional<LineRange>&
+{
+    return line_range_;
+}
+
+auto ArgumentParser::getOutputMode() const noexcept -> OutputMode
+{
+    return output_mode_;
+}
+
+auto ArgumentParser::getStatsFormat() const noexcept -> const std::optional<StatsFormat>&
+{
+    return stats_format_;
+}
+
+auto ArgumentParser::getTimeoutPerFile() const noexcept
+  -> const std::optional<std::chrono::milliseconds>&
+{
+    return timeout_per_file_;
+}
+
+auto ArgumentParser::getPredictionCacheLimit() const noexcept
+  -> const std::optional<std::size_t>&
+{
+    return prediction_cache_limit_;
+}
+
 auto ArgumentParser::isFlagSet(ArgumentFlag flag) const noexcept -> bool
 {
     return used_flags_.test(static_cast<std::size_t>(flag));
@@ -58,6 +175,7 @@ auto ArgumentParser::parseArguments(std::span<const char* const> args) -> void
     program.add_argument("input")
       .help("VHDL file or directory to format")
       .metavar("file.vhd")
+      .nargs(argparse::nargs_pattern::optional)
       .action([this](std::string_view location) -> void {
           const std::filesystem::path input_path{location};
 
@@ -85,6 +203,65 @@ auto ArgumentParser::parseArguments(std::span<const char* const> args) -> void
       .default_value(false)
       .implicit_value(true);
 
+    program.add_argument(FLAG_LSP)
+      .help("Runs as a language server on stdin/stdout")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_DIFF)
+      .help("Reads a unified diff, or path:first:last lines, from stdin and formats only the "
+            "changed design units of those files")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_WATCH)
+      .help("Watches the input directory and formats VHDL files in place whenever they are saved")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_STREAM)
+      .help("Formats one design unit at a time so that huge files never sit in memory whole")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_EXPLAIN_LAYOUT)
+      .help("Prints every decision to keep a group on one line or break it, with the source "
+            "line it belongs to, instead of the formatted file")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_LINES)
+      .help("Formats only the design units overlapping the lines first:last")
+      .metavar("first:last")
+      .action([this](std::string_view range) -> void { line_range_ = parseLineRange(range); });
+
+    program.add_argument(FLAG_TIMEOUT_PER_FILE)
+      .help("Gives up on a file that takes longer than this to format and leaves it untouched")
+      .metavar("ms")
+      .action([this](std::string_view timeout) -> void {
+          timeout_per_file_ = parseTimeout(timeout);
+      });
+
+    program.add_argument(FLAG_PREDICTION_CACHE_LIMIT)
+      .help("Clears the parser's prediction caches when they grow past this size; 0 never clears "
+            "them")
+      .metavar("MiB")
+      .action([this](std::string_view limit) -> void {
+          prediction_cache_limit_ = parseMebibytes(limit);
+      });
+
+    program.add_argument(FLAG_STATS)
+      .help("Prints the time spent in every phase and the token and node counts to stderr; "
+            "--stats=json prints them as one JSON object")
+      .default_value(false)
+      .implicit_value(true);
+
+    program.add_argument(FLAG_OUTPUT)
+      .help("Prints the formatted file (text) or a JSON list of edits to apply to it (edits)")
+      .metavar("text|edits")
+      .default_value(std::string{"text"})
+      .choices("text", "edits");
+
     program.add_argument("-l", FLAG_LOCATION)
       .help("Path to the configuration file (e.g., /path/to/vhdl-fmt.yaml)")
       .action([this](std::string_view location) -> void {
@@ -109,13 +286,104 @@ auto ArgumentParser::parseArguments(std::span<const char* const> args) -> void
 
         // parse_args expects a c-style array
         for (const auto* const arg : args) {
+            const std::string_view view{arg};
+
+            // An optional value would make argparse take the input file for it
+            if (view == FLAG_STATS) {
+                stats_format_ = StatsFormat::TEXT;
+            } else if (view.starts_with(std::format("{}=", FLAG_STATS))) {
+                stats_format_ = parseStatsFormat(view.substr(FLAG_STATS.size() + 1));
+                c_args.emplace_back(FLAG_STATS);
+                continue;
+            }
+
             c_args.emplace_back(arg);
         }
 
         program.parse_args(c_args);
 
+        // The language server and diff mode take their input from stdin
+        if (input_path_.empty() && !program.is_used(FLAG_LSP) && !program.is_used(FLAG_DIFF)) {
+            throw std::runtime_error("Missing input: file.vhd");
+        }
+
+        if (program.is_used(FLAG_DIFF) && (program.is_used(FLAG_LINES) || !input_path_.empty())) {
+            throw std::runtime_error("--diff takes its files from stdin and cannot be combined "
+                                     "with an input file or --lines");
+        }
+
+        if (program.is_used(FLAG_WATCH)) {
+            if (!std::filesystem::is_directory(input_path_)) {
+                throw std::runtime_error("--watch needs a directory to watch");
+            }
+
+            if (program.is_used(FLAG_LSP) || program.is_used(FLAG_DIFF)
+                || program.is_used(FLAG_LINES) || program.is_used(FLAG_CHECK)
+                || program.is_used(FLAG_OUTPUT))
+            {
+                throw std::runtime_error(
+                  "--watch cannot be combined with --lsp, --diff, --lines, --check or --output");
+            }
+        }
+
+        if (program.is_used(FLAG_STREAM)) {
+            if (!std::filesystem::is_regular_file(input_path_)) {
+                throw std::runtime_error("--stream needs a file to format");
+            }
+
+            if (program.is_used(FLAG_LSP) || program.is_used(FLAG_DIFF)
+                || program.is_used(FLAG_WATCH) || program.is_used(FLAG_LINES)
+                || program.is_used(FLAG_OUTPUT))
+            {
+                throw std::runtime_error(
+                  "--stream cannot be combined with --lsp, --diff, --watch, --lines or --output");
+            }
+        }
+
+        if (program.is_used(FLAG_EXPLAIN_LAYOUT)) {
+            if (!std::filesystem::is_regular_file(input_path_)) {
+                throw std::runtime_error("--explain-layout needs a file to format");
+            }
+
+            if (program.is_used(FLAG_WRITE) || program.is_used(FLAG_LSP)
+                || program.is_used(FLAG_DIFF) || program.is_used(FLAG_WATCH)
+                || program.is_used(FLAG_STREAM) || program.is_used(FLAG_LINES)
+                || program.is_used(FLAG_OUTPUT))
+            {
+                throw std::runtime_error("--explain-layout cannot be combined with --write, --lsp, "
+                                         "--diff, --watch, --stream, --lines or --output");
+            }
+        }
+
+        if (stats_format_.has_value()) {
+            if (!common::stats::COMPILED) {
+                throw std::runtime_error("--stats is not available in this build");
+            }
+
+            if (program.is_used(FLAG_LSP) || program.is_used(FLAG_WATCH)) {
+                throw std::runtime_error("--stats cannot be combined with --lsp or --watch");
+            }
+        }
+
+        if (program.get<std::string>(FLAG_OUTPUT) == "edits") {
+            if (program.is_used(FLAG_WRITE) || program.is_used(FLAG_LINES)
+                || program.is_used(FLAG_DIFF))
+            {
+                throw std::runtime_error(
+                  "--output=edits cannot be combined with --write, --lines or --diff");
+            }
+            output_mode_ = OutputMode::EDITS;
+        }
+
         used_flags_.set(static_cast<std::size_t>(ArgumentFlag::WRITE), program.is_used(FLAG_WRITE));
         used_flags_.set(static_cast<std::size_t>(ArgumentFlag::CHECK), program.is_used(FLAG_CHECK));
+        used_flags_.set(static_cast<std::size_t>(ArgumentFlag::LSP), program.is_used(FLAG_LSP));
+        used_flags_.set(static_cast<std::size_t>(ArgumentFlag::DIFF), program.is_used(FLAG_DIFF));
+        used_flags_.set(static_cast<std::size_t>(ArgumentFlag::WATCH), program.is_used(FLAG_WATCH));
+        used_flags_.set(static_cast<std::size_t>(ArgumentFlag::STREAM),
+                        program.is_used(FLAG_STREAM));
+        used_flags_.set(static_cast<std::size_t>(ArgumentFlag::EXPLAIN_LAYOUT),
+                        program.is_used(FLAG_EXPLAIN_LAYOUT));
     }
     catch (const std::exception& err) {
         std::cerr << std::format("Error parsing arguments: {}\n", err.what());
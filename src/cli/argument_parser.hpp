@@ -2,6 +2,7 @@
 #define CLI_ARGUMENT_PARSER_HPP
 
 #include <bitset>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
@@ -14,7 +15,32 @@ enum class ArgumentFlag : std::uint8_t
 {
     WRITE = 0,
     CHECK = 1,
-    FLAG_COUNT = 2, // Required for flag count
+    LSP = 2,
+    DIFF = 3,
+    WATCH = 4,
+    STREAM = 5,
+    EXPLAIN_LAYOUT = 6,
+    FLAG_COUNT = 7, // Required for flag count
+};
+
+enum class OutputMode : std::uint8_t
+{
+    TEXT,  ///< The formatted file
+    EDITS, ///< Edits that turn the input into the formatted file
+};
+
+/// @brief Form of the report printed to stderr with `--stats[=json]`.
+enum class StatsFormat : std::uint8_t
+{
+    TEXT, ///< A table for people
+    JSON, ///< One JSON object per run, with totals that add up across runs
+};
+
+/// @brief Inclusive, 1-based line range given with `--lines first:last`.
+struct LineRange final
+{
+    std::size_t first;
+    std::size_t last;
 };
 
 class ArgumentParser final
@@ -28,12 +54,36 @@ class ArgumentParser final
     [[nodiscard]]
     auto getInputPath() const noexcept -> const std::filesystem::path&;
 
+    [[nodiscard]]
+    auto getLineRange() const noexcept -> const std::optional<LineRange>&;
+
+    [[nodiscard]]
+    auto getOutputMode() const noexcept -> OutputMode;
+
+    /// @brief The report asked for with `--stats[=json]`, if any.
+    [[nodiscard]]
+    auto getStatsFormat() const noexcept -> const std::optional<StatsFormat>&;
+
+    /// @brief Time a file may take to format, given with `--timeout-per-file ms`.
+    [[nodiscard]]
+    auto getTimeoutPerFile() const noexcept -> const std::optional<std::chrono::milliseconds>&;
+
+    /// @brief Memory ceiling for the parser's prediction caches in bytes, given in MiB with
+    ///        `--prediction-cache-limit MiB`; 0 disables it.
+    [[nodiscard]]
+    auto getPredictionCacheLimit() const noexcept -> const std::optional<std::size_t>&;
+
     [[nodiscard]]
     auto isFlagSet(ArgumentFlag flag) const noexcept -> bool;
 
   private:
     std::optional<std::filesystem::path> config_file_path_;
     std::filesystem::path input_path_;
+    std::optional<LineRange> line_range_;
+    OutputMode output_mode_{OutputMode::TEXT};
+    std::optional<std::chrono::milliseconds> timeout_per_file_;
+    std::optional<std::size_t> prediction_cache_limit_;
+    std::optional<StatsFormat> stats_format_;
     std::bitset<static_cast<std::size_t>(ArgumentFlag::FLAG_COUNT)> used_flags_;
 
     auto parseArguments(std::span<const char* const> args) -> void;
@@ -42,6 +42,12 @@ constexpr std::array<std::pair<std::string_view, common::EndOfLine>, 3> EOL_STYL
   std::pair{"lf",   common::EndOfLine::LF  },
 };
 
+constexpr std::array<std::pair<std::string_view, common::LayoutMode>, 3> LAYOUT_MODE_MAP = {
+  std::pair{"auto",     common::LayoutMode::AUTO    },
+  std::pair{"standard", common::LayoutMode::STANDARD},
+  std::pair{"netlist",  common::LayoutMode::NETLIST },
+};
+
 constexpr std::array<std::pair<std::string_view, PortMapMemberPtr>, 1> PORT_MAP_ASSIGNMENTS_MAP = {
   std::pair{"align_signals", &common::PortMapConfig::align_signals},
 };
@@ -192,6 +198,7 @@ auto ConfigReader::readConfigFile() -> std::expected<common::Config, ConfigReadE
         config.eol_format = readEndOfLine(root_node, config.eol_format);
         config.line_config = readLineconfig(root_node, config.line_config);
         config.indent_style = readIndentationStyle(root_node, config.indent_style);
+        config.layout = readLayoutMode(root_node, config.layout);
         config.declarations = readDeclarationConfig(root_node, config.declarations);
 
         return config;
@@ -263,6 +270,20 @@ auto ConfigReader::readEndOfLine(const YAML::Node& root_node, const common::EndO
     return eol;
 }
 
+auto ConfigReader::readLayoutMode(const YAML::Node& root_node, const common::LayoutMode& defaults)
+  -> common::LayoutMode
+{
+    auto layout = defaults;
+
+    if (auto result = parseAndMapYamlValue<common::LayoutMode, 3>(
+          root_node, "layout", LAYOUT_MODE_MAP, "layout mode"))
+    {
+        layout = *result;
+    }
+
+    return layout;
+}
+
 auto ConfigReader::readPortMapConfig(const YAML::Node& root_node,
                                      const common::PortMapConfig& defaults) -> common::PortMapConfig
 {
@@ -46,6 +46,10 @@ class ConfigReader final
     static auto readEndOfLine(const YAML::Node& root_node, const common::EndOfLine& defaults)
       -> common::EndOfLine;
 
+    [[nodiscard]]
+    static auto readLayoutMode(const YAML::Node& root_node, const common::LayoutMode& defaults)
+      -> common::LayoutMode;
+
     [[nodiscard]]
     static auto readPortMapConfig(const YAML::Node& root_node,
                                   const common::PortMapConfig& defaults) -> common::PortMapConfig;
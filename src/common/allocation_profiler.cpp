@@ -0,0 +1,311 @@
+#include "common/allocation_profiler.hpp"
+
+#include "common/stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <format>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace common::allocations {
+
+namespace {
+
+// Every block starts with its size, so delete knows how much stops being live
+constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+// Open addressing over call stacks; sites beyond this many are counted per phase only
+constexpr std::size_t SITE_SLOTS = 8192;
+
+// Frames kept per allocation: enough to climb out of this file and the standard library's
+// allocators, containers and make_shared to the code that asked for the memory
+constexpr std::size_t STACK_DEPTH = 12;
+
+using Stack = std::array<std::uintptr_t, STACK_DEPTH>;
+
+struct PhaseCounters
+{
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> peak_live_bytes{0};
+};
+
+struct SiteCounters
+{
+    std::atomic<std::uint64_t> key{0}; ///< Hash of the stack, 0 while the slot is free
+    std::array<std::atomic<std::uintptr_t>, STACK_DEPTH> frames{};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> bytes{0};
+};
+
+// Constant initialized, so they are usable by allocations made before main()
+constinit std::array<PhaseCounters, stats::PHASE_COUNT + 1> phases{};
+constinit std::array<SiteCounters, SITE_SLOTS> sites{};
+constinit std::atomic<std::uint64_t> live_bytes{0};
+constinit std::atomic<std::uint64_t> peak_live_bytes{0};
+
+auto raise(std::atomic<std::uint64_t>& peak, std::uint64_t value) noexcept -> void
+{
+    auto current = peak.load(std::memory_order_relaxed);
+    while (current < value
+           && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+// Set while this thread unwinds its stack, since backtrace() may allocate on first use
+thread_local bool unwinding{false};
+
+// The return addresses above operator new, or only its immediate caller while unwinding
+auto captureStack(std::uintptr_t caller) noexcept -> Stack
+{
+    Stack stack{};
+    stack.front() = caller;
+    if (unwinding) {
+        return stack;
+    }
+
+    unwinding = true;
+    std::array<void*, STACK_DEPTH> frames{};
+    const auto depth = backtrace(frames.data(), static_cast<int>(frames.size()));
+    unwinding = false;
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(std::max(depth, 0)); ++i) {
+        stack.at(i) = reinterpret_cast<std::uintptr_t>(frames.at(i));
+    }
+    return stack;
+}
+
+auto hashStack(const Stack& stack) noexcept -> std::uint64_t
+{
+    // Fibonacci hashing; return addresses share their low bits
+    constexpr std::uint64_t MULTIPLIER{0x9E37'79B9'7F4A'7C15};
+
+    std::uint64_t hash{0};
+    for (const auto frame : stack) {
+        hash = (hash ^ frame) * MULTIPLIER;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+auto recordSite(const Stack& stack, std::size_t size) noexcept -> void
+{
+    const auto key = hashStack(stack);
+    auto slot = static_cast<std::size_t>(key >> 51U) % SITE_SLOTS;
+
+    for (std::size_t probe = 0; probe < SITE_SLOTS; ++probe) {
+        auto& site = sites.at(slot);
+
+        auto owner = site.key.load(std::memory_order_relaxed);
+        if (owner == 0 && site.key.compare_exchange_strong(owner, key, std::memory_order_relaxed))
+        {
+            for (std::size_t i = 0; i < STACK_DEPTH; ++i) {
+                site.frames.at(i).store(stack.at(i), std::memory_order_relaxed);
+            }
+            owner = key;
+        }
+
+        if (owner == key) {
+            site.count.fetch_add(1, std::memory_order_relaxed);
+            site.bytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+
+        slot = (slot + 1) % SITE_SLOTS;
+    }
+}
+
+auto record(std::size_t size, std::uintptr_t caller) noexcept -> void
+{
+    const auto phase = stats::Timer::activePhase();
+    auto& counters = phases.at(phase ? static_cast<std::size_t>(*phase) : stats::PHASE_COUNT);
+
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    const auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    raise(peak_live_bytes, live);
+    raise(counters.peak_live_bytes, live);
+
+    recordSite(captureStack(caller), size);
+}
+
+auto allocate(std::size_t size, std::uintptr_t caller) -> void*
+{
+    if (size > SIZE_MAX - HEADER_SIZE) {
+        throw std::bad_alloc{};
+    }
+
+    while (true) {
+        if (auto* block = std::malloc(size + HEADER_SIZE)) {
+            std::memcpy(block, &size, sizeof(size));
+            record(size, caller);
+            return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(block) + HEADER_SIZE);
+        }
+
+        auto* handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+auto deallocate(void* pointer) noexcept -> void
+{
+    if (pointer == nullptr) {
+        return;
+    }
+
+    auto* block = reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(pointer) - HEADER_SIZE);
+
+    std::size_t size{0};
+    std::memcpy(&size, block, sizeof(size));
+    live_bytes.fetch_sub(size, std::memory_order_relaxed);
+
+    std::free(block);
+}
+
+// Needs the executable linked with -rdynamic to name functions outside shared libraries
+auto describe(std::uintptr_t address) -> std::string
+{
+    Dl_info info{};
+    if (dladdr(reinterpret_cast<void*>(address), &info) == 0 || info.dli_sname == nullptr) {
+        return std::format("{:#x}", address);
+    }
+
+    auto status = 0;
+    auto* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name{status == 0 && demangled != nullptr ? demangled : info.dli_sname};
+    std::free(demangled);
+
+    return name;
+}
+
+// The standard library's allocation machinery: allocators, containers, make_shared
+auto isLibraryFrame(std::string_view name) -> bool
+{
+    constexpr std::array<std::string_view, 4> PREFIXES{
+      "std::", "__gnu_cxx::", "void std::", "operator new"};
+
+    return std::ranges::any_of(PREFIXES, [name](std::string_view prefix) {
+        return name.starts_with(prefix);
+    });
+}
+
+// The first frame above operator new that is not in the standard library, else the one right
+// above operator new. A stack captured while unwinding only holds that frame.
+auto describeSite(const Stack& frames) -> std::string
+{
+    std::vector<std::string> names{};
+    for (const auto frame : frames) {
+        if (frame == 0) {
+            break;
+        }
+        names.push_back(describe(frame));
+    }
+
+    // The profiler's own frames have internal linkage and no name, so skip past operator new
+    auto above = std::ranges::find_if(names, [](const std::string& name) {
+        return name.starts_with("operator new");
+    });
+    above = above == names.end() ? names.begin() : std::next(above);
+
+    const auto caller = std::ranges::find_if_not(above, names.end(), isLibraryFrame);
+    if (caller != names.end()) {
+        return *caller;
+    }
+    return above != names.end() ? *above : describe(frames.front());
+}
+
+} // namespace
+
+auto profile(std::size_t top_sites) -> Profile
+{
+    Profile result{};
+
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        const auto& counters = phases.at(i);
+        result.phases.at(i) = PhaseAllocations{
+          .count = counters.count.load(std::memory_order_relaxed),
+          .bytes = counters.bytes.load(std::memory_order_relaxed),
+          .peak_live_bytes = counters.peak_live_bytes.load(std::memory_order_relaxed)};
+    }
+    result.peak_live_bytes = peak_live_bytes.load(std::memory_order_relaxed);
+
+    struct Entry
+    {
+        Stack frames;
+        std::uint64_t count;
+        std::uint64_t bytes;
+    };
+
+    // Stacks that differ only below the first frame outside the allocator name the same
+    // site, so they are merged once named
+    std::vector<Entry> entries{};
+    for (const auto& site : sites) {
+        if (site.key.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        Entry entry{.frames = {},
+                    .count = site.count.load(std::memory_order_relaxed),
+                    .bytes = site.bytes.load(std::memory_order_relaxed)};
+        for (std::size_t i = 0; i < STACK_DEPTH; ++i) {
+            entry.frames.at(i) = site.frames.at(i).load(std::memory_order_relaxed);
+        }
+        entries.push_back(entry);
+    }
+
+    std::unordered_map<std::string, std::size_t> named{};
+    for (const auto& entry : entries) {
+        auto function = describeSite(entry.frames);
+        if (const auto it = named.find(function); it != named.end()) {
+            auto& site = result.top_sites.at(it->second);
+            site.count += entry.count;
+            site.bytes += entry.bytes;
+            continue;
+        }
+
+        named.emplace(function, result.top_sites.size());
+        result.top_sites.push_back(
+          Site{.function = std::move(function), .count = entry.count, .bytes = entry.bytes});
+    }
+
+    std::ranges::sort(result.top_sites, std::ranges::greater{}, &Site::count);
+    result.top_sites.resize(std::min(result.top_sites.size(), top_sites));
+
+    return result;
+}
+
+} // namespace common::allocations
+
+// Replacing the plain forms is enough: the array, nothrow and sized forms of the standard
+// library call these. Over-aligned allocations keep the library's own pair.
+
+auto operator new(std::size_t size) -> void*
+{
+    return common::allocations::allocate(
+      size, reinterpret_cast<std::uintptr_t>(__builtin_return_address(0)));
+}
+
+auto operator delete(void* pointer) noexcept -> void
+{
+    common::allocations::deallocate(pointer);
+}
+
+auto operator delete(void* pointer, std::size_t /*size*/) noexcept -> void
+{
+    common::allocations::deallocate(pointer);
+}
@@ -0,0 +1,70 @@
+#ifndef COMMON_ALLOCATION_PROFILER_HPP
+#define COMMON_ALLOCATION_PROFILER_HPP
+
+#include "common/stats.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace common::allocations {
+
+/// @brief Whether this build replaces the global operator new and delete to profile
+///        allocations.
+/// @note Configured with the ENABLE_ALLOCATION_PROFILER CMake option, off by default. Only
+///       the formatter executable carries the replacement.
+#ifdef VHDL_FMT_ALLOCATION_PROFILER
+inline constexpr bool COMPILED{true};
+#else
+inline constexpr bool COMPILED{false};
+#endif
+
+/// @brief Allocations made while one phase was being timed.
+struct PhaseAllocations final
+{
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+    std::uint64_t peak_live_bytes{0}; ///< Highest live byte count of the process in the phase
+};
+
+/// @brief One call site of operator new: the first function up the stack outside the
+///        standard library, so that allocator and container internals are seen through.
+struct Site final
+{
+    std::string function; ///< Symbol of the function, or its address if it has none
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+};
+
+struct Profile final
+{
+    /// Indexed by common::stats::Phase; the last entry holds allocations outside any phase
+    std::array<PhaseAllocations, stats::PHASE_COUNT + 1> phases{};
+    std::uint64_t peak_live_bytes{0};
+    std::vector<Site> top_sites; ///< Most allocations first
+};
+
+#ifdef VHDL_FMT_ALLOCATION_PROFILER
+
+/// @brief Allocations since the process started.
+/// @note Allocations are attributed to the phase common::stats::Timer is timing on the
+///       allocating thread, so phases only show up when statistics are enabled.
+/// @param top_sites How many call sites to return.
+[[nodiscard]]
+auto profile(std::size_t top_sites) -> Profile;
+
+#else
+
+[[nodiscard]]
+inline auto profile(std::size_t /*top_sites*/) -> Profile
+{
+    return Profile{};
+}
+
+#endif
+
+} // namespace common::allocations
+
+#endif /* COMMON_ALLOCATION_PROFILER_HPP */
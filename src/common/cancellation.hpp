@@ -0,0 +1,127 @@
+#ifndef COMMON_CANCELLATION_HPP
+#define COMMON_CANCELLATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <optional>
+
+namespace common {
+
+/// @brief Thrown at a cancellation point once its token has been cancelled.
+/// @note Deliberately not a std::runtime_error, which the pipeline treats as a syntax error.
+class Cancelled final : public std::exception
+{
+  public:
+    explicit Cancelled(bool timed_out) noexcept : timed_out_{timed_out} {}
+
+    [[nodiscard]]
+    auto what() const noexcept -> const char* override
+    {
+        return timed_out_ ? "Time budget exceeded" : "Cancelled";
+    }
+
+    /// @brief Whether the token ran out of time rather than being cancelled explicitly.
+    [[nodiscard]]
+    auto timedOut() const noexcept -> bool
+    {
+        return timed_out_;
+    }
+
+  private:
+    bool timed_out_;
+};
+
+/// @brief Cooperative cancellation flag, polled by the parser, the printer and the renderer.
+///
+/// Copies share the same flag, so one thread can cancel work running on another. A token
+/// can also carry a deadline, after which it counts as cancelled. A default constructed
+/// token is never cancelled and polling it costs a null check. Hot loops call poll(), which
+/// reads the clock only once in a while.
+class CancellationToken final
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+
+    /// @brief A token that is cancelled by cancel(), or once the budget has run out.
+    [[nodiscard]]
+    static auto withBudget(std::optional<Clock::duration> budget = std::nullopt)
+      -> CancellationToken
+    {
+        CancellationToken token{};
+        token.state_ = std::make_shared<State>();
+        if (budget.has_value()) {
+            token.state_->deadline = Clock::now() + *budget;
+        }
+        return token;
+    }
+
+    auto cancel() const noexcept -> void
+    {
+        if (state_ != nullptr) {
+            state_->cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]]
+    auto isCancelled() const noexcept -> bool
+    {
+        return state_ != nullptr
+            && (state_->cancelled.load(std::memory_order_relaxed) || timedOut());
+    }
+
+    /// @throws Cancelled once the token is cancelled.
+    auto check() const -> void
+    {
+        if (isCancelled()) {
+            throw Cancelled{timedOut()};
+        }
+    }
+
+    /// @brief check() for per-node and per-decision cancellation points: the flag is read on
+    ///        every call, the clock only on the first and then every POLL_INTERVAL calls.
+    /// @note Each copy counts its own calls, so a copy must not be polled by two threads.
+    /// @throws Cancelled once the token is cancelled.
+    auto poll() const -> void
+    {
+        if (state_ == nullptr) {
+            return;
+        }
+
+        if (state_->cancelled.load(std::memory_order_relaxed)) {
+            throw Cancelled{false};
+        }
+
+        if (polls_++ % POLL_INTERVAL == 0 && timedOut()) {
+            throw Cancelled{true};
+        }
+    }
+
+    /// @brief Calls to poll() per deadline check; reading the clock is slow next to the work
+    ///        done between two calls.
+    static constexpr unsigned POLL_INTERVAL{1024};
+
+  private:
+    struct State
+    {
+        std::atomic<bool> cancelled{false};
+        Clock::time_point deadline{Clock::time_point::max()};
+    };
+
+    std::shared_ptr<State> state_{};
+    mutable unsigned polls_{0}; // Calls to poll() on this copy
+
+    [[nodiscard]]
+    auto timedOut() const noexcept -> bool
+    {
+        return state_ != nullptr && state_->deadline != Clock::time_point::max()
+            && Clock::now() >= state_->deadline;
+    }
+};
+
+} // namespace common
+
+#endif /* COMMON_CANCELLATION_HPP */
@@ -38,6 +38,8 @@ enum class EndOfLine : std::uint8_t
 struct PortMapConfig final
 {
     bool align_signals{true};
+
+    auto operator==(const PortMapConfig&) const -> bool = default;
 };
 
 /// Declaration alignment configuration
@@ -46,6 +48,8 @@ struct DeclarationConfig final
     bool align_colons{true};
     bool align_types{true};
     bool align_initialization{true};
+
+    auto operator==(const DeclarationConfig&) const -> bool = default;
 };
 
 /// Casing conventions for identifiers
@@ -61,6 +65,8 @@ struct CasingConfig final
     CaseStyle keywords{CaseStyle::LOWER};
     CaseStyle constants{CaseStyle::UPPER};
     CaseStyle identifiers{CaseStyle::LOWER};
+
+    auto operator==(const CasingConfig&) const -> bool = default;
 };
 
 /// General configuration for line wrapping and indentation
@@ -79,6 +85,8 @@ struct LineConfig final
     std::uint16_t line_length{DEFAULT_LINE_LENGTH};
     std::uint8_t indent_size{DEFAULT_INDENT_SIZE};
 
+    auto operator==(const LineConfig&) const -> bool = default;
+
     /// Validate line configuration (throws on invalid values)
     static auto validateLineConfig(const LineLength length, const IndentSize size) -> void
     {
@@ -94,6 +102,14 @@ struct LineConfig final
     }
 };
 
+/// Layout algorithm used for the statements of an architecture
+enum class LayoutMode : std::uint8_t
+{
+    AUTO,     ///< Netlist layout for architectures that look machine generated
+    STANDARD, ///< Every group is laid out by the renderer's width check
+    NETLIST,  ///< Groups are measured once when built, never flattened
+};
+
 /// Main configuration structure containing all formatter settings
 struct Config final
 {
@@ -103,6 +119,9 @@ struct Config final
     PortMapConfig port_map{};
     DeclarationConfig declarations{};
     CasingConfig casing{};
+    LayoutMode layout{LayoutMode::AUTO};
+
+    auto operator==(const Config&) const -> bool = default;
 };
 
 }; // namespace common
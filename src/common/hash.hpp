@@ -0,0 +1,63 @@
+#ifndef COMMON_HASH_HPP
+#define COMMON_HASH_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace common {
+
+/// @brief Incremental 64-bit FNV-1a hash, for cache keys that must not depend on the
+///        process (unlike std::hash).
+class Fnv1a final
+{
+  public:
+    /// @brief Mixes in the bytes of an integral or enum value, least significant first.
+    template<typename T>
+        requires std::integral<T> || std::is_enum_v<T>
+    constexpr auto add(T value) -> Fnv1a&
+    {
+        constexpr unsigned BITS_PER_BYTE = 8;
+        constexpr std::uint64_t BYTE_MASK = 0xFFU;
+
+        const auto bits = static_cast<std::uint64_t>(value);
+        for (unsigned i = 0; i < sizeof(T); ++i) {
+            mix(static_cast<std::uint8_t>((bits >> (i * BITS_PER_BYTE)) & BYTE_MASK));
+        }
+        return *this;
+    }
+
+    /// @brief Mixes in the length and then the bytes of a string, so that consecutive
+    ///        strings cannot run into each other.
+    constexpr auto add(std::string_view bytes) -> Fnv1a&
+    {
+        add(bytes.size());
+        for (const auto c : bytes) {
+            mix(static_cast<std::uint8_t>(c));
+        }
+        return *this;
+    }
+
+    [[nodiscard]]
+    constexpr auto value() const -> std::uint64_t
+    {
+        return state_;
+    }
+
+  private:
+    static constexpr std::uint64_t OFFSET_BASIS{0xCBF29CE484222325ULL};
+    static constexpr std::uint64_t PRIME{0x100000001B3ULL};
+
+    std::uint64_t state_{OFFSET_BASIS};
+
+    constexpr auto mix(std::uint8_t byte) -> void
+    {
+        state_ ^= byte;
+        state_ *= PRIME;
+    }
+};
+
+} // namespace common
+
+#endif /* COMMON_HASH_HPP */
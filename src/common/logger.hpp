@@ -79,22 +79,28 @@ class Logger final
         SPDLOG_LOGGER_CRITICAL(logger_, fmt, std::forward<Args>(args)...);
     }
 
+    /// Route all output to stderr, for modes where stdout carries a protocol stream
+    auto useStderr() -> void
+    {
+        logger_ = makeLogger(std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+    }
+
   private:
     std::shared_ptr<spdlog::logger> logger_;
 
-    Logger()
-        : logger_([] -> std::shared_ptr<std::_NonArray<spdlog::logger>> {
-              auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-              console_sink->set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
-              console_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+    Logger() : logger_(makeLogger(std::make_shared<spdlog::sinks::stdout_color_sink_mt>())) {}
 
-              auto logger = std::make_shared<spdlog::logger>("", console_sink);
-              logger->set_level(console_sink->level());
-              logger->flush_on(spdlog::level::err);
+    static auto makeLogger(spdlog::sink_ptr console_sink) -> std::shared_ptr<spdlog::logger>
+    {
+        console_sink->set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+        console_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+
+        auto logger = std::make_shared<spdlog::logger>("", console_sink);
+        logger->set_level(console_sink->level());
+        logger->flush_on(spdlog::level::err);
 
-              return logger;
-          }())
-    {}
+        return logger;
+    }
 };
 
 } // namespace common
@@ -0,0 +1,353 @@
+#ifndef COMMON_STATS_HPP
+#define COMMON_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace common::stats {
+
+/// @brief Whether this build carries the timers and counters behind `--stats`.
+/// @note Configured with the ENABLE_STATS CMake option. Without it, Timer and count()
+///       compile to nothing.
+#ifdef VHDL_FMT_STATS
+inline constexpr bool COMPILED{true};
+#else
+inline constexpr bool COMPILED{false};
+#endif
+
+/// @brief The phases of a run, in pipeline order.
+enum class Phase : std::uint8_t
+{
+    READ,        ///< Reading the input
+    LEX,         ///< Lexing the source
+    SLL_PARSE,   ///< Parsing with SLL prediction
+    LL_PARSE,    ///< Parsing again with full LL prediction, after SLL failed
+    TRANSLATE,   ///< Building the AST from the parse tree
+    TRIVIA_BIND, ///< Mapping tokens to bytes for trivia; binding it to nodes is TRANSLATE
+    DOC_BUILD,   ///< Printing the AST into a document
+    ALIGN,       ///< Resolving alignment scopes
+    RENDER,      ///< Rendering the document to text
+    VERIFY,      ///< Re-lexing the output and comparing it with the source
+    WRITE,       ///< Writing the output
+    PHASE_COUNT, // Required for phase count
+};
+
+enum class Counter : std::uint8_t
+{
+    FILES,         ///< Files formatted
+    TOKENS,        ///< Source tokens, hidden ones included
+    CST_NODES,     ///< Parse tree nodes, terminals included
+    AST_NODES,     ///< AST nodes built by the translator
+    DOC_NODES,     ///< Document nodes built by the printer
+    LL_FALLBACKS,  ///< Parses that fell back from SLL to LL
+
+    // Layout engine
+    UNION_DECISIONS,     ///< Groups the renderer decided on, in break mode
+    UNION_FLAT,          ///< ...of which it printed flat
+    UNION_BROKEN,        ///< ...of which it broke
+    FITS_CALLS,          ///< Flat width measurements
+    FITS_NODES,          ///< Document nodes visited by them
+    ALIGN_RESOLVES,      ///< Alignment scopes resolved
+    ALIGN_REBUILT_NODES, ///< Document nodes rebuilt while resolving them
+    DOC_MAX_DEPTH,       ///< Deepest printed document; a maximum rather than a sum
+
+    // Render cache, in processes that keep it (see pipeline::RenderCache)
+    RENDER_CACHE_HITS,      ///< Design units served from the cache
+    RENDER_CACHE_MISSES,    ///< ...rendered because they were not cached
+    RENDER_CACHE_EVICTIONS, ///< Rendered units dropped to stay within capacity
+
+    // Document nodes by kind, in the order of the alternatives of emit::DocImpl
+    DOC_EMPTY,
+    DOC_TEXT,
+    DOC_KEYWORD,
+    DOC_SOFT_LINE,
+    DOC_HARD_LINE,
+    DOC_HARD_LINES,
+    DOC_CONCAT,
+    DOC_NEST,
+    DOC_HANG,
+    DOC_UNION,
+    DOC_ALIGN,
+    DOC_MARK,
+
+    COUNTER_COUNT, // Required for counter count
+};
+
+inline constexpr auto PHASE_COUNT = static_cast<std::size_t>(Phase::PHASE_COUNT);
+inline constexpr auto COUNTER_COUNT = static_cast<std::size_t>(Counter::COUNTER_COUNT);
+
+/// @brief Stable names, used as keys of the JSON report.
+inline constexpr std::array<std::string_view, PHASE_COUNT> PHASE_NAMES{
+  "read",
+  "lex",
+  "sll_parse",
+  "ll_parse",
+  "translate",
+  "trivia_bind",
+  "doc_build",
+  "align",
+  "render",
+  "verify",
+  "write",
+};
+
+inline constexpr std::array<std::string_view, COUNTER_COUNT> COUNTER_NAMES{
+  "files",
+  "tokens",
+  "cst_nodes",
+  "ast_nodes",
+  "doc_nodes",
+  "ll_fallbacks",
+  "union_decisions",
+  "union_flat",
+  "union_broken",
+  "fits_calls",
+  "fits_nodes",
+  "align_resolves",
+  "align_rebuilt_nodes",
+  "doc_max_depth",
+  "render_cache_hits",
+  "render_cache_misses",
+  "render_cache_evictions",
+  "doc_empty",
+  "doc_text",
+  "doc_keyword",
+  "doc_soft_line",
+  "doc_hard_line",
+  "doc_hard_lines",
+  "doc_concat",
+  "doc_nest",
+  "doc_hang",
+  "doc_union",
+  "doc_align",
+  "doc_mark",
+};
+
+/// @brief Totals since the registry was last reset.
+struct Snapshot final
+{
+    std::array<std::chrono::nanoseconds, PHASE_COUNT> phases{};
+    std::array<std::uint64_t, COUNTER_COUNT> counters{};
+};
+
+/// @brief Process-wide totals of every phase and counter, summed over all threads.
+/// @note Collects nothing until enabled, so instrumented code only pays for a flag check.
+class Registry final
+{
+  public:
+    [[nodiscard]]
+    static auto instance() -> Registry&
+    {
+        static Registry registry{};
+        return registry;
+    }
+
+    Registry(const Registry&) = delete;
+    auto operator=(const Registry&) -> Registry& = delete;
+    Registry(Registry&&) = delete;
+    auto operator=(Registry&&) -> Registry& = delete;
+
+    auto enable(bool enabled = true) noexcept -> void
+    {
+        enabled_.store(COMPILED && enabled, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    auto enabled() const noexcept -> bool
+    {
+        return COMPILED && enabled_.load(std::memory_order_relaxed);
+    }
+
+    auto add(Phase phase, std::chrono::nanoseconds elapsed) noexcept -> void
+    {
+        phases_.at(static_cast<std::size_t>(phase))
+          .fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+
+    auto add(Counter counter, std::uint64_t amount) noexcept -> void
+    {
+        counters_.at(static_cast<std::size_t>(counter))
+          .fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /// @brief Raises a counter that keeps a maximum (see Counter::DOC_MAX_DEPTH).
+    auto raise(Counter counter, std::uint64_t value) noexcept -> void
+    {
+        auto& maximum = counters_.at(static_cast<std::size_t>(counter));
+        auto current = maximum.load(std::memory_order_relaxed);
+        while (current < value
+               && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]]
+    auto snapshot() const noexcept -> Snapshot
+    {
+        Snapshot result{};
+        for (std::size_t i = 0; i < PHASE_COUNT; ++i) {
+            result.phases.at(i) =
+              std::chrono::nanoseconds{phases_.at(i).load(std::memory_order_relaxed)};
+        }
+        for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+            result.counters.at(i) = counters_.at(i).load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    auto reset() noexcept -> void
+    {
+        for (auto& phase : phases_) {
+            phase.store(0, std::memory_order_relaxed);
+        }
+        for (auto& counter : counters_) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    std::atomic<bool> enabled_{false};
+    std::array<std::atomic<std::chrono::nanoseconds::rep>, PHASE_COUNT> phases_{};
+    std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> counters_{};
+
+    Registry() = default;
+    ~Registry() = default;
+};
+
+[[nodiscard]]
+inline auto enabled() noexcept -> bool
+{
+    return Registry::instance().enabled();
+}
+
+inline auto count(Counter counter, std::uint64_t amount = 1) noexcept -> void
+{
+    if constexpr (COMPILED) {
+        auto& registry = Registry::instance();
+        if (registry.enabled()) {
+            registry.add(counter, amount);
+        }
+    }
+}
+
+inline auto raise(Counter counter, std::uint64_t value) noexcept -> void
+{
+    if constexpr (COMPILED) {
+        auto& registry = Registry::instance();
+        if (registry.enabled()) {
+            registry.raise(counter, value);
+        }
+    }
+}
+
+/// @brief How a phase accounts for the phases timed while it runs.
+enum class Scope : std::uint8_t
+{
+    EXCLUSIVE, ///< Nested phases are charged to themselves and pause this one
+    INCLUSIVE, ///< Nested phases are charged to this one (verification re-lexes the output)
+};
+
+#ifdef VHDL_FMT_STATS
+
+/// @brief Charges the time until it goes out of scope to a phase.
+///
+/// Timers nest per thread. An exclusive timer pauses the timer it is nested in, so phases
+/// add up to the wall time of the thread and nothing is counted twice.
+class Timer final
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Timer(Phase phase, Scope scope = Scope::EXCLUSIVE) noexcept :
+      phase_{phase},
+      scope_{scope}
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        auto*& active = current();
+        if (active != nullptr && active->scope_ == Scope::INCLUSIVE) {
+            return;
+        }
+
+        since_ = Clock::now();
+        if (active != nullptr) {
+            active->charge(since_);
+        }
+
+        parent_ = active;
+        active = this;
+        running_ = true;
+    }
+
+    ~Timer()
+    {
+        if (!running_) {
+            return;
+        }
+
+        const auto now = Clock::now();
+        charge(now);
+
+        if (parent_ != nullptr) {
+            parent_->since_ = now;
+        }
+        current() = parent_;
+    }
+
+    Timer(const Timer&) = delete;
+    auto operator=(const Timer&) -> Timer& = delete;
+    Timer(Timer&&) = delete;
+    auto operator=(Timer&&) -> Timer& = delete;
+
+    /// @brief The phase being timed on this thread, if any.
+    [[nodiscard]]
+    static auto activePhase() noexcept -> std::optional<Phase>
+    {
+        const auto* active = current();
+        return active != nullptr ? std::optional{active->phase_} : std::nullopt;
+    }
+
+  private:
+    Phase phase_;
+    Scope scope_;
+    bool running_{false};
+    Clock::time_point since_{};
+    Timer* parent_{nullptr};
+
+    static auto current() noexcept -> Timer*&
+    {
+        thread_local Timer* active{nullptr};
+        return active;
+    }
+
+    auto charge(Clock::time_point now) noexcept -> void
+    {
+        Registry::instance().add(phase_, now - since_);
+        since_ = now;
+    }
+};
+
+#else
+
+class Timer final
+{
+  public:
+    explicit Timer(Phase /*phase*/, Scope /*scope*/ = Scope::EXCLUSIVE) noexcept {}
+
+    [[nodiscard]]
+    static auto activePhase() noexcept -> std::optional<Phase>
+    {
+        return std::nullopt;
+    }
+};
+
+#endif
+
+} // namespace common::stats
+
+#endif /* COMMON_STATS_HPP */
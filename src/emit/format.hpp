@@ -1,22 +1,109 @@
 #ifndef EMIT_FORMAT_HPP
 #define EMIT_FORMAT_HPP
 
+#include "common/cancellation.hpp"
 #include "common/config.hpp"
+#include "common/stats.hpp"
 #include "emit/pretty_printer.hpp"
 #include "emit/pretty_printer/renderer.hpp"
+#include "emit/pretty_printer/variants.hpp"
 #include "node.hpp"
 
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace emit {
 
+namespace detail {
+
+template<typename T>
+auto print(const T& root,
+           const common::CancellationToken& cancellation,
+           bool mark_sources,
+           common::LayoutMode layout)
+{
+    const common::stats::Timer timer{common::stats::Phase::DOC_BUILD};
+    auto doc = PrettyPrinter{cancellation, mark_sources, layout}.visit(root);
+
+    if (common::stats::enabled()) {
+        common::stats::raise(common::stats::Counter::DOC_MAX_DEPTH, depth(doc.getImpl()));
+    }
+
+    return doc;
+}
+
+} // namespace detail
+
 /// @brief High-level facade to format an AST node into a string.
+/// @throws common::Cancelled once the token is cancelled.
+template<typename T>
+    requires std::is_base_of_v<ast::NodeBase, T>
+auto format(const T& root,
+            const common::Config& config,
+            const common::CancellationToken& cancellation = {}) -> std::string
+{
+    const auto doc = detail::print(root, cancellation, false, config.layout);
+    return Renderer{config, cancellation}.render(doc);
+}
+
+/// @brief Formatted text along with the output span of every node that has a source span.
+struct Rendered final
+{
+    std::string text;
+    std::vector<OutputSpan> spans; ///< Innermost first
+};
+
+/// @brief Formats an AST node, recording which output range each node produced.
+/// @throws common::Cancelled once the token is cancelled.
+template<typename T>
+    requires std::is_base_of_v<ast::NodeBase, T>
+auto formatWithSpans(const T& root,
+                     const common::Config& config,
+                     const common::CancellationToken& cancellation = {}) -> Rendered
+{
+    const auto doc = detail::print(root, cancellation, true, config.layout);
+
+    Renderer renderer{config, cancellation};
+    auto text = renderer.render(doc);
+
+    return Rendered{.text = std::move(text), .spans = renderer.spans()};
+}
+
+/// @brief Formats an AST node and returns every decision the renderer took on a group, each
+///        with the innermost node around it.
+/// @throws common::Cancelled once the token is cancelled.
+template<typename T>
+    requires std::is_base_of_v<ast::NodeBase, T>
+auto explainLayout(const T& root,
+                   const common::Config& config,
+                   const common::CancellationToken& cancellation = {})
+  -> std::vector<LayoutDecision>
+{
+    const auto doc = detail::print(root, cancellation, true, config.layout);
+
+    std::vector<LayoutDecision> decisions{};
+    Renderer renderer{config, cancellation};
+    renderer.trace(decisions);
+    renderer.render(doc);
+
+    return decisions;
+}
+
+/// @brief Formats an AST node under several configurations, printing it only once.
+/// @param jobs Number of threads rendering the variants; 0 uses one per hardware thread.
+/// @throws common::Cancelled once the token is cancelled.
 template<typename T>
     requires std::is_base_of_v<ast::NodeBase, T>
-auto format(const T& root, const common::Config& config) -> std::string
+auto formatVariants(const T& root,
+                    std::span<const common::Config> configs,
+                    unsigned jobs = 1,
+                    const common::CancellationToken& cancellation = {}) -> std::vector<Variant>
 {
-    const auto doc = PrettyPrinter{}.visit(root);
-    return Renderer{config}.render(doc);
+    // Measured groups carry their widths, which then serve every configuration
+    const auto doc = detail::print(root, cancellation, false, common::LayoutMode::NETLIST);
+    return renderVariants(doc, configs, jobs, cancellation);
 }
 
 } // namespace emit
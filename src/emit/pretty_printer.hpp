@@ -14,6 +14,8 @@
 #include "ast/nodes/statements/waveform.hpp"
 #include "ast/nodes/types.hpp"
 #include "ast/visitor.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
 #include "emit/pretty_printer/doc.hpp"
 
 #include <algorithm>
@@ -41,7 +43,31 @@ concept IsExpression = std::is_same_v<T, ast::TokenExpr>
 
 class PrettyPrinter final : public ast::VisitorBase<Doc>
 {
+  public:
+    PrettyPrinter() = default;
+
+    /// @param mark_sources Tags the doc of every node with its source span, for renderers
+    ///        that need to map output back to the input (see Doc::mark).
+    explicit PrettyPrinter(bool mark_sources) : mark_sources_{mark_sources} {}
+
+    /// @param cancellation Polled once per node; visiting throws common::Cancelled once it is
+    ///        cancelled.
+    /// @param layout Whether groups are measured as they are built (see Doc::measuredGroup).
+    explicit PrettyPrinter(common::CancellationToken cancellation,
+                           bool mark_sources = false,
+                           common::LayoutMode layout = common::LayoutMode::AUTO)
+        : mark_sources_{mark_sources},
+          layout_{layout},
+          measured_groups_{layout == common::LayoutMode::NETLIST},
+          cancellation_{std::move(cancellation)}
+    {}
+
   private:
+    bool mark_sources_{false};
+    common::LayoutMode layout_{common::LayoutMode::AUTO};
+    mutable bool measured_groups_{false}; ///< Set while printing a netlist
+    common::CancellationToken cancellation_{};
+
     // clang-format off
     // Node visitors
     auto operator()(const ast::Architecture& node) const -> Doc;
@@ -119,6 +145,11 @@ class PrettyPrinter final : public ast::VisitorBase<Doc>
     template<typename T>
     auto wrapResult(const T& node, Doc result) const -> Doc
     {
+        cancellation_.poll();
+
+        if (mark_sources_) {
+            result = Doc::mark(result, node.span);
+        }
         return withTrivia(node, std::move(result), IsExpression<T>);
     }
 
@@ -132,6 +163,13 @@ class PrettyPrinter final : public ast::VisitorBase<Doc>
 
     // ---------------------- Helpers ----------------------
 
+    /// @brief Doc::group(), or Doc::measuredGroup() while printing a netlist.
+    [[nodiscard]]
+    auto group(const Doc& doc) const -> Doc
+    {
+        return measured_groups_ ? Doc::measuredGroup(doc) : Doc::group(doc);
+    }
+
     /// @brief Generic joiner: Applies a transform function to each item.
     template<std::ranges::input_range Range, typename Transform>
         requires requires(Transform& t, std::ranges::range_reference_t<Range> item) {
@@ -1,10 +1,12 @@
 #include "emit/pretty_printer/algorithms/alignment_resolver.hpp"
 
+#include "common/stats.hpp"
 #include "emit/pretty_printer/doc_impl.hpp"
 #include "emit/pretty_printer/walker.hpp"
 
 #include <algorithm>
 #include <cstddef>
+#include <memory>
 #include <span>
 #include <type_traits>
 #include <variant>
@@ -18,6 +20,9 @@ auto AlignmentResolver::resolve(const DocPtr& doc) -> DocPtr
         return doc;
     }
 
+    const common::stats::Timer timer{common::stats::Phase::ALIGN};
+    common::stats::count(common::stats::Counter::ALIGN_RESOLVES);
+
     // There will never be this many levels of alignment
     constexpr int MAX_LEVELS = 8;
     std::vector<int> widths{};
@@ -98,6 +103,8 @@ auto AlignmentResolver::apply(const DocPtr& doc, std::span<const int> widths) ->
             if (const int width = widths[level_idx]; width > 0) {
                 const int padding = width - static_cast<int>(node.content.length());
                 if (padding > 0) {
+                    // The leaf, its padding and the pair of them
+                    common::stats::count(common::stats::Counter::ALIGN_REBUILT_NODES, 3);
                     auto content = std::make_shared<DocImpl>(T{.content = node.content});
                     return makeConcat(
                       content, makeText(std::string(static_cast<std::size_t>(padding), ' ')));
@@ -108,6 +115,7 @@ auto AlignmentResolver::apply(const DocPtr& doc, std::span<const int> widths) ->
         }
 
         // 3. Recurse and Rebuild
+        common::stats::count(common::stats::Counter::ALIGN_REBUILT_NODES);
         return std::make_shared<DocImpl>(
           DocWalker::mapChildren(node, [&](const auto& c) { return apply(c, widths); }));
     };
@@ -115,4 +123,40 @@ auto AlignmentResolver::apply(const DocPtr& doc, std::span<const int> widths) ->
     return std::visit(visitor, doc->value);
 }
 
+ResolvedAlignments::ResolvedAlignments(const DocPtr& doc)
+{
+    collect(doc);
+}
+
+auto ResolvedAlignments::find(const DocPtr& align) const -> DocPtr
+{
+    const auto it = resolved_.find(align.get());
+    return it == resolved_.end() ? nullptr : it->second;
+}
+
+void ResolvedAlignments::collect(const DocPtr& doc)
+{
+    if (!doc) {
+        return;
+    }
+
+    if (const auto* align = std::get_if<Align>(&doc->value)) {
+        if (resolved_.contains(doc.get())) {
+            return;
+        }
+
+        // Resolving keeps nested scopes as they are, so they are found again in the result
+        auto resolved = AlignmentResolver::resolve(align->doc);
+        collect(resolved);
+        resolved_.emplace(doc.get(), std::move(resolved));
+        return;
+    }
+
+    std::visit(
+      [this](const auto& node) {
+          DocWalker::traverseChildren(node, [this](const DocPtr& child) { collect(child); });
+      },
+      doc->value);
+}
+
 } // namespace emit
@@ -4,6 +4,7 @@
 #include "emit/pretty_printer/doc.hpp"
 
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace emit {
@@ -24,6 +25,26 @@ class AlignmentResolver
     static auto apply(const DocPtr& doc, std::span<const int> widths) -> DocPtr;
 };
 
+/// @brief The resolved document of every alignment scope in a document, so that several
+///        renders of it resolve each scope once. Read-only once built, so renders on
+///        different threads can share it.
+class ResolvedAlignments final
+{
+  public:
+    ResolvedAlignments() = default;
+
+    explicit ResolvedAlignments(const DocPtr& doc);
+
+    /// @brief The resolved document of an Align node of the document, or null for any other.
+    [[nodiscard]]
+    auto find(const DocPtr& align) const -> DocPtr;
+
+  private:
+    std::unordered_map<const DocImpl*, DocPtr> resolved_{};
+
+    auto collect(const DocPtr& doc) -> void;
+};
+
 } // namespace emit
 
 #endif // EMIT_PRETTY_PRINTER_ALGORITHMS_ALIGNMENT_RESOLVER_HPP
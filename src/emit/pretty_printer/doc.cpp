@@ -1,7 +1,10 @@
 #include "emit/pretty_printer/doc.hpp"
 
+#include "ast/node.hpp"
+#include "common/config.hpp"
 #include "emit/pretty_printer/doc_impl.hpp"
 
+#include <limits>
 #include <string_view>
 #include <variant>
 
@@ -145,11 +148,30 @@ auto Doc::group(const Doc& doc) -> Doc
     return Doc(makeUnion(flatten(doc.impl_), doc.impl_));
 }
 
+auto Doc::measuredGroup(const Doc& doc) -> Doc
+{
+    // Wide enough for any configurable line length
+    constexpr int BUDGET{std::numeric_limits<decltype(common::LineConfig::line_length)>::max()};
+
+    const int remaining = measureFlat(BUDGET, doc.impl_);
+    return Doc(makeMeasuredUnion(doc.impl_, remaining < 0 ? BUDGET + 1 : BUDGET - remaining));
+}
+
 auto Doc::hang(const Doc& doc) -> Doc
 {
     return Doc(makeHang(doc.impl_));
 }
 
+auto Doc::mark(const Doc& doc, const ast::SourceSpan& source) -> Doc
+{
+    // Keeps isEmpty() intact for the joiners
+    if (doc.isEmpty() || source.empty()) {
+        return doc;
+    }
+
+    return Doc(makeMark(source, doc.impl_));
+}
+
 // =======================================================================
 // Utilities
 // ========================================================================
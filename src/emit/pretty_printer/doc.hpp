@@ -6,6 +6,10 @@
 #include <utility>
 
 // Forward declarations
+namespace ast {
+struct SourceSpan;
+} // namespace ast
+
 namespace common {
 struct Config;
 } // namespace common
@@ -112,6 +116,14 @@ class Doc final
     [[nodiscard]]
     static auto group(const Doc& doc) -> Doc;
 
+    /// @brief Groups a document without building its flat version.
+    /// @note The flat width is measured once here, reusing the widths of nested measured
+    ///       groups, so the renderer decides the group in constant time and lays the flat
+    ///       version out from the broken one. Lays out like group() unless an alignment
+    ///       scope encloses the group.
+    [[nodiscard]]
+    static auto measuredGroup(const Doc& doc) -> Doc;
+
     /// @brief A common "bracket" pattern: (left, inner, right).
     /// @note This is equivalent to `(left << inner) / right`.
     [[nodiscard]]
@@ -130,6 +142,12 @@ class Doc final
     [[nodiscard]]
     static auto hang(const Doc& doc) -> Doc;
 
+    /// @brief Tags a document with the source span it was printed from, so the renderer
+    ///        can report which output range it produced.
+    /// @return The document itself if it or the span is empty, otherwise a `Mark` node.
+    [[nodiscard]]
+    static auto mark(const Doc& doc, const ast::SourceSpan& source) -> Doc;
+
     // ========================================================================
     // Utility
     // ========================================================================
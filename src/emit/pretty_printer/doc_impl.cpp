@@ -1,57 +1,169 @@
 #include "emit/pretty_printer/doc_impl.hpp"
 
+#include "common/overload.hpp"
+#include "common/stats.hpp"
 #include "emit/pretty_printer/doc.hpp"
 #include "emit/pretty_printer/walker.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 
 namespace emit {
 
+namespace {
+
+using common::stats::Counter;
+
+static_assert(std::variant_size_v<decltype(DocImpl::value)>
+                == static_cast<std::size_t>(Counter::DOC_MARK)
+                     - static_cast<std::size_t>(Counter::DOC_EMPTY) + 1,
+              "One --stats counter per kind of document node");
+
+// The factories allocate through here, so that --stats can count document nodes
+template<typename Node>
+auto allocate(Node&& node) -> DocPtr
+{
+    auto doc = std::make_shared<DocImpl>(std::forward<Node>(node));
+
+    if (common::stats::enabled()) {
+        common::stats::count(Counter::DOC_NODES);
+        common::stats::count(static_cast<Counter>(static_cast<std::size_t>(Counter::DOC_EMPTY)
+                                                  + doc->value.index()));
+    }
+
+    return doc;
+}
+
+// measureFlat(), counting the nodes it visits
+auto measureFlat(int width, const DocPtr& doc, std::uint64_t& visited) -> int
+{
+    if (!doc) {
+        return width;
+    }
+    if (width < 0) {
+        return -1;
+    }
+
+    ++visited;
+
+    auto fits_visitor = common::Overload{
+      // Empty
+      [&](const Empty&) -> int { return width; },
+
+      // Text
+      [&](const Text& node) -> int { return width - static_cast<int>(node.content.length()); },
+
+      // Keyword
+      [&](const Keyword& node) -> int { return width - static_cast<int>(node.content.length()); },
+
+      // SoftLine (becomes space)
+      [&](const SoftLine&) -> int { return width - 1; },
+
+      // Concat (threads remaining width)
+      [&](const Concat& node) -> int {
+          const int remaining = measureFlat(width, node.left, visited);
+          if (remaining < 0) {
+              return -1;
+          }
+          return measureFlat(remaining, node.right, visited);
+      },
+
+      // Nest, Align, Union (Recursive call)
+      [&](const Nest& node) -> int { return measureFlat(width, node.doc, visited); },
+      [&](const Hang& node) -> int { return measureFlat(width, node.doc, visited); },
+      [&](const Align& node) -> int { return measureFlat(width, node.doc, visited); },
+      [&](const Mark& node) -> int { return measureFlat(width, node.doc, visited); },
+      [&](const Union& node) -> int {
+          // Check flat version only for fitting
+          if (node.width >= 0) {
+              return node.width <= width ? width - node.width : -1;
+          }
+          return measureFlat(width, node.flat ? node.flat : node.broken, visited);
+      },
+
+      // All others (HardLine, HardLines) do not fit
+      [](const HardLine&) -> int { return -1; },
+      [](const HardLines&) -> int { return -1; },
+    };
+
+    return std::visit(fits_visitor, doc->value);
+}
+
+auto depth(const DocPtr& doc, std::unordered_map<const DocImpl*, std::size_t>& known)
+  -> std::size_t
+{
+    if (!doc) {
+        return 0;
+    }
+
+    // Documents share subdocuments, so each is measured once
+    if (const auto it = known.find(doc.get()); it != known.end()) {
+        return it->second;
+    }
+
+    std::size_t deepest{0};
+    std::visit(
+      [&](const auto& node) {
+          DocWalker::traverseChildren(node, [&](const DocPtr& child) {
+              deepest = std::max(deepest, depth(child, known));
+          });
+      },
+      doc->value);
+
+    known.emplace(doc.get(), deepest + 1);
+    return deepest + 1;
+}
+
+} // namespace
+
 // Factory functions
 auto makeEmpty() -> DocPtr
 {
-    return std::make_shared<DocImpl>(Empty{});
+    return allocate(Empty{});
 }
 
 auto makeText(std::string_view text) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Text{.content = std::string{text}});
+    return allocate(Text{.content = std::string{text}});
 }
 
 auto makeText(std::string_view text, int level) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Text{.content = std::string{text}, .level = level});
+    return allocate(Text{.content = std::string{text}, .level = level});
 }
 
 auto makeKeyword(std::string_view text) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Keyword{.content = std::string{text}});
+    return allocate(Keyword{.content = std::string{text}});
 }
 
 auto makeKeyword(std::string_view text, int level) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Keyword{.content = std::string{text}, .level = level});
+    return allocate(Keyword{.content = std::string{text}, .level = level});
 }
 
 auto makeLine() -> DocPtr
 {
-    return std::make_shared<DocImpl>(SoftLine{});
+    return allocate(SoftLine{});
 }
 
 auto makeHardLine() -> DocPtr
 {
-    return std::make_shared<DocImpl>(HardLine{});
+    return allocate(HardLine{});
 }
 
 auto makeHardLines(unsigned count) -> DocPtr
 {
-    return std::make_shared<DocImpl>(HardLines{count});
+    return allocate(HardLines{count});
 }
 
 auto makeConcat(DocPtr left, DocPtr right) -> DocPtr
@@ -98,27 +210,38 @@ auto makeConcat(DocPtr left, DocPtr right) -> DocPtr
     }
 
     // === Fallback: Actually create the Concat node ===
-    return std::make_shared<DocImpl>(Concat{.left = std::move(left), .right = std::move(right)});
+    return allocate(Concat{.left = std::move(left), .right = std::move(right)});
 }
 
 auto makeNest(DocPtr doc) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Nest{.doc = std::move(doc)});
+    return allocate(Nest{.doc = std::move(doc)});
 }
 
 auto makeHang(DocPtr doc) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Hang{.doc = std::move(doc)});
+    return allocate(Hang{.doc = std::move(doc)});
 }
 
 auto makeUnion(DocPtr flat, DocPtr broken) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Union{.flat = std::move(flat), .broken = std::move(broken)});
+    return allocate(Union{.flat = std::move(flat), .broken = std::move(broken)});
+}
+
+auto makeMeasuredUnion(DocPtr broken, int width) -> DocPtr
+{
+    return allocate(
+      Union{.flat = nullptr, .broken = std::move(broken), .width = width});
 }
 
 auto makeAlign(DocPtr doc) -> DocPtr
 {
-    return std::make_shared<DocImpl>(Align{.doc = std::move(doc)});
+    return allocate(Align{.doc = std::move(doc)});
+}
+
+auto makeMark(const ast::SourceSpan& source, DocPtr doc) -> DocPtr
+{
+    return allocate(Mark{.source = source, .doc = std::move(doc)});
 }
 
 // Utility functions
@@ -135,10 +258,11 @@ auto flatten(const DocPtr& doc) -> DocPtr
         if constexpr (std::is_same_v<T, SoftLine>) {
             return makeText(" ", -1);
         }
-        // Unwrap Unions (Pick the pre-flattened branch)
+        // Unwrap Unions (Pick the pre-flattened branch, or the broken one that was just
+        // flattened for a measured group)
         else if constexpr (std::is_same_v<T, Union>)
         {
-            return node.flat;
+            return node.flat ? node.flat : node.broken;
         }
         // Unwrap Align scopes
         else if constexpr (std::is_same_v<T, Align>)
@@ -147,9 +271,30 @@ auto flatten(const DocPtr& doc) -> DocPtr
         }
         // Default: Pass everything else through (Concat, Text, HardLine, etc.)
         else {
-            return std::make_shared<DocImpl>(std::forward<decltype(node)>(node));
+            return allocate(std::forward<decltype(node)>(node));
         }
     });
 }
 
+// Simulates flattened rendering: the width left after the document, or -1 if it does not fit
+auto measureFlat(int width, const DocPtr& doc) -> int
+{
+    std::uint64_t visited{0};
+    const auto remaining = measureFlat(width, doc, visited);
+
+    if (common::stats::enabled()) {
+        common::stats::count(Counter::FITS_CALLS);
+        common::stats::count(Counter::FITS_NODES, visited);
+    }
+
+    return remaining;
+}
+
+// Nesting depth of the document, as the renderer follows it (broken side of every group)
+auto depth(const DocPtr& doc) -> std::size_t
+{
+    std::unordered_map<const DocImpl*, std::size_t> known{};
+    return depth(doc, known);
+}
+
 } // namespace emit
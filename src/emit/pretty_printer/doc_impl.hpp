@@ -1,6 +1,9 @@
 #ifndef EMIT_DOC_IMPL_HPP
 #define EMIT_DOC_IMPL_HPP
 
+#include "ast/node.hpp"
+
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -65,8 +68,9 @@ struct Hang
 /// Choice between flat and broken layout
 struct Union
 {
-    DocPtr flat;
-    DocPtr broken;
+    DocPtr flat;   ///< Null for a measured group, which renders `broken` flat instead
+    DocPtr broken; ///< Layout used when the group does not fit
+    int width{-1}; ///< Flat width measured when the group was built, -1 if unknown
 };
 
 struct Align
@@ -74,12 +78,29 @@ struct Align
     DocPtr doc;
 };
 
+/// Records which output range the document of an AST node rendered to
+struct Mark
+{
+    ast::SourceSpan source;
+    DocPtr doc;
+};
+
 /// Internal document representation using variant
 struct DocImpl
 {
-    std::
-      variant<Empty, Text, Keyword, SoftLine, HardLine, HardLines, Concat, Nest, Hang, Union, Align>
-        value;
+    std::variant<Empty,
+                 Text,
+                 Keyword,
+                 SoftLine,
+                 HardLine,
+                 HardLines,
+                 Concat,
+                 Nest,
+                 Hang,
+                 Union,
+                 Align,
+                 Mark>
+      value;
 };
 
 // Factory functions for creating documents
@@ -95,11 +116,15 @@ auto makeConcat(DocPtr left, DocPtr right) -> DocPtr;
 auto makeNest(DocPtr doc) -> DocPtr;
 auto makeHang(DocPtr doc) -> DocPtr;
 auto makeUnion(DocPtr flat, DocPtr broken) -> DocPtr;
+auto makeMeasuredUnion(DocPtr broken, int width) -> DocPtr;
 auto makeAlignText(DocPtr doc) -> DocPtr;
 auto makeAlign(DocPtr doc) -> DocPtr;
+auto makeMark(const ast::SourceSpan& source, DocPtr doc) -> DocPtr;
 
 // Utility functions
 auto flatten(const DocPtr& doc) -> DocPtr;
+auto measureFlat(int width, const DocPtr& doc) -> int;
+auto depth(const DocPtr& doc) -> std::size_t;
 auto resolveAlignment(const DocPtr& doc) -> DocPtr;
 
 } // namespace emit
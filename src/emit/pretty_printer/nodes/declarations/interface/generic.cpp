@@ -24,7 +24,7 @@ auto PrettyPrinter::operator()(const ast::GenericClause& node) const -> Doc
 
     const Doc result = Doc::align(generics);
 
-    return Doc::group(Doc::bracket(opener, result, closer));
+    return group(Doc::bracket(opener, result, closer));
 }
 
 auto PrettyPrinter::operator()(const ast::GenericParam& node, const bool is_last) const -> Doc
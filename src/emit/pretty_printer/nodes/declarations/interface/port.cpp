@@ -24,7 +24,7 @@ auto PrettyPrinter::operator()(const ast::PortClause& node) const -> Doc
 
     const Doc result = Doc::align(ports);
 
-    return Doc::group(Doc::bracket(opener, result, closer));
+    return group(Doc::bracket(opener, result, closer));
 }
 
 auto PrettyPrinter::operator()(const ast::Port& node, const bool is_last) const -> Doc
@@ -1,14 +1,48 @@
 #include "ast/nodes/design_units.hpp"
+#include "ast/nodes/statements.hpp"
+#include "ast/nodes/statements/concurrent.hpp"
+#include "common/config.hpp"
 #include "emit/pretty_printer.hpp"
 #include "emit/pretty_printer/doc.hpp"
 
 #include <algorithm>
+#include <cstddef>
 #include <optional>
+#include <variant>
 
 namespace emit {
 
+namespace {
+
+// Generated netlists: hundreds of statements, nearly all of them plain assignments
+constexpr std::size_t NETLIST_MIN_STATEMENTS{256};
+constexpr std::size_t NETLIST_MIN_PERCENT{90};
+
+auto looksGenerated(const ast::Architecture& node) -> bool
+{
+    if (node.stmts.size() < NETLIST_MIN_STATEMENTS) {
+        return false;
+    }
+
+    const auto assignments =
+      std::ranges::count_if(node.stmts, [](const ast::ConcurrentStatement& stmt) -> bool {
+          const auto* assign = std::get_if<ast::ConditionalConcurrentAssign>(&stmt.kind);
+          return assign != nullptr
+              && assign->waveforms.size() == 1
+              && !assign->waveforms.front().condition.has_value();
+      });
+
+    return static_cast<std::size_t>(assignments) * 100 >= node.stmts.size() * NETLIST_MIN_PERCENT;
+}
+
+} // namespace
+
 auto PrettyPrinter::operator()(const ast::Architecture& node) const -> Doc
 {
+    const bool enclosing = measured_groups_;
+    measured_groups_ = layout_ == common::LayoutMode::NETLIST
+                    || (layout_ == common::LayoutMode::AUTO && looksGenerated(node));
+
     // Emit architecture declaration
     Doc result = Doc::keyword("architecture")
                & Doc::text(node.name)
@@ -37,6 +71,7 @@ auto PrettyPrinter::operator()(const ast::Architecture& node) const -> Doc
     }
     end_line += Doc::text(";");
 
+    measured_groups_ = enclosing;
     return result / end_line;
 }
 
@@ -28,7 +28,7 @@ auto PrettyPrinter::operator()(const ast::ConditionalConcurrentAssign& node) con
     // If it breaks, the next line starts at the hung indent level.
     const Doc waveforms = join(node.waveforms, Doc::text(" ") + Doc::keyword("else") + Doc::line());
 
-    const Doc assignment = Doc::group(target & Doc::hang(waveforms)) + Doc::text(";");
+    const Doc assignment = group(target & Doc::hang(waveforms)) + Doc::text(";");
 
     return result.isEmpty() ? assignment : result & assignment;
 }
@@ -56,7 +56,7 @@ auto PrettyPrinter::operator()(const ast::SelectedConcurrentAssign& node) const
 
     // For selected assignment, the target itself is nested under the header,
     // and the selections hang off the target.
-    const Doc assignment = Doc::group(header / (target & Doc::hang(selections)) + Doc::text(";"));
+    const Doc assignment = group(header / (target & Doc::hang(selections)) + Doc::text(";"));
 
     return result.isEmpty() ? assignment : result & assignment;
 }
@@ -11,14 +11,14 @@ auto PrettyPrinter::operator()(const ast::SignalAssign& node) const -> Doc
 {
     const Doc wave = visit(node.waveform);
 
-    return Doc::group(visit(node.target) & Doc::text("<=") & Doc::hang(wave)) + Doc::text(";");
+    return group(visit(node.target) & Doc::text("<=") & Doc::hang(wave)) + Doc::text(";");
 }
 
 auto PrettyPrinter::operator()(const ast::VariableAssign& node) const -> Doc
 {
     const Doc val = visit(node.value);
 
-    return Doc::group(visit(node.target) & Doc::text(":=") & Doc::hang(val)) + Doc::text(";");
+    return group(visit(node.target) & Doc::text(":=") & Doc::hang(val)) + Doc::text(";");
 }
 
 } // namespace emit
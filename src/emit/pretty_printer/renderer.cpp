@@ -2,12 +2,15 @@
 
 #include "common/config.hpp"
 #include "common/overload.hpp"
+#include "common/stats.hpp"
 #include "emit/pretty_printer/algorithms/alignment_resolver.hpp"
 #include "emit/pretty_printer/doc.hpp"
 #include "emit/pretty_printer/doc_impl.hpp"
 
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <ranges>
 #include <string>
 #include <utility>
@@ -15,13 +18,37 @@
 
 namespace emit {
 
+namespace {
+
+// Width of a document printed flat, -1 if it cannot be; only measured for traces
+auto flatWidth(const DocPtr& doc) -> int
+{
+    constexpr int LIMIT{std::numeric_limits<std::uint16_t>::max()};
+    const int remaining = measureFlat(LIMIT, doc);
+    return remaining < 0 ? -1 : LIMIT - remaining;
+}
+
+} // namespace
+
 auto Renderer::render(const Doc& doc) -> std::string
 {
+    const common::stats::Timer timer{common::stats::Phase::RENDER};
+
     output_.clear();
+    spans_.clear();
     column_ = 0;
+    line_ = 0;
+    decisions_ = {};
 
     renderDoc(0, Mode::BREAK, doc.getImpl());
 
+    if (common::stats::enabled()) {
+        using common::stats::Counter;
+        common::stats::count(Counter::UNION_DECISIONS, decisions_.flat + decisions_.broken);
+        common::stats::count(Counter::UNION_FLAT, decisions_.flat);
+        common::stats::count(Counter::UNION_BROKEN, decisions_.broken);
+    }
+
     return std::move(output_);
 }
 
@@ -31,6 +58,8 @@ void Renderer::renderDoc(int indent, Mode mode, const DocPtr& doc)
         return;
     }
 
+    cancellation_.poll();
+
     auto render_visitor = common::Overload{
       // Empty produces nothing
       [](const Empty&) -> void {},
@@ -85,17 +114,49 @@ void Renderer::renderDoc(int indent, Mode mode, const DocPtr& doc)
 
       [&](const Hang& node) -> void { renderDoc(column_, mode, node.doc); },
 
-      // Align (conditional pre-processing)
+      // Align (conditional pre-processing; flattened documents are not aligned)
       [&](const Align& node) -> void {
-          renderDoc(indent, mode, AlignmentResolver::resolve(node.doc));
+          renderDoc(indent, mode, mode == Mode::FLAT ? node.doc : resolve(doc, node));
+      },
+
+      // Mark (records the output range of its document)
+      [&](const Mark& node) -> void {
+          const auto begin = output_.size();
+          const auto* const outer = std::exchange(mark_, &node.source);
+          renderDoc(indent, mode, node.doc);
+          mark_ = outer;
+          spans_.push_back(
+            OutputSpan{.source = node.source, .begin = begin, .end = output_.size()});
       },
 
       // Union (decision point)
       [&](const Union& node) -> void {
+          // A measured group has no flat version; its broken one renders flat just the same
+          const auto& flat = node.flat ? node.flat : node.broken;
+          if (mode == Mode::FLAT) {
+              renderDoc(indent, Mode::FLAT, flat);
+              return;
+          }
+
           // Decide: use flat or broken layout?
-          if (mode == Mode::FLAT || fits(config_.line_config.line_length - column_, node.flat)) {
+          const int remaining = config_.line_config.line_length - column_;
+          const bool fits_flat =
+            node.width >= 0 ? node.width <= remaining : fits(remaining, flat);
+
+          ++(fits_flat ? decisions_.flat : decisions_.broken);
+          if (trace_ != nullptr) {
+              trace_->push_back(
+                LayoutDecision{.source = mark_ != nullptr ? *mark_ : ast::SourceSpan{},
+                               .line = line_,
+                               .column = column_,
+                               .width = node.width >= 0 ? node.width : flatWidth(flat),
+                               .remaining = remaining,
+                               .flat = fits_flat});
+          }
+
+          if (fits_flat) {
               // Fits on current line - use flat version
-              renderDoc(indent, Mode::FLAT, node.flat);
+              renderDoc(indent, Mode::FLAT, flat);
           } else {
               // Doesn't fit - use broken version
               renderDoc(indent, Mode::BREAK, node.broken);
@@ -105,59 +166,21 @@ void Renderer::renderDoc(int indent, Mode mode, const DocPtr& doc)
     std::visit(render_visitor, doc->value);
 }
 
-// Check if document fits on current line
-auto Renderer::fits(int width, const DocPtr& doc) -> bool
-{
-    return fitsImpl(width, doc) >= 0;
-}
-
-// Helper: simulate flattened rendering and return remaining width
-auto Renderer::fitsImpl(int width, const DocPtr& doc) -> int
+auto Renderer::resolve(const DocPtr& align, const Align& node) const -> DocPtr
 {
-    if (!doc) {
-        return width;
+    if (alignments_ != nullptr) {
+        if (auto resolved = alignments_->find(align)) {
+            return resolved;
+        }
     }
-    if (width < 0) {
-        return -1;
-    }
-
-    auto fits_visitor = common::Overload{
-      // Empty
-      [&](const Empty&) -> int { return width; },
-
-      // Text
-      [&](const Text& node) -> int { return width - static_cast<int>(node.content.length()); },
-
-      // Keyword
-      [&](const Keyword& node) -> int { return width - static_cast<int>(node.content.length()); },
-
-      // SoftLine (becomes space)
-      [&](const SoftLine&) -> int { return width - 1; },
 
-      // Concat (threads remaining width)
-      [&](const Concat& node) -> int {
-          const int remaining = fitsImpl(width, node.left);
-          if (remaining < 0) {
-              return -1;
-          }
-          return fitsImpl(remaining, node.right);
-      },
-
-      // Nest, Align, Union (Recursive call)
-      [&](const Nest& node) -> int { return fitsImpl(width, node.doc); },
-      [&](const Hang& node) -> int { return fitsImpl(width, node.doc); },
-      [&](const Align& node) -> int { return fitsImpl(width, node.doc); },
-      [&](const Union& node) -> int {
-          // Check flat version only for fitting
-          return fitsImpl(width, node.flat);
-      },
-
-      // All others (HardLine, HardLines) do not fit
-      [](const HardLine&) -> int { return -1; },
-      [](const HardLines&) -> int { return -1; },
-    };
+    return AlignmentResolver::resolve(node.doc);
+}
 
-    return std::visit(fits_visitor, doc->value);
+// Check if document fits on current line
+auto Renderer::fits(int width, const DocPtr& doc) -> bool
+{
+    return measureFlat(width, doc) >= 0;
 }
 
 // Output helpers
@@ -172,6 +195,7 @@ void Renderer::newline(int indent)
     output_ += '\n';
     output_.append(static_cast<std::size_t>(indent), ' ');
     column_ = indent;
+    ++line_;
 }
 
 } // namespace emit
@@ -1,12 +1,18 @@
 #ifndef EMIT_RENDERER_HPP
 #define EMIT_RENDERER_HPP
 
+#include "ast/node.hpp"
+#include "common/cancellation.hpp"
+#include "emit/pretty_printer/algorithms/alignment_resolver.hpp"
 #include "emit/pretty_printer/doc.hpp"
 #include "emit/pretty_printer/doc_impl.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace common {
 struct Config;
@@ -21,12 +27,46 @@ enum class Mode : std::uint8_t
     BREAK,
 };
 
+/// Output range that a marked document (see Doc::mark) rendered to
+struct OutputSpan
+{
+    ast::SourceSpan source;
+    std::size_t begin;
+    std::size_t end;
+};
+
+/// A group the renderer decided to print flat or broken, recorded by a traced render
+struct LayoutDecision
+{
+    ast::SourceSpan source; ///< Innermost marked document around the group, empty if none
+    std::size_t line;       ///< Output line the group starts on, from 0
+    int column;             ///< Column the group starts at
+    int width;              ///< Width of the group printed flat, -1 if it cannot be flat
+    int remaining;          ///< Room left on the line
+    bool flat;
+};
+
 /// Renderer for the pretty printer
 class Renderer final
 {
   public:
     explicit Renderer(const common::Config& config) : config_{config} {}
 
+    // Polls the token while rendering; render() throws common::Cancelled once it is cancelled
+    Renderer(const common::Config& config, common::CancellationToken cancellation)
+        : config_{config},
+          cancellation_{std::move(cancellation)}
+    {}
+
+    // Takes alignment scopes from `alignments` instead of resolving them on every render
+    Renderer(const common::Config& config,
+             common::CancellationToken cancellation,
+             const ResolvedAlignments& alignments)
+        : config_{config},
+          cancellation_{std::move(cancellation)},
+          alignments_{&alignments}
+    {}
+
     ~Renderer() = default;
 
     Renderer(const Renderer&) = delete;
@@ -37,6 +77,19 @@ class Renderer final
     // Core rendering function
     auto render(const Doc& doc) -> std::string;
 
+    // Records every group decided in break mode to `decisions` while rendering
+    auto trace(std::vector<LayoutDecision>& decisions) -> void
+    {
+        trace_ = &decisions;
+    }
+
+    // Output spans of the marked documents of the last render, innermost first
+    [[nodiscard]]
+    auto spans() const -> const std::vector<OutputSpan>&
+    {
+        return spans_;
+    }
+
   private:
     // Internal rendering using visitor pattern
     auto renderDoc(int indent, Mode mode, const DocPtr& doc) -> void;
@@ -44,17 +97,32 @@ class Renderer final
     // Check if document fits on current line
     static auto fits(int width, const DocPtr& doc) -> bool;
 
-    // Helper for fits: returns remaining width, or -1 if doesn't fit
-    static auto fitsImpl(int width, const DocPtr& doc) -> int;
-
     // Output helpers
     auto write(std::string_view text) -> void;
     auto newline(int indent) -> void;
 
+    // Group decisions of the current render, for --stats
+    struct Decisions
+    {
+        std::uint64_t flat{0};
+        std::uint64_t broken{0};
+    };
+
     // Member variables
     int column_{0};
+    std::size_t line_{0};
     std::string output_;
+    std::vector<OutputSpan> spans_;
     const common::Config& config_;
+    common::CancellationToken cancellation_{};
+    const ResolvedAlignments* alignments_{nullptr};
+    Decisions decisions_{};
+    const ast::SourceSpan* mark_{nullptr}; // Innermost marked document being rendered
+    std::vector<LayoutDecision>* trace_{nullptr};
+
+    // The resolved document of an alignment scope
+    [[nodiscard]]
+    auto resolve(const DocPtr& align, const Align& node) const -> DocPtr;
 };
 
 } // namespace emit
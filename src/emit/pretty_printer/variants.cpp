@@ -0,0 +1,98 @@
+#include "emit/pretty_printer/variants.hpp"
+
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "emit/pretty_printer/algorithms/alignment_resolver.hpp"
+#include "emit/pretty_printer/doc.hpp"
+#include "emit/pretty_printer/renderer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace emit {
+
+namespace {
+
+auto measure(std::string text, const common::Config& config) -> Variant
+{
+    Variant variant{};
+
+    std::string_view rest{text};
+    while (!rest.empty()) {
+        const auto newline = rest.find('\n');
+        const auto line = rest.substr(0, newline);
+
+        ++variant.lines;
+        if (line.size() > config.line_config.line_length) {
+            ++variant.overflows;
+        }
+
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+    }
+
+    variant.text = std::move(text);
+    return variant;
+}
+
+} // namespace
+
+auto renderVariants(const Doc& doc,
+                    std::span<const common::Config> configs,
+                    unsigned jobs,
+                    const common::CancellationToken& cancellation) -> std::vector<Variant>
+{
+    const ResolvedAlignments alignments{doc.getImpl()};
+    std::vector<Variant> variants(configs.size());
+
+    const auto workers = std::min<std::size_t>(
+      configs.size(), jobs != 0 ? jobs : std::max(1U, std::thread::hardware_concurrency()));
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr failure{};
+    std::mutex failure_mutex{};
+
+    const auto work = [&] {
+        try {
+            for (auto k = next++; k < configs.size(); k = next++) {
+                const auto& config = configs.subspan(k).front();
+                Renderer renderer{config, cancellation, alignments};
+                variants.at(k) = measure(renderer.render(doc), config);
+            }
+        }
+        catch (...) {
+            // Stop the other workers too; the first failure is rethrown
+            next = configs.size();
+            const std::scoped_lock lock{failure_mutex};
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    if (workers <= 1) {
+        work();
+    } else {
+        std::vector<std::jthread> pool{};
+        pool.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            pool.emplace_back(work);
+        }
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    return variants;
+}
+
+} // namespace emit
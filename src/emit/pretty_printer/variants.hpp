@@ -0,0 +1,40 @@
+#ifndef EMIT_PRETTY_PRINTER_VARIANTS_HPP
+#define EMIT_PRETTY_PRINTER_VARIANTS_HPP
+
+#include "common/cancellation.hpp"
+#include "emit/pretty_printer/doc.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace common {
+struct Config;
+} // namespace common
+
+namespace emit {
+
+/// @brief A document rendered under one configuration.
+struct Variant final
+{
+    std::string text;
+    std::size_t lines{0};     ///< Number of lines in the text
+    std::size_t overflows{0}; ///< Lines longer than the configured line length
+};
+
+/// @brief Renders one document under every configuration, in the order given.
+/// @note The document does not depend on the configuration, only its rendering does, so
+///       alignment scopes are resolved once and shared by every render. Build the document
+///       with measured groups (see Doc::measuredGroup) to share group widths as well.
+/// @param jobs Number of threads; 0 uses one per hardware thread.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto renderVariants(const Doc& doc,
+                    std::span<const common::Config> configs,
+                    unsigned jobs = 1,
+                    const common::CancellationToken& cancellation = {}) -> std::vector<Variant>;
+
+} // namespace emit
+
+#endif // EMIT_PRETTY_PRINTER_VARIANTS_HPP
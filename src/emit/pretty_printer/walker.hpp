@@ -24,9 +24,12 @@ struct DocWalker
         if constexpr (std::is_same_v<T, Concat>) {
             return Concat{.left = fn(node.left), .right = fn(node.right)};
         } else if constexpr (std::is_same_v<T, Union>) {
+            // The measured width no longer holds once the children change
             return Union{.flat = fn(node.flat), .broken = fn(node.broken)};
         } else if constexpr (IS_ANY_OF_V<T, Nest, Hang, Align>) {
             return T{.doc = fn(node.doc)};
+        } else if constexpr (std::is_same_v<T, Mark>) {
+            return Mark{.source = node.source, .doc = fn(node.doc)};
         } else {
             return node;
         }
@@ -43,7 +46,7 @@ struct DocWalker
             return fn(node.right, std::move(init));
         } else if constexpr (std::is_same_v<T, Union>) {
             return fn(node.broken, std::move(init));
-        } else if constexpr (IS_ANY_OF_V<T, Nest, Hang, Align>) {
+        } else if constexpr (IS_ANY_OF_V<T, Nest, Hang, Align, Mark>) {
             return fn(node.doc, std::move(init));
         } else {
             return init;
@@ -62,7 +65,7 @@ struct DocWalker
         } else if constexpr (std::is_same_v<T, Union>) {
             // Standard traversal typically follows the 'broken' (expanded) path
             fn(node.broken);
-        } else if constexpr (IS_ANY_OF_V<T, Nest, Hang, Align>) {
+        } else if constexpr (IS_ANY_OF_V<T, Nest, Hang, Align, Mark>) {
             fn(node.doc);
         }
         // Leaf nodes (Text, Empty, etc.) have no children to traverse
@@ -0,0 +1,316 @@
+#include "lsp/document.hpp"
+
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lsp {
+
+namespace {
+
+/// @brief Byte length of the UTF-8 sequence introduced by `lead`.
+auto sequenceLength(unsigned char lead) -> std::size_t
+{
+    constexpr unsigned char ASCII_END = 0x80U;
+    constexpr unsigned char TWO_MASK = 0xE0U;
+    constexpr unsigned char TWO_BITS = 0xC0U;
+    constexpr unsigned char THREE_MASK = 0xF0U;
+    constexpr unsigned char THREE_BITS = 0xE0U;
+    constexpr unsigned char FOUR_MASK = 0xF8U;
+    constexpr unsigned char FOUR_BITS = 0xF0U;
+
+    if (lead < ASCII_END) {
+        return 1;
+    }
+    if ((lead & TWO_MASK) == TWO_BITS) {
+        return 2;
+    }
+    if ((lead & THREE_MASK) == THREE_BITS) {
+        return 3;
+    }
+    if ((lead & FOUR_MASK) == FOUR_BITS) {
+        return 4;
+    }
+
+    // Stray continuation byte: count it on its own
+    return 1;
+}
+
+/// @brief Width of one code point in the given encoding.
+auto width(std::size_t sequence_length, PositionEncoding encoding) -> std::size_t
+{
+    if (encoding == PositionEncoding::UTF8) {
+        return sequence_length;
+    }
+
+    // Only code points outside the BMP need a surrogate pair
+    return sequence_length == 4 ? 2 : 1;
+}
+
+} // namespace
+
+Document::Document(std::string text, common::Config config)
+  : tokens_{std::move(text)},
+    config_{config}
+{
+    if (!text().empty()) {
+        chunks_.push_back(Chunk{.length = text().size(), .unit = std::nullopt});
+    }
+
+    indexLines();
+}
+
+auto Document::replace(std::size_t begin, std::size_t end, std::string_view text) -> void
+{
+    const auto relexed = tokens_.applyEdit(begin, end, text);
+    updateLines(begin, end, text);
+
+    if (chunks_.empty()) {
+        if (!tokens_.text().empty()) {
+            chunks_.push_back(Chunk{.length = tokens_.text().size(), .unit = std::nullopt});
+        }
+        return;
+    }
+
+    // Tokens can change past the edit, e.g. when it opens a comment; mapped back to old offsets
+    const auto changed_begin = relexed.begin;
+    const auto changed_end = relexed.end - text.size() + end - begin;
+
+    // Touching counts as overlapping: text inserted at a boundary may belong to either unit
+    std::size_t first = chunks_.size();
+    std::size_t last = 0;
+    std::size_t length = 0;
+    std::size_t offset = 0;
+
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        const auto chunk_end = offset + chunks_.at(i).length;
+        if ((chunk_end >= begin && offset <= end)
+            || (chunk_end > changed_begin && offset < changed_end))
+        {
+            first = std::min(first, i);
+            last = i;
+            length += chunks_.at(i).length;
+        }
+        offset = chunk_end;
+    }
+
+    length = length - (end - begin) + text.size();
+
+    const auto first_it = std::next(chunks_.begin(), static_cast<std::ptrdiff_t>(first));
+    const auto last_it = std::next(chunks_.begin(), static_cast<std::ptrdiff_t>(last + 1));
+    const auto at = chunks_.erase(first_it, last_it);
+
+    if (length > 0) {
+        chunks_.insert(at, Chunk{.length = length, .unit = std::nullopt});
+    }
+}
+
+auto Document::format(std::size_t begin,
+                      std::size_t end,
+                      const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<TextEdit>, pipeline::FormatError>
+{
+    if (auto refreshed = refresh(cancellation); !refreshed) {
+        return std::unexpected(std::move(refreshed.error()));
+    }
+
+    // A caret at the very end of the buffer still belongs to the last unit
+    const auto last_byte = text().empty() ? 0 : text().size() - 1;
+    begin = std::min(begin, last_byte);
+    end = std::max(begin, end);
+
+    std::vector<TextEdit> edits{};
+    std::size_t offset = 0;
+
+    for (const auto& chunk : chunks_) {
+        const auto chunk_end = offset + chunk.length;
+        const auto& unit = chunk.unit.value();
+
+        if (offset <= end && begin < chunk_end && unit.formatted != unit.source) {
+            edits.push_back(TextEdit{.begin = offset, .end = chunk_end, .text = unit.formatted});
+        }
+
+        offset = chunk_end;
+    }
+
+    return edits;
+}
+
+auto Document::offsetAt(Position position, PositionEncoding encoding) const -> std::size_t
+{
+    if (position.line >= line_starts_.size()) {
+        return text().size();
+    }
+
+    const auto line_start = line_starts_.at(position.line);
+    auto line_end = position.line + 1 < line_starts_.size()
+                    ? line_starts_.at(position.line + 1) - 1
+                    : text().size();
+
+    if (line_end > line_start && text().at(line_end - 1) == '\r') {
+        --line_end;
+    }
+
+    std::size_t offset = line_start;
+    std::size_t character = 0;
+
+    while (offset < line_end && character < position.character) {
+        const auto length = sequenceLength(static_cast<unsigned char>(text().at(offset)));
+        character += width(length, encoding);
+        offset = std::min(offset + length, line_end);
+    }
+
+    return offset;
+}
+
+auto Document::positionAt(std::size_t offset, PositionEncoding encoding) const -> Position
+{
+    offset = std::min(offset, text().size());
+
+    const auto line_it = std::ranges::upper_bound(line_starts_, offset);
+    const auto line = static_cast<std::size_t>(std::distance(line_starts_.begin(), line_it)) - 1;
+
+    std::size_t character = 0;
+    for (auto i = line_starts_.at(line); i < offset;) {
+        const auto length = sequenceLength(static_cast<unsigned char>(text().at(i)));
+        character += width(length, encoding);
+        i += length;
+    }
+
+    return Position{.line = line, .character = character};
+}
+
+auto Document::refresh(const common::CancellationToken& cancellation)
+  -> std::expected<void, pipeline::FormatError>
+{
+    std::size_t offset = 0;
+
+    for (std::size_t i = 0; i < chunks_.size();) {
+        const auto length = chunks_.at(i).length;
+
+        if (chunks_.at(i).unit.has_value()) {
+            offset += length;
+            ++i;
+            continue;
+        }
+
+        std::optional<std::vector<pipeline::FormattedUnit>> units{};
+        try {
+            auto parsed = parse(offset, offset + length, cancellation);
+            if (!parsed) {
+                return std::unexpected(std::move(parsed.error()));
+            }
+            units = std::move(*parsed);
+        }
+        catch (const std::runtime_error&) {
+            // The edit may have moved a unit boundary out of the chunk (e.g. a deleted `end`)
+            units.reset();
+        }
+
+        if (!units.has_value() || units->empty()) {
+            return rebuild(cancellation);
+        }
+
+        std::vector<Chunk> parsed_chunks{};
+        parsed_chunks.reserve(units->size());
+        for (auto& unit : *units) {
+            const auto size = unit.source.size();
+            parsed_chunks.push_back(Chunk{.length = size, .unit = std::move(unit)});
+        }
+
+        const auto count = parsed_chunks.size();
+        const auto at = chunks_.erase(std::next(chunks_.begin(), static_cast<std::ptrdiff_t>(i)));
+        chunks_.insert(at,
+                       std::make_move_iterator(parsed_chunks.begin()),
+                       std::make_move_iterator(parsed_chunks.end()));
+
+        offset += length;
+        i += count;
+    }
+
+    return {};
+}
+
+auto Document::rebuild(const common::CancellationToken& cancellation)
+  -> std::expected<void, pipeline::FormatError>
+{
+    // Stays a single invalid chunk if the document does not parse yet
+    chunks_.clear();
+    if (text().empty()) {
+        return {};
+    }
+    chunks_.push_back(Chunk{.length = text().size(), .unit = std::nullopt});
+
+    auto parsed = parse(0, text().size(), cancellation);
+    if (!parsed) {
+        return std::unexpected(std::move(parsed.error()));
+    }
+
+    chunks_.clear();
+    for (auto& unit : *parsed) {
+        const auto size = unit.source.size();
+        chunks_.push_back(Chunk{.length = size, .unit = std::move(unit)});
+    }
+
+    return {};
+}
+
+auto Document::parse(std::size_t begin,
+                     std::size_t end,
+                     const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<pipeline::FormattedUnit>, pipeline::FormatError>
+{
+    parsed_bytes_ += end - begin;
+    return pipeline::formatUnits(tokens_, begin, end, config_, cancellation);
+}
+
+auto Document::indexLines() -> void
+{
+    line_starts_.assign(1, 0);
+
+    for (std::size_t i = 0; i < text().size(); ++i) {
+        if (text().at(i) == '\n') {
+            line_starts_.push_back(i + 1);
+        }
+    }
+}
+
+auto Document::updateLines(std::size_t begin, std::size_t end, std::string_view text) -> void
+{
+    // Line starts in (begin, end] followed a line break that the edit removed
+    const auto first = static_cast<std::size_t>(
+      std::distance(line_starts_.begin(), std::ranges::upper_bound(line_starts_, begin)));
+    const auto last = static_cast<std::size_t>(
+      std::distance(line_starts_.begin(), std::ranges::upper_bound(line_starts_, end)));
+
+    // Past the edit, so never below `end - begin`
+    for (auto& start : line_starts_ | std::views::drop(last)) {
+        start = start - (end - begin) + text.size();
+    }
+
+    std::vector<std::size_t> inserted{};
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text.at(i) == '\n') {
+            inserted.push_back(begin + i + 1);
+        }
+    }
+
+    const auto position = line_starts_.erase(
+      std::next(line_starts_.begin(), static_cast<std::ptrdiff_t>(first)),
+      std::next(line_starts_.begin(), static_cast<std::ptrdiff_t>(last)));
+    line_starts_.insert(position, inserted.begin(), inserted.end());
+}
+
+} // namespace lsp
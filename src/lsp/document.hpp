@@ -0,0 +1,118 @@
+#ifndef LSP_DOCUMENT_HPP
+#define LSP_DOCUMENT_HPP
+
+#include "builder/token_store.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lsp {
+
+/// @brief How the `character` of a position is counted.
+enum class PositionEncoding : std::uint8_t
+{
+    UTF16, ///< LSP default
+    UTF8,
+};
+
+/// @brief Zero-based line and character offset.
+struct Position final
+{
+    std::size_t line;
+    std::size_t character;
+};
+
+/// @brief Replacement of the bytes [begin, end) of a document.
+struct TextEdit final
+{
+    std::size_t begin;
+    std::size_t end;
+    std::string text;
+};
+
+/// @brief An open editor buffer, kept as a sequence of independently formatted design units.
+///
+/// Edits only invalidate the units they touch. The next format request re-parses just those
+/// chunks (see pipeline::FormattedUnit for why a chunk can be parsed on its own) and reuses
+/// every other unit's AST and rendered text. The buffer's tokens are kept alongside and only
+/// the edited lines are relexed, so re-parsing a chunk skips the lexer.
+class Document final
+{
+  public:
+    Document(std::string text, common::Config config);
+
+    [[nodiscard]]
+    auto text() const noexcept -> const std::string&
+    {
+        return tokens_.text();
+    }
+
+    /// @brief Replaces the bytes [begin, end) and invalidates the units the change touches.
+    auto replace(std::size_t begin, std::size_t end, std::string_view text) -> void;
+
+    /// @brief Edits that format every unit overlapping the bytes [begin, end].
+    /// @throws std::runtime_error on syntax errors.
+    /// @throws common::Cancelled once the token is cancelled; units parsed until then are kept.
+    [[nodiscard]]
+    auto format(std::size_t begin,
+                std::size_t end,
+                const common::CancellationToken& cancellation = {})
+      -> std::expected<std::vector<TextEdit>, pipeline::FormatError>;
+
+    [[nodiscard]]
+    auto offsetAt(Position position, PositionEncoding encoding) const -> std::size_t;
+
+    [[nodiscard]]
+    auto positionAt(std::size_t offset, PositionEncoding encoding) const -> Position;
+
+    /// @brief Total number of bytes handed to the parser so far.
+    [[nodiscard]]
+    auto parsedBytes() const noexcept -> std::size_t
+    {
+        return parsed_bytes_;
+    }
+
+  private:
+    struct Chunk
+    {
+        std::size_t length;
+        std::optional<pipeline::FormattedUnit> unit; ///< Empty until the chunk is re-parsed
+    };
+
+    builder::TokenStore tokens_;
+    common::Config config_;
+
+    /// Empty once the document is known to hold no design unit
+    std::vector<Chunk> chunks_{};
+    std::vector<std::size_t> line_starts_{};
+    std::size_t parsed_bytes_{0};
+
+    /// @brief Re-parses every invalidated chunk.
+    auto refresh(const common::CancellationToken& cancellation)
+      -> std::expected<void, pipeline::FormatError>;
+
+    /// @brief Re-parses the whole document, for edits that moved unit boundaries.
+    auto rebuild(const common::CancellationToken& cancellation)
+      -> std::expected<void, pipeline::FormatError>;
+
+    auto parse(std::size_t begin, std::size_t end, const common::CancellationToken& cancellation)
+      -> std::expected<std::vector<pipeline::FormattedUnit>, pipeline::FormatError>;
+
+    auto indexLines() -> void;
+
+    /// @brief Moves the line starts past an edit and swaps those inside it for the inserted
+    ///        text's, without rescanning the rest of the buffer.
+    auto updateLines(std::size_t begin, std::size_t end, std::string_view text) -> void;
+};
+
+} // namespace lsp
+
+#endif /* LSP_DOCUMENT_HPP */
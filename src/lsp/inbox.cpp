@@ -0,0 +1,183 @@
+#include "lsp/inbox.hpp"
+
+#include "common/cancellation.hpp"
+#include "lsp/transport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace lsp {
+
+namespace {
+
+using nlohmann::json;
+
+auto isRequest(const Inbound& inbound) -> bool
+{
+    return inbound.kind == Inbound::Kind::MESSAGE && inbound.message.is_object()
+        && inbound.message.contains("method") && inbound.message.contains("id");
+}
+
+auto methodOf(const json& message) -> std::string
+{
+    if (!message.is_object()) {
+        return {};
+    }
+
+    const auto method = message.find("method");
+    return method != message.end() && method->is_string() ? method->get<std::string>()
+                                                           : std::string{};
+}
+
+auto uriOf(const json& message) -> std::string
+{
+    try {
+        return message.value(json::json_pointer{"/params/textDocument/uri"}, std::string{});
+    }
+    catch (const json::exception&) {
+        return {};
+    }
+}
+
+} // namespace
+
+Inbox::Inbox(Transport& transport, std::optional<std::chrono::milliseconds> budget)
+  : transport_{transport},
+    budget_{budget},
+    reader_{[this] { read(); }}
+{
+}
+
+auto Inbox::next() -> Inbound
+{
+    std::unique_lock lock{mutex_};
+    ready_.wait(lock, [this] { return !queue_.empty(); });
+
+    auto inbound = std::move(queue_.front());
+    queue_.pop_front();
+
+    if (!isRequest(inbound)) {
+        return inbound;
+    }
+
+    // Taken off the queue and put in flight under one lock, so no cancellation is missed
+    const auto& id = inbound.message.at("id");
+    inbound.cancellation = common::CancellationToken::withBudget(budget_);
+    auto superseded = false;
+
+    const auto it = std::ranges::find(cancelled_, id, &std::pair<json, bool>::first);
+    if (it != cancelled_.end()) {
+        superseded = it->second;
+        inbound.cancellation.cancel();
+        cancelled_.erase(it);
+    }
+
+    in_flight_ = InFlight{.id = id,
+                          .uri = uriOf(inbound.message),
+                          .cancellation = inbound.cancellation,
+                          .superseded = superseded};
+    return inbound;
+}
+
+auto Inbox::finish() -> bool
+{
+    const std::scoped_lock lock{mutex_};
+
+    const auto superseded = in_flight_.has_value() && in_flight_->superseded;
+    in_flight_.reset();
+    return superseded;
+}
+
+auto Inbox::read() -> void
+{
+    while (true) {
+        Inbound inbound{.kind = Inbound::Kind::MESSAGE};
+
+        try {
+            const auto body = transport_.read();
+            if (body.has_value()) {
+                inbound.message = json::parse(*body);
+            } else {
+                inbound.kind = Inbound::Kind::CLOSED;
+            }
+        }
+        catch (const json::parse_error& e) {
+            inbound.kind = Inbound::Kind::INVALID_JSON;
+            inbound.error = e.what();
+        }
+        catch (const std::runtime_error& e) {
+            inbound.kind = Inbound::Kind::MALFORMED;
+            inbound.error = e.what();
+        }
+
+        const auto last = inbound.kind == Inbound::Kind::CLOSED
+                       || inbound.kind == Inbound::Kind::MALFORMED
+                       || methodOf(inbound.message) == "exit";
+
+        {
+            const std::scoped_lock lock{mutex_};
+            try {
+                observe(inbound.message);
+            }
+            catch (const json::exception&) {
+                // Malformed params are reported once the server handles the message
+            }
+            queue_.push_back(std::move(inbound));
+        }
+        ready_.notify_one();
+
+        if (last) {
+            return;
+        }
+    }
+}
+
+auto Inbox::observe(const json& message) -> void
+{
+    const auto method = methodOf(message);
+
+    if (method == "$/cancelRequest") {
+        const auto& id = message.at("params").at("id");
+        if (in_flight_.has_value() && in_flight_->id == id) {
+            in_flight_->cancellation.cancel();
+        } else {
+            cancelQueued(id, false);
+        }
+        return;
+    }
+
+    if (method == "textDocument/didChange") {
+        const auto uri = uriOf(message);
+
+        if (in_flight_.has_value() && in_flight_->uri == uri) {
+            in_flight_->superseded = true;
+            in_flight_->cancellation.cancel();
+        }
+
+        for (const auto& queued : queue_) {
+            if (isRequest(queued) && uriOf(queued.message) == uri) {
+                cancelQueued(queued.message.at("id"), true);
+            }
+        }
+    }
+}
+
+auto Inbox::cancelQueued(const json& id, bool superseded) -> void
+{
+    // Requests that are not queued have been answered already
+    const auto queued = std::ranges::any_of(queue_, [&id](const Inbound& inbound) {
+        return isRequest(inbound) && inbound.message.at("id") == id;
+    });
+
+    if (queued && !std::ranges::contains(cancelled_, id, &std::pair<json, bool>::first)) {
+        cancelled_.emplace_back(id, superseded);
+    }
+}
+
+} // namespace lsp
@@ -0,0 +1,102 @@
+#ifndef LSP_INBOX_HPP
+#define LSP_INBOX_HPP
+
+#include "common/cancellation.hpp"
+#include "lsp/transport.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lsp {
+
+/// @brief A message taken from the Inbox, or why there are no more.
+struct Inbound final
+{
+    enum class Kind : std::uint8_t
+    {
+        MESSAGE,
+        INVALID_JSON, ///< The body is not JSON; reading goes on
+        MALFORMED,    ///< The framing is broken; nothing more can be read
+        CLOSED,       ///< End of input, or the client sent `exit`
+    };
+
+    Kind kind;
+    nlohmann::json message{};
+    std::string error{};
+
+    /// For requests: cancelled by `$/cancelRequest`, by a change to the request's document,
+    /// or once the time budget runs out
+    common::CancellationToken cancellation{};
+};
+
+/// @brief Reads messages ahead on a background thread, so that the request being handled
+///        can be cancelled while it runs.
+///
+/// A request taken with next() is in flight until finish(). `$/cancelRequest` cancels the
+/// request whether it is in flight or still queued. A change to a document supersedes the
+/// requests on that document that came before it, since their edits would no longer apply.
+class Inbox final
+{
+  public:
+    /// @param budget Time a request may take before it is cancelled; unlimited if empty.
+    Inbox(Transport& transport, std::optional<std::chrono::milliseconds> budget);
+
+    ~Inbox() = default;
+
+    Inbox(const Inbox&) = delete;
+    auto operator=(const Inbox&) -> Inbox& = delete;
+    Inbox(Inbox&&) = delete;
+    auto operator=(Inbox&&) -> Inbox& = delete;
+
+    /// @brief Blocks until the next message has been read; a request is then in flight.
+    [[nodiscard]]
+    auto next() -> Inbound;
+
+    /// @brief Ends the request in flight.
+    /// @return Whether a change to its document superseded it.
+    auto finish() -> bool;
+
+  private:
+    struct InFlight
+    {
+        nlohmann::json id;
+        std::string uri;
+        common::CancellationToken cancellation;
+        bool superseded{false};
+    };
+
+    Transport& transport_;
+    std::optional<std::chrono::milliseconds> budget_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Inbound> queue_{};
+    std::optional<InFlight> in_flight_{};
+
+    /// Ids of queued requests that are to be answered without running, and whether a
+    /// document change superseded them
+    std::vector<std::pair<nlohmann::json, bool>> cancelled_{};
+
+    // Last, so that it is joined before the state it uses goes away. Reading stops at
+    // `exit`, at the end of the input, or at a framing error.
+    std::jthread reader_;
+
+    auto read() -> void;
+
+    // Caller holds `mutex_`
+    auto observe(const nlohmann::json& message) -> void;
+    auto cancelQueued(const nlohmann::json& id, bool superseded) -> void;
+};
+
+} // namespace lsp
+
+#endif /* LSP_INBOX_HPP */
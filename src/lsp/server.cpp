@@ -0,0 +1,369 @@
+#include "lsp/server.hpp"
+
+#include "builder/warm_up.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "common/logger.hpp"
+#include "lsp/document.hpp"
+#include "lsp/inbox.hpp"
+#include "lsp/transport.hpp"
+#include "version.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace lsp {
+
+namespace {
+
+using nlohmann::json;
+
+/// @brief A request that must be answered with an error response.
+class RequestError final : public std::runtime_error
+{
+  public:
+    RequestError(ErrorCode code, const std::string& message)
+        : std::runtime_error{message},
+          code_{code}
+    {}
+
+    [[nodiscard]]
+    auto code() const noexcept -> ErrorCode
+    {
+        return code_;
+    }
+
+  private:
+    ErrorCode code_;
+};
+
+constexpr int TEXT_DOCUMENT_SYNC_INCREMENTAL = 2;
+
+auto toPosition(const json& position) -> Position
+{
+    return Position{.line = position.at("line").get<std::size_t>(),
+                    .character = position.at("character").get<std::size_t>()};
+}
+
+auto toJson(Position position) -> json
+{
+    return json{
+      {"line",      position.line     },
+      {"character", position.character},
+    };
+}
+
+} // namespace
+
+Server::Server(Transport& transport,
+               common::Config config,
+               std::optional<std::chrono::milliseconds> timeout_per_request)
+  : transport_{transport},
+    config_{config},
+    timeout_per_request_{timeout_per_request}
+{
+}
+
+auto Server::run() -> int
+{
+    // Long-lived process: prime the prediction caches once
+    builder::warmUp();
+
+    Inbox inbox{transport_, timeout_per_request_};
+
+    while (true) {
+        const auto inbound = inbox.next();
+
+        switch (inbound.kind) {
+            case Inbound::Kind::MALFORMED:
+                common::Logger::instance().error("Malformed message: {}", inbound.error);
+                return EXIT_FAILURE;
+
+            case Inbound::Kind::CLOSED:
+                // The client went away without `exit`
+                return EXIT_FAILURE;
+
+            case Inbound::Kind::INVALID_JSON:
+                sendError(nullptr, ErrorCode::PARSE_ERROR, inbound.error);
+                continue;
+
+            case Inbound::Kind::MESSAGE:
+                break;
+        }
+
+        cancellation_ = inbound.cancellation;
+        if (const auto exit_code = handle(inbound.message, inbox)) {
+            return *exit_code;
+        }
+    }
+}
+
+auto Server::handle(const json& message, Inbox& inbox) -> std::optional<int>
+{
+    const auto method = message.value("method", std::string{});
+    const auto params = message.value("params", json::object());
+
+    // Responses to server-initiated requests; none are sent
+    if (method.empty()) {
+        return std::nullopt;
+    }
+
+    if (method == "exit") {
+        return shutdown_requested_ ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!message.contains("id")) {
+        try {
+            notify(method, params);
+        }
+        catch (const std::exception& e) {
+            common::Logger::instance().warn("Notification '{}' failed: {}", method, e.what());
+        }
+        return std::nullopt;
+    }
+
+    const auto& id = message.at("id");
+
+    try {
+        cancellation_.check();
+
+        send(json{
+          {"jsonrpc", "2.0"                  },
+          {"id",      id                     },
+          {"result",  request(method, params)},
+        });
+    }
+    catch (const common::Cancelled& e) {
+        // Superseded requests are told apart so that the client may retry them
+        if (inbox.finish()) {
+            sendError(id, ErrorCode::CONTENT_MODIFIED, "The document changed");
+        } else {
+            sendError(id, ErrorCode::REQUEST_CANCELLED, e.what());
+        }
+        return std::nullopt;
+    }
+    catch (const RequestError& e) {
+        sendError(id, e.code(), e.what());
+    }
+    catch (const json::exception& e) {
+        sendError(id, ErrorCode::INVALID_PARAMS, e.what());
+    }
+    catch (const std::exception& e) {
+        sendError(id, ErrorCode::REQUEST_FAILED, e.what());
+    }
+
+    inbox.finish();
+    return std::nullopt;
+}
+
+auto Server::request(std::string_view method, const json& params) -> json
+{
+    if (method == "initialize") {
+        return initialize(params);
+    }
+
+    if (!initialized_) {
+        throw RequestError{ErrorCode::SERVER_NOT_INITIALIZED, "Server is not initialized"};
+    }
+
+    if (shutdown_requested_) {
+        throw RequestError{ErrorCode::INVALID_REQUEST, "Server is shutting down"};
+    }
+
+    if (method == "shutdown") {
+        shutdown_requested_ = true;
+        return nullptr;
+    }
+
+    if (method == "textDocument/formatting") {
+        return formatting(params);
+    }
+
+    if (method == "textDocument/rangeFormatting") {
+        return rangeFormatting(params);
+    }
+
+    if (method == "textDocument/onTypeFormatting") {
+        return onTypeFormatting(params);
+    }
+
+    throw RequestError{ErrorCode::METHOD_NOT_FOUND, std::format("Unhandled method: {}", method)};
+}
+
+auto Server::notify(std::string_view method, const json& params) -> void
+{
+    if (method == "textDocument/didOpen") {
+        didOpen(params);
+    } else if (method == "textDocument/didChange") {
+        didChange(params);
+    } else if (method == "textDocument/didClose") {
+        didClose(params);
+    }
+
+    // Everything else (`initialized`, ...) needs no action; `$/cancelRequest` is acted on as
+    // soon as it is read (see Inbox)
+}
+
+auto Server::initialize(const json& params) -> json
+{
+    // Byte offsets spare the UTF-16 transcoding of every position
+    const auto encodings = params.value(
+      json::json_pointer{"/capabilities/general/positionEncodings"}, json::array());
+    if (std::ranges::contains(encodings, json("utf-8"))) {
+        encoding_ = PositionEncoding::UTF8;
+    }
+
+    initialized_ = true;
+
+    return json{
+      {"capabilities",
+       {
+         {"positionEncoding", encoding_ == PositionEncoding::UTF8 ? "utf-8" : "utf-16"},
+         {"textDocumentSync",
+          {
+            {"openClose", true},
+            {"change", TEXT_DOCUMENT_SYNC_INCREMENTAL},
+          }},
+         {"documentFormattingProvider", true},
+         {"documentRangeFormattingProvider", true},
+         {"documentOnTypeFormattingProvider", {{"firstTriggerCharacter", ";"}}},
+       }},
+      {"serverInfo",
+       {
+         {"name", std::string{common::PROJECT_NAME}},
+         {"version", std::string{common::PROJECT_VERSION}},
+       }},
+    };
+}
+
+auto Server::formatting(const json& params) -> json
+{
+    auto& doc = document(params);
+    return format(doc, 0, doc.text().size());
+}
+
+auto Server::rangeFormatting(const json& params) -> json
+{
+    auto& doc = document(params);
+
+    const auto& range = params.at("range");
+    const auto begin = doc.offsetAt(toPosition(range.at("start")), encoding_);
+    const auto end = doc.offsetAt(toPosition(range.at("end")), encoding_);
+
+    return format(doc, begin, std::max(begin, end));
+}
+
+auto Server::onTypeFormatting(const json& params) -> json
+{
+    auto& doc = document(params);
+    const auto offset = doc.offsetAt(toPosition(params.at("position")), encoding_);
+
+    try {
+        return format(doc, offset, offset);
+    }
+    catch (const RequestError&) {
+        throw;
+    }
+    catch (const std::runtime_error& e) {
+        // The buffer is usually incomplete while typing, so syntax errors are expected
+        common::Logger::instance().debug("On-type formatting skipped: {}", e.what());
+        return json::array();
+    }
+}
+
+auto Server::didOpen(const json& params) -> void
+{
+    const auto& item = params.at("textDocument");
+    documents_.insert_or_assign(item.at("uri").get<std::string>(),
+                                Document{item.at("text").get<std::string>(), config_});
+}
+
+auto Server::didChange(const json& params) -> void
+{
+    auto& doc = document(params);
+
+    for (const auto& change : params.at("contentChanges")) {
+        const auto text = change.at("text").get<std::string>();
+
+        if (!change.contains("range")) {
+            doc.replace(0, doc.text().size(), text);
+            continue;
+        }
+
+        const auto& range = change.at("range");
+        const auto begin = doc.offsetAt(toPosition(range.at("start")), encoding_);
+        const auto end = doc.offsetAt(toPosition(range.at("end")), encoding_);
+
+        doc.replace(begin, std::max(begin, end), text);
+    }
+}
+
+auto Server::didClose(const json& params) -> void
+{
+    documents_.erase(params.at("textDocument").at("uri").get<std::string>());
+}
+
+auto Server::document(const json& params) -> Document&
+{
+    const auto uri = params.at("textDocument").at("uri").get<std::string>();
+
+    const auto it = documents_.find(uri);
+    if (it == documents_.end()) {
+        throw RequestError{ErrorCode::INVALID_PARAMS, std::format("Unknown document: {}", uri)};
+    }
+
+    return it->second;
+}
+
+auto Server::format(Document& doc, std::size_t begin, std::size_t end) -> json
+{
+    const auto edits = doc.format(begin, end, cancellation_);
+    if (!edits) {
+        throw RequestError{ErrorCode::REQUEST_FAILED, edits.error().message};
+    }
+
+    auto result = json::array();
+    for (const auto& edit : *edits) {
+        result.push_back(json{
+          {"range",
+           {
+             {"start", toJson(doc.positionAt(edit.begin, encoding_))},
+             {"end", toJson(doc.positionAt(edit.end, encoding_))},
+           }},
+          {"newText", edit.text},
+        });
+    }
+
+    return result;
+}
+
+auto Server::send(const json& message) -> void
+{
+    // Invalid UTF-8 in a buffer must not take the server down
+    transport_.write(message.dump(-1, ' ', false, json::error_handler_t::replace));
+}
+
+auto Server::sendError(const json& id, ErrorCode code, std::string_view message) -> void
+{
+    send(json{
+      {"jsonrpc", "2.0"},
+      {"id", id},
+      {"error",
+       {
+         {"code", std::to_underlying(code)},
+         {"message", std::string{message}},
+       }},
+    });
+}
+
+} // namespace lsp
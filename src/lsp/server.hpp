@@ -0,0 +1,99 @@
+#ifndef LSP_SERVER_HPP
+#define LSP_SERVER_HPP
+
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "lsp/document.hpp"
+#include "lsp/inbox.hpp"
+#include "lsp/transport.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace lsp {
+
+/// @brief JSON-RPC and LSP error codes.
+enum class ErrorCode : std::int32_t
+{
+    PARSE_ERROR = -32700,
+    INVALID_REQUEST = -32600,
+    METHOD_NOT_FOUND = -32601,
+    INVALID_PARAMS = -32602,
+    SERVER_NOT_INITIALIZED = -32002,
+    REQUEST_CANCELLED = -32800,
+    CONTENT_MODIFIED = -32801,
+    REQUEST_FAILED = -32803,
+};
+
+/// @brief Language server exposing the formatter over JSON-RPC.
+///
+/// Supports whole-document, range and on-type formatting. Open documents are synced
+/// incrementally and keep their per-unit state between requests (see Document). Messages
+/// are read ahead while a request runs, so that `$/cancelRequest` and newer edits stop it
+/// (see Inbox).
+class Server final
+{
+  public:
+    /// @param timeout_per_request Time a request may take before it is cancelled.
+    Server(Transport& transport,
+           common::Config config,
+           std::optional<std::chrono::milliseconds> timeout_per_request = std::nullopt);
+
+    ~Server() = default;
+
+    Server(const Server&) = delete;
+    auto operator=(const Server&) -> Server& = delete;
+    Server(Server&&) = delete;
+    auto operator=(Server&&) -> Server& = delete;
+
+    /// @brief Serves messages until the client sends `exit` or closes the stream.
+    /// @return The process exit code: success only if `shutdown` came before `exit`.
+    [[nodiscard]]
+    auto run() -> int;
+
+  private:
+    Transport& transport_;
+    common::Config config_;
+    std::optional<std::chrono::milliseconds> timeout_per_request_;
+
+    /// Cancellation of the request being handled
+    common::CancellationToken cancellation_{};
+
+    std::unordered_map<std::string, Document> documents_{};
+    PositionEncoding encoding_{PositionEncoding::UTF16};
+    bool initialized_{false};
+    bool shutdown_requested_{false};
+
+    /// @return The exit code once the client sent `exit`.
+    auto handle(const nlohmann::json& message, Inbox& inbox) -> std::optional<int>;
+
+    auto request(std::string_view method, const nlohmann::json& params) -> nlohmann::json;
+    auto notify(std::string_view method, const nlohmann::json& params) -> void;
+
+    // Requests
+    auto initialize(const nlohmann::json& params) -> nlohmann::json;
+    auto formatting(const nlohmann::json& params) -> nlohmann::json;
+    auto rangeFormatting(const nlohmann::json& params) -> nlohmann::json;
+    auto onTypeFormatting(const nlohmann::json& params) -> nlohmann::json;
+
+    // Notifications
+    auto didOpen(const nlohmann::json& params) -> void;
+    auto didChange(const nlohmann::json& params) -> void;
+    auto didClose(const nlohmann::json& params) -> void;
+
+    // Helpers
+    auto document(const nlohmann::json& params) -> Document&;
+    auto format(Document& doc, std::size_t begin, std::size_t end) -> nlohmann::json;
+    auto send(const nlohmann::json& message) -> void;
+    auto sendError(const nlohmann::json& id, ErrorCode code, std::string_view message) -> void;
+};
+
+} // namespace lsp
+
+#endif /* LSP_SERVER_HPP */
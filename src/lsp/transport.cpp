@@ -0,0 +1,80 @@
+#include "lsp/transport.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <format>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace lsp {
+
+namespace {
+
+constexpr std::string_view CONTENT_LENGTH{"content-length:"};
+
+/// @brief Header names are case-insensitive.
+auto startsWithIgnoreCase(std::string_view text, std::string_view prefix) -> bool
+{
+    return text.size() >= prefix.size()
+        && std::ranges::equal(text.substr(0, prefix.size()), prefix, [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) == b;
+           });
+}
+
+} // namespace
+
+auto Transport::read() -> std::optional<std::string>
+{
+    std::optional<std::size_t> length{};
+    std::string line{};
+
+    while (std::getline(input_, line)) {
+        if (line.ends_with('\r')) {
+            line.pop_back();
+        }
+
+        // An empty line terminates the header block
+        if (line.empty()) {
+            if (!length.has_value()) {
+                throw std::runtime_error("Message header without Content-Length");
+            }
+
+            std::string body(*length, '\0');
+            if (!input_.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+                return std::nullopt;
+            }
+            return body;
+        }
+
+        if (startsWithIgnoreCase(line, CONTENT_LENGTH)) {
+            auto value = std::string_view{line}.substr(CONTENT_LENGTH.size());
+            value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+
+            std::size_t parsed{0};
+            const auto result =
+              std::from_chars(std::to_address(value.begin()), std::to_address(value.end()), parsed);
+            if (result.ec != std::errc{}) {
+                throw std::runtime_error(std::format("Invalid Content-Length: '{}'", value));
+            }
+            length = parsed;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto Transport::write(std::string_view body) -> void
+{
+    output_ << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    output_.flush();
+}
+
+} // namespace lsp
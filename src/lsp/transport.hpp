@@ -0,0 +1,40 @@
+#ifndef LSP_TRANSPORT_HPP
+#define LSP_TRANSPORT_HPP
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lsp {
+
+/// @brief Base protocol framing: `Content-Length` headers followed by a JSON-RPC body.
+class Transport final
+{
+  public:
+    Transport(std::istream& input, std::ostream& output) : input_{input}, output_{output} {}
+
+    ~Transport() = default;
+
+    Transport(const Transport&) = delete;
+    auto operator=(const Transport&) -> Transport& = delete;
+    Transport(Transport&&) = delete;
+    auto operator=(Transport&&) -> Transport& = delete;
+
+    /// @brief Reads the body of the next message.
+    /// @return std::nullopt once the input is exhausted.
+    /// @throws std::runtime_error if the headers lack a valid `Content-Length`.
+    [[nodiscard]]
+    auto read() -> std::optional<std::string>;
+
+    /// @brief Frames and flushes one message body.
+    auto write(std::string_view body) -> void;
+
+  private:
+    std::istream& input_;
+    std::ostream& output_;
+};
+
+} // namespace lsp
+
+#endif /* LSP_TRANSPORT_HPP */
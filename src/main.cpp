@@ -1,20 +1,185 @@
-#include "builder/ast_builder.hpp"
-#include "builder/verifier.hpp"
+#include "builder/prediction_cache.hpp"
 #include "cli/argument_parser.hpp"
 #include "cli/config_reader.hpp"
+#include "common/allocation_profiler.hpp"
+#include "common/cancellation.hpp"
 #include "common/logger.hpp"
-#include "emit/format.hpp"
-#include "emit/pretty_printer/renderer.hpp"
+#include "common/stats.hpp"
+#include "lsp/server.hpp"
+#include "lsp/transport.hpp"
+#include "pipeline/changes.hpp"
+#include "pipeline/format.hpp"
+#include "watch/watcher.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
+#include <expected>
+#include <format>
 #include <fstream>
+#include <ios>
 #include <iostream>
 #include <iterator>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <ostream>
 #include <ranges>
 #include <span>
+#include <stdexcept>
 #include <string>
-#include <string_view>
+
+namespace {
+
+// Allocation sites listed by --stats in allocation profiler builds
+constexpr std::size_t TOP_ALLOCATION_SITES{20};
+
+auto allocationsJson(const common::allocations::Profile& profile) -> nlohmann::json
+{
+    const auto phase_json = [](const common::allocations::PhaseAllocations& phase) {
+        return nlohmann::json{
+          {"count",           phase.count          },
+          {"bytes",           phase.bytes          },
+          {"peak_live_bytes", phase.peak_live_bytes},
+        };
+    };
+
+    auto phases = nlohmann::json::object();
+    for (std::size_t i = 0; i < common::stats::PHASE_COUNT; ++i) {
+        phases[std::string{common::stats::PHASE_NAMES.at(i)}] = phase_json(profile.phases.at(i));
+    }
+    phases["other"] = phase_json(profile.phases.back());
+
+    auto sites = nlohmann::json::array();
+    for (const auto& site : profile.top_sites) {
+        sites.push_back({
+          {"function", site.function},
+          {"count",    site.count   },
+          {"bytes",    site.bytes   },
+        });
+    }
+
+    return nlohmann::json{
+      {"phases",          phases                 },
+      {"peak_live_bytes", profile.peak_live_bytes},
+      {"top_sites",       sites                  },
+    };
+}
+
+auto printAllocations(const common::allocations::Profile& profile) -> void
+{
+    std::cerr << std::format(
+      "\n{:<12} {:>10} {:>12} {:>12}\n", "allocations", "count", "bytes", "peak live");
+    for (std::size_t i = 0; i < profile.phases.size(); ++i) {
+        const auto& phase = profile.phases.at(i);
+        const auto name =
+          i < common::stats::PHASE_COUNT ? common::stats::PHASE_NAMES.at(i) : "other";
+        std::cerr << std::format(
+          "{:<12} {:>10} {:>12} {:>12}\n", name, phase.count, phase.bytes, phase.peak_live_bytes);
+    }
+    std::cerr << std::format("{:<12} {:>36}\n\n", "peak live", profile.peak_live_bytes);
+
+    std::cerr << std::format("{:>10} {:>12}  {}\n", "count", "bytes", "site");
+    for (const auto& site : profile.top_sites) {
+        std::cerr << std::format("{:>10} {:>12}  {}\n", site.count, site.bytes, site.function);
+    }
+}
+
+auto printStats(const common::stats::Snapshot& stats, cli::StatsFormat format) -> void
+{
+    std::chrono::nanoseconds total{};
+    for (const auto phase : stats.phases) {
+        total += phase;
+    }
+
+    if (format == cli::StatsFormat::JSON) {
+        // Plain sums, doc_max_depth aside, so the objects of a batch of runs add up key by key
+        auto phases = nlohmann::json::object();
+        for (std::size_t i = 0; i < common::stats::PHASE_COUNT; ++i) {
+            phases[std::string{common::stats::PHASE_NAMES.at(i)}] = stats.phases.at(i).count();
+        }
+
+        auto counters = nlohmann::json::object();
+        for (std::size_t i = 0; i < common::stats::COUNTER_COUNT; ++i) {
+            counters[std::string{common::stats::COUNTER_NAMES.at(i)}] = stats.counters.at(i);
+        }
+
+        nlohmann::json report{
+          {"phases_ns", phases       },
+          {"total_ns",  total.count()},
+          {"counters",  counters     },
+        };
+        if constexpr (common::allocations::COMPILED) {
+            // Peaks are maxima rather than sums
+            report["allocations"] =
+              allocationsJson(common::allocations::profile(TOP_ALLOCATION_SITES));
+        }
+        std::cerr << report.dump() << '\n';
+        return;
+    }
+
+    const auto milliseconds = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>{time}.count();
+    };
+    const auto share = [&total](std::chrono::nanoseconds time) {
+        return total.count() == 0 ? 0.0 : 100.0 * static_cast<double>(time.count())
+                                                 / static_cast<double>(total.count());
+    };
+
+    std::cerr << std::format("{:<12} {:>10} {:>6}\n", "phase", "ms", "%");
+    for (std::size_t i = 0; i < common::stats::PHASE_COUNT; ++i) {
+        const auto time = stats.phases.at(i);
+        std::cerr << std::format("{:<12} {:>10.3f} {:>5.1f}%\n",
+                                 common::stats::PHASE_NAMES.at(i),
+                                 milliseconds(time),
+                                 share(time));
+    }
+    std::cerr << std::format("{:<12} {:>10.3f}\n\n", "total", milliseconds(total));
+
+    for (std::size_t i = 0; i < common::stats::COUNTER_COUNT; ++i) {
+        std::cerr << std::format(
+          "{:<12} {:>10}\n", common::stats::COUNTER_NAMES.at(i), stats.counters.at(i));
+    }
+
+    if constexpr (common::allocations::COMPILED) {
+        printAllocations(common::allocations::profile(TOP_ALLOCATION_SITES));
+    }
+}
+
+/// @brief Prints the statistics of the run when it goes out of scope, whichever way main()
+///        returns.
+class StatsReport final
+{
+  public:
+    explicit StatsReport(std::optional<cli::StatsFormat> format) : format_{format}
+    {
+        common::stats::Registry::instance().enable(format_.has_value());
+    }
+
+    ~StatsReport()
+    {
+        if (!format_) {
+            return;
+        }
+
+        try {
+            printStats(common::stats::Registry::instance().snapshot(), *format_);
+        }
+        catch (...) {
+            // Nowhere left to report to once stderr fails
+        }
+    }
+
+    StatsReport(const StatsReport&) = delete;
+    auto operator=(const StatsReport&) -> StatsReport& = delete;
+    StatsReport(StatsReport&&) = delete;
+    auto operator=(StatsReport&&) -> StatsReport& = delete;
+
+  private:
+    std::optional<cli::StatsFormat> format_;
+};
+
+} // namespace
 
 auto main(int argc, char* argv[]) -> int
 {
@@ -28,36 +193,162 @@ auto main(int argc, char* argv[]) -> int
         cli::ConfigReader config_reader{argparser.getConfigPath()};
         const auto config = config_reader.readConfigFile().value();
 
-        // 1. Create Context (keeps tokens alive)
-        auto ctx_orig = builder::createContext(argparser.getInputPath());
+        const StatsReport stats{argparser.getStatsFormat()};
+
+        // Applies to every mode, though only long sessions and --diff runs come near it
+        if (const auto& limit = argparser.getPredictionCacheLimit()) {
+            builder::PredictionCache::instance().setCeiling(*limit);
+        }
+
+        // Language server: stdout carries the protocol, so logs must go elsewhere
+        if (argparser.isFlagSet(cli::ArgumentFlag::LSP)) {
+            logger.useStderr();
+
+            lsp::Transport transport{std::cin, std::cout};
+            return lsp::Server{transport, config, argparser.getTimeoutPerFile()}.run();
+        }
+
+        // Watch mode: format on save until the process is interrupted
+        if (argparser.isFlagSet(cli::ArgumentFlag::WATCH)) {
+            return watch::Watcher{argparser.getInputPath(),
+                                  config,
+                                  watch::Watcher::DEFAULT_DEBOUNCE,
+                                  argparser.getTimeoutPerFile()}
+              .run();
+        }
+
+        // Diff mode: only the units touched by the changes, across every listed file
+        if (argparser.isFlagSet(cli::ArgumentFlag::DIFF)) {
+            const std::string input{std::istreambuf_iterator<char>{std::cin},
+                                    std::istreambuf_iterator<char>{}};
+            const auto changes = pipeline::parseChanges(input);
+
+            auto status = EXIT_SUCCESS;
+            const auto results =
+              pipeline::formatChanges(changes, config, 0, argparser.getTimeoutPerFile());
+            common::stats::count(common::stats::Counter::FILES, results.size());
+
+            for (const auto& result : results) {
+                if (!result.formatted) {
+                    logger.error("{}: {}", result.path.string(), result.formatted.error().message);
+                    status = EXIT_FAILURE;
+                } else if (*result.formatted != result.source) {
+                    if (argparser.isFlagSet(cli::ArgumentFlag::WRITE)) {
+                        try {
+                            pipeline::writeSource(result.path, *result.formatted);
+                        }
+                        catch (const std::exception& e) {
+                            logger.error("{}: {}", result.path.string(), e.what());
+                            status = EXIT_FAILURE;
+                        }
+                    } else {
+                        // Without --write, list the files that need formatting
+                        std::cout << result.path.string() << '\n';
+                        status = EXIT_FAILURE;
+                    }
+                }
+            }
+
+            return status;
+        }
+
+        // Streaming: one unit at a time, the file never sits in memory whole
+        if (argparser.isFlagSet(cli::ArgumentFlag::STREAM)) {
+            const auto& path = argparser.getInputPath();
+            const auto cancellation =
+              common::CancellationToken::withBudget(argparser.getTimeoutPerFile());
+
+            std::ifstream input{path, std::ios::binary};
+            if (!input.is_open()) {
+                throw std::runtime_error(
+                  std::format("Failed to open input file: {}", path.string()));
+            }
+
+            std::expected<void, pipeline::FormatError> result{};
+            common::stats::count(common::stats::Counter::FILES);
+
+            if (argparser.isFlagSet(cli::ArgumentFlag::WRITE)) {
+                // The original stays in place until the whole file has been formatted
+                pipeline::writeSource(path, [&](std::ostream& output) {
+                    result = pipeline::formatStream(input, output, config, cancellation);
+                    return result.has_value();
+                });
+            } else {
+                result = pipeline::formatStream(input, std::cout, config, cancellation);
+            }
 
-        // 2. Build AST
-        const auto root = builder::build(ctx_orig);
+            if (!result) {
+                logger.critical("Formatter corrupted the code semantics.");
+                logger.critical("{}", result.error().message);
+                logger.info("Aborting write to prevent data loss.");
+                return EXIT_FAILURE;
+            }
 
-        // 3. Format
-        const std::string formatted_code = emit::format(root, config);
+            return EXIT_SUCCESS;
+        }
+
+        // 1. Parse, format and verify
+        const auto source = pipeline::readSource(argparser.getInputPath());
+        common::stats::count(common::stats::Counter::FILES);
+        const auto cancellation =
+          common::CancellationToken::withBudget(argparser.getTimeoutPerFile());
 
-        // 4. Verify Safety
-        const auto ctx_fmt = builder::createContext(std::string_view{formatted_code});
+        // Layout explanation: the renderer's decisions instead of the formatted file
+        if (argparser.isFlagSet(cli::ArgumentFlag::EXPLAIN_LAYOUT)) {
+            std::cout << pipeline::explainLayout(source, config, cancellation);
+            return EXIT_SUCCESS;
+        }
 
-        const auto result = builder::verify::ensureSafety(*ctx_orig.tokens, *ctx_fmt.tokens);
+        if (argparser.getOutputMode() == cli::OutputMode::EDITS) {
+            const auto edits = pipeline::formatEdits(source, config, cancellation);
+            if (!edits) {
+                logger.critical("Formatter corrupted the code semantics.");
+                logger.critical("{}", edits.error().message);
+                return EXIT_FAILURE;
+            }
 
-        if (!result) {
+            auto json = nlohmann::json::array();
+            for (const auto& edit : *edits) {
+                json.push_back({
+                  {"offset",      edit.offset     },
+                  {"length",      edit.length     },
+                  {"replacement", edit.replacement},
+                });
+            }
+
+            std::cout << json.dump(2, ' ', false, nlohmann::json::error_handler_t::replace) << '\n';
+            return EXIT_SUCCESS;
+        }
+
+        const auto& lines = argparser.getLineRange();
+        const auto formatted_code =
+          lines ? pipeline::formatRange(source,
+                                        pipeline::LineRange{.first = lines->first,
+                                                            .last = lines->last},
+                                        config,
+                                        cancellation)
+                : pipeline::formatSource(source, config, cancellation);
+
+        if (!formatted_code) {
             logger.critical("Formatter corrupted the code semantics.");
-            logger.critical("{}", result.error().message);
+            logger.critical("{}", formatted_code.error().message);
             logger.info("Aborting write to prevent data loss.");
 
             return EXIT_FAILURE;
         }
 
-        // 5. Output
+        // 2. Output
         if (argparser.isFlagSet(cli::ArgumentFlag::WRITE)) {
-            std::ofstream out_file(argparser.getInputPath());
-            out_file << formatted_code;
+            pipeline::writeSource(argparser.getInputPath(), *formatted_code);
         } else {
-            std::cout << formatted_code;
+            const common::stats::Timer timer{common::stats::Phase::WRITE};
+            std::cout << *formatted_code;
         }
     }
+    catch (const common::Cancelled&) {
+        logger.error("Exceeded --timeout-per-file, the file was left untouched");
+        return EXIT_FAILURE;
+    }
     catch (const std::exception& e) {
         logger.error("Error: {}", e.what());
         return EXIT_FAILURE;
@@ -0,0 +1,215 @@
+#include "pipeline/changes.hpp"
+
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pipeline {
+
+namespace {
+
+auto parseNumber(std::string_view text, std::string_view line) -> std::size_t
+{
+    std::size_t value{0};
+    const auto* const last = std::to_address(text.end());
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+
+    if (ec != std::errc{} || ptr != last) {
+        throw std::runtime_error(std::format("Invalid line number in '{}'", line));
+    }
+
+    return value;
+}
+
+auto splitLines(std::string_view text) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> lines{};
+
+    while (!text.empty()) {
+        const auto newline = text.find('\n');
+        auto line = text.substr(0, newline);
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+
+        lines.push_back(line);
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+    }
+
+    return lines;
+}
+
+// `+++ b/src/top.vhd<TAB>timestamp`; git prefixes the new side with `b/` unless told not to
+auto parseNewFile(std::string_view line) -> std::filesystem::path
+{
+    auto name = line.substr(line.find(' ') + 1);
+    name = name.substr(0, name.find('\t'));
+
+    if (name == "/dev/null") {
+        return {};
+    }
+
+    if (name.starts_with("b/") && !std::filesystem::exists(std::filesystem::path{name})) {
+        name.remove_prefix(2);
+    }
+
+    return std::filesystem::path{name};
+}
+
+// `@@ -12,5 +14,7 @@`: lines 14 to 20 of the new file
+auto parseHunk(std::string_view line) -> LineRange
+{
+    const auto plus = line.find(" +");
+    if (plus == std::string_view::npos) {
+        throw std::runtime_error(std::format("Malformed hunk header '{}'", line));
+    }
+
+    auto spec = line.substr(plus + 2);
+    spec = spec.substr(0, spec.find(' '));
+
+    const auto comma = spec.find(',');
+    const auto start = parseNumber(spec.substr(0, comma), line);
+    const auto count =
+      comma == std::string_view::npos ? 1 : parseNumber(spec.substr(comma + 1), line);
+
+    // A pure deletion still touches the line it was removed after
+    const auto first = std::max<std::size_t>(start, 1);
+    return LineRange{.first = first, .last = first + std::max<std::size_t>(count, 1) - 1};
+}
+
+// `path:first:last`
+auto parseEntry(std::string_view line) -> FileChanges
+{
+    const auto second = line.rfind(':');
+    const auto first = second == std::string_view::npos || second == 0
+                       ? std::string_view::npos
+                       : line.rfind(':', second - 1);
+
+    if (first == std::string_view::npos || first == 0) {
+        throw std::runtime_error(std::format("Expected path:first:last, got '{}'", line));
+    }
+
+    const LineRange range{.first = parseNumber(line.substr(first + 1, second - first - 1), line),
+                          .last = parseNumber(line.substr(second + 1), line)};
+
+    if (range.first == 0 || range.first > range.last) {
+        throw std::runtime_error(std::format("Invalid line range in '{}'", line));
+    }
+
+    return FileChanges{.path = std::filesystem::path{line.substr(0, first)}, .lines = {range}};
+}
+
+auto merge(std::vector<FileChanges>& files, FileChanges changes) -> void
+{
+    const auto it = std::ranges::find(files, changes.path, &FileChanges::path);
+    if (it == files.end()) {
+        files.push_back(std::move(changes));
+        return;
+    }
+
+    it->lines.insert(it->lines.end(), changes.lines.begin(), changes.lines.end());
+}
+
+auto formatFile(const FileChanges& changes,
+                const common::Config& config,
+                std::optional<std::chrono::milliseconds> timeout) -> FileResult
+{
+    FileResult result{.path = changes.path};
+
+    try {
+        const auto cancellation = common::CancellationToken::withBudget(timeout);
+        result.source = readSource(changes.path);
+        result.formatted = formatRanges(result.source, changes.lines, config, cancellation);
+    }
+    catch (const common::Cancelled&) {
+        result.formatted = std::unexpected(FormatError{
+          std::format("Exceeded the time budget of {} ms", timeout.value_or({}).count())});
+    }
+    catch (const std::exception& e) {
+        result.formatted = std::unexpected(FormatError{e.what()});
+    }
+
+    return result;
+}
+
+} // namespace
+
+auto parseChanges(std::string_view text) -> std::vector<FileChanges>
+{
+    const auto lines = splitLines(text);
+    const auto is_diff =
+      std::ranges::any_of(lines, [](std::string_view line) { return line.starts_with("@@"); });
+
+    std::vector<FileChanges> files{};
+
+    if (!is_diff) {
+        for (const auto line : lines) {
+            if (!line.empty() && !line.starts_with('#')) {
+                merge(files, parseEntry(line));
+            }
+        }
+        return files;
+    }
+
+    std::filesystem::path current{};
+    for (const auto line : lines) {
+        if (line.starts_with("+++ ")) {
+            current = parseNewFile(line);
+        } else if (line.starts_with("@@") && !current.empty() && isVhdlFile(current)) {
+            merge(files, FileChanges{.path = current, .lines = {parseHunk(line)}});
+        }
+    }
+
+    return files;
+}
+
+auto formatChanges(std::span<const FileChanges> changes,
+                   const common::Config& config,
+                   unsigned jobs,
+                   std::optional<std::chrono::milliseconds> timeout_per_file)
+  -> std::vector<FileResult>
+{
+    std::vector<FileResult> results(changes.size());
+
+    const auto workers = std::min<std::size_t>(
+      changes.size(), jobs != 0 ? jobs : std::max(1U, std::thread::hardware_concurrency()));
+
+    std::atomic<std::size_t> next{0};
+    {
+        std::vector<std::jthread> pool{};
+        pool.reserve(workers);
+
+        for (std::size_t i = 0; i < workers; ++i) {
+            pool.emplace_back([&] {
+                for (auto k = next++; k < changes.size(); k = next++) {
+                    results.at(k) =
+                      formatFile(changes.subspan(k).front(), config, timeout_per_file);
+                }
+            });
+        }
+    }
+
+    return results;
+}
+
+} // namespace pipeline
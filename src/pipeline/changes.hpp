@@ -0,0 +1,55 @@
+#ifndef PIPELINE_CHANGES_HPP
+#define PIPELINE_CHANGES_HPP
+
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pipeline {
+
+/// @brief The changed lines of one file.
+struct FileChanges final
+{
+    std::filesystem::path path;
+    std::vector<LineRange> lines;
+};
+
+/// @brief Formatting outcome of one file.
+struct FileResult final
+{
+    std::filesystem::path path;
+    std::string source;
+    std::expected<std::string, FormatError> formatted{}; ///< Also carries read and syntax errors
+};
+
+/// @brief Collects the changed lines per file from a unified diff, as printed by `git diff`,
+///        or from lines of the form `path:first:last`.
+/// @note Only VHDL files (.vhd, .vhdl) are taken from a diff, and deleted files are skipped.
+///       Files listed more than once are merged, keeping the order of first appearance.
+/// @throws std::runtime_error on malformed input.
+[[nodiscard]]
+auto parseChanges(std::string_view text) -> std::vector<FileChanges>;
+
+/// @brief Formats only the design units overlapping the changed lines of every file.
+/// @note Files are spread over a pool of worker threads. The results keep the input order.
+/// @param jobs Number of workers; 0 uses one per hardware thread.
+/// @param timeout_per_file Time a file may take before it is given up and reported as an
+///        error, so that one pathological file cannot hold up the batch.
+[[nodiscard]]
+auto formatChanges(std::span<const FileChanges> changes,
+                   const common::Config& config,
+                   unsigned jobs = 0,
+                   std::optional<std::chrono::milliseconds> timeout_per_file = std::nullopt)
+  -> std::vector<FileResult>;
+
+} // namespace pipeline
+
+#endif /* PIPELINE_CHANGES_HPP */
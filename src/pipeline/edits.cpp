@@ -0,0 +1,203 @@
+#include "pipeline/edits.hpp"
+
+#include "emit/pretty_printer/renderer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pipeline {
+
+namespace {
+
+/// @brief A node's source bytes and the output bytes they rendered to.
+struct Region
+{
+    std::size_t source_begin;
+    std::size_t source_end;
+    std::size_t output_begin;
+    std::size_t output_end;
+    std::vector<Region> children{};
+};
+
+class EditCollector final
+{
+  public:
+    EditCollector(std::string_view source, std::string_view formatted) :
+      source_{source},
+      formatted_{formatted}
+    {}
+
+    auto collect(const Region& region) -> void
+    {
+        const auto before = slice(source_, region.source_begin, region.source_end);
+        const auto after = slice(formatted_, region.output_begin, region.output_end);
+        if (before == after) {
+            return;
+        }
+
+        if (!tiles(region)) {
+            replace(region.source_begin, region.source_end, region.output_begin, region.output_end);
+            return;
+        }
+
+        auto source_pos = region.source_begin;
+        auto output_pos = region.output_begin;
+
+        for (const auto& child : region.children) {
+            replace(source_pos, child.source_begin, output_pos, child.output_begin);
+            collect(child);
+            source_pos = child.source_end;
+            output_pos = child.output_end;
+        }
+
+        replace(source_pos, region.source_end, output_pos, region.output_end);
+    }
+
+    [[nodiscard]]
+    auto take() -> std::vector<TextEdit>
+    {
+        return std::move(edits_);
+    }
+
+  private:
+    std::string_view source_;
+    std::string_view formatted_;
+    std::vector<TextEdit> edits_{};
+
+    static auto slice(std::string_view text, std::size_t begin, std::size_t end)
+      -> std::string_view
+    {
+        return text.substr(begin, end - begin);
+    }
+
+    // Children must follow each other inside the parent on both sides to be diffed apart
+    static auto tiles(const Region& region) -> bool
+    {
+        if (region.children.empty()) {
+            return false;
+        }
+
+        auto source_pos = region.source_begin;
+        auto output_pos = region.output_begin;
+
+        for (const auto& child : region.children) {
+            if (child.source_begin < source_pos || child.source_end < child.source_begin
+                || child.output_begin < output_pos || child.output_end < child.output_begin)
+            {
+                return false;
+            }
+            source_pos = child.source_end;
+            output_pos = child.output_end;
+        }
+
+        return source_pos <= region.source_end && output_pos <= region.output_end;
+    }
+
+    auto replace(std::size_t source_begin,
+                 std::size_t source_end,
+                 std::size_t output_begin,
+                 std::size_t output_end) -> void
+    {
+        auto before = slice(source_, source_begin, source_end);
+        auto after = slice(formatted_, output_begin, output_end);
+
+        const auto prefix = static_cast<std::size_t>(
+          std::ranges::distance(before.begin(), std::ranges::mismatch(before, after).in1));
+        before.remove_prefix(prefix);
+        after.remove_prefix(prefix);
+
+        std::size_t suffix{0};
+        while (suffix < before.size() && suffix < after.size()
+               && before.at(before.size() - suffix - 1) == after.at(after.size() - suffix - 1))
+        {
+            ++suffix;
+        }
+        before.remove_suffix(suffix);
+        after.remove_suffix(suffix);
+
+        if (before.empty() && after.empty()) {
+            return;
+        }
+
+        const auto offset = source_begin + prefix;
+
+        // Touching edits are merged into one
+        if (!edits_.empty()) {
+            auto& last = edits_.back();
+            if (last.offset + last.length == offset) {
+                last.length += before.size();
+                last.replacement.append(after);
+                return;
+            }
+        }
+
+        edits_.push_back(
+          TextEdit{.offset = offset, .length = before.size(), .replacement = std::string{after}});
+    }
+};
+
+// Rebuilds the node nesting from the renderer's innermost-first spans
+auto buildRegions(std::span<const emit::OutputSpan> spans) -> std::vector<Region>
+{
+    std::vector<Region> stack{};
+
+    for (const auto& span : spans) {
+        Region region{.source_begin = span.source.begin,
+                      .source_end = span.source.end,
+                      .output_begin = span.begin,
+                      .output_end = span.end};
+
+        // Every finished node rendered inside this one is one of its children
+        const auto first_child = std::ranges::find_if(stack, [&span](const Region& child) {
+            return child.output_begin >= span.begin && child.output_end <= span.end;
+        });
+
+        region.children.assign(std::make_move_iterator(first_child),
+                               std::make_move_iterator(stack.end()));
+        stack.erase(first_child, stack.end());
+        stack.push_back(std::move(region));
+    }
+
+    return stack;
+}
+
+} // namespace
+
+auto computeEdits(std::string_view source,
+                  std::string_view formatted,
+                  std::span<const emit::OutputSpan> spans) -> std::vector<TextEdit>
+{
+    const Region root{.source_begin = 0,
+                      .source_end = source.size(),
+                      .output_begin = 0,
+                      .output_end = formatted.size(),
+                      .children = buildRegions(spans)};
+
+    EditCollector collector{source, formatted};
+    collector.collect(root);
+    return collector.take();
+}
+
+auto applyEdits(std::string_view source, std::span<const TextEdit> edits) -> std::string
+{
+    std::string result{};
+    result.reserve(source.size());
+
+    std::size_t pos{0};
+    for (const auto& edit : edits) {
+        result.append(source.substr(pos, edit.offset - pos));
+        result.append(edit.replacement);
+        pos = edit.offset + edit.length;
+    }
+    result.append(source.substr(pos));
+
+    return result;
+}
+
+} // namespace pipeline
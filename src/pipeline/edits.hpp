@@ -0,0 +1,41 @@
+#ifndef PIPELINE_EDITS_HPP
+#define PIPELINE_EDITS_HPP
+
+#include "emit/pretty_printer/renderer.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pipeline {
+
+/// @brief Replaces `length` bytes of the source at `offset`.
+struct TextEdit final
+{
+    std::size_t offset;
+    std::size_t length;
+    std::string replacement;
+};
+
+/// @brief Derives the edits that turn the source into its formatted text.
+///
+/// The output spans pair every node's source bytes with the bytes it rendered to. Nodes
+/// whose text did not change are skipped whole, and changed ones are descended into so
+/// that only the gaps between their children, or leaves, produce edits. Every edit is
+/// trimmed to the bytes that actually differ, and touching edits are merged.
+/// @param spans Output spans as reported by the renderer (innermost first).
+/// @return Edits sorted by offset, not overlapping, relative to the original source.
+[[nodiscard]]
+auto computeEdits(std::string_view source,
+                  std::string_view formatted,
+                  std::span<const emit::OutputSpan> spans) -> std::vector<TextEdit>;
+
+/// @brief Applies edits produced by computeEdits().
+[[nodiscard]]
+auto applyEdits(std::string_view source, std::span<const TextEdit> edits) -> std::string;
+
+} // namespace pipeline
+
+#endif /* PIPELINE_EDITS_HPP */
@@ -0,0 +1,738 @@
+#include "pipeline/format.hpp"
+
+#include "ast/nodes/design_file.hpp"
+#include "ast/nodes/design_units.hpp"
+#include "builder/ast_builder.hpp"
+#include "builder/token_store.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+#include "builder/verifier.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "common/stats.hpp"
+#include "emit/format.hpp"
+#include "pipeline/edits.hpp"
+#include "pipeline/render_cache.hpp"
+#include "vhdlLexer.h"
+
+#include <algorithm>
+#include <antlr4-runtime/Token.h>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace pipeline {
+
+namespace {
+
+// ANTLR indexes characters by code point, while chunks are cut by byte offset
+auto toByteOffsets(std::string_view source, const std::vector<std::size_t>& code_points)
+  -> std::vector<std::size_t>
+{
+    constexpr unsigned char CONTINUATION_MASK = 0xC0U;
+    constexpr unsigned char CONTINUATION_BITS = 0x80U;
+
+    const auto is_continuation = [&source](std::size_t byte) -> bool {
+        return (static_cast<unsigned char>(source.at(byte)) & CONTINUATION_MASK)
+            == CONTINUATION_BITS;
+    };
+
+    std::vector<std::size_t> offsets{};
+    offsets.reserve(code_points.size());
+
+    std::size_t code_point{0};
+    std::size_t byte{0};
+
+    for (const auto target : code_points) {
+        while (code_point < target && byte < source.size()) {
+            ++byte;
+            while (byte < source.size() && is_continuation(byte)) {
+                ++byte;
+            }
+            ++code_point;
+        }
+        offsets.push_back(byte);
+    }
+
+    return offsets;
+}
+
+/// @brief Half-open byte range of the source.
+struct ByteRange
+{
+    std::size_t begin;
+    std::size_t end;
+
+    [[nodiscard]]
+    auto overlaps(ByteRange other) const -> bool
+    {
+        return begin < other.end && other.begin < end;
+    }
+};
+
+// Byte offset at which the 1-based line starts, or the end of the source past the last line
+auto lineOffset(std::string_view source, std::size_t line) -> std::size_t
+{
+    std::size_t offset{0};
+
+    for (std::size_t current = 1; current < line; ++current) {
+        const auto newline = source.find('\n', offset);
+        if (newline == std::string_view::npos) {
+            return source.size();
+        }
+        offset = newline + 1;
+    }
+
+    return offset;
+}
+
+// Keywords that can open a design unit, either its context clause or the library unit
+auto opensUnit(std::size_t type) -> bool
+{
+    switch (type) {
+        case vhdlLexer::LIBRARY:
+        case vhdlLexer::USE:
+        case vhdlLexer::ENTITY:
+        case vhdlLexer::ARCHITECTURE:
+        case vhdlLexer::PACKAGE:
+        case vhdlLexer::CONFIGURATION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// A design unit can only start at the top of the file or right after an `end ... ;`. This
+// also accepts `use` clauses following a nested `end ... ;` inside a declarative part; such
+// a split leaves an unmatched `end` behind, so the chunk fails to parse instead of
+// formatting wrongly.
+auto candidateBoundaries(const std::vector<antlr4::Token*>& tokens) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> boundaries{0};
+
+    bool statement_start{true};
+    bool after_end{false};
+    std::size_t statement_type{0};
+
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        const auto* token = tokens.at(i);
+        if (token->getChannel() != antlr4::Token::DEFAULT_CHANNEL
+            || token->getType() == antlr4::Token::EOF)
+        {
+            continue;
+        }
+
+        const auto type = token->getType();
+
+        if (statement_start) {
+            if (after_end && opensUnit(type)) {
+                boundaries.push_back(i);
+            }
+            statement_type = type;
+            statement_start = false;
+        }
+
+        if (type == vhdlLexer::SEMI) {
+            after_end = statement_type == vhdlLexer::END;
+            statement_start = true;
+        }
+    }
+
+    return boundaries;
+}
+
+// Byte offsets at which the scan lets a design unit start; the first is always 0
+auto unitOffsets(std::string_view source) -> std::vector<std::size_t>
+{
+    // Lexing alone is enough to cut the file into chunks
+    const auto ctx = builder::createContext(source);
+    const auto tokens = ctx.tokens->getTokens();
+    const auto boundaries = candidateBoundaries(tokens);
+
+    std::vector<std::size_t> code_points{};
+    code_points.reserve(boundaries.size());
+    for (const auto index : boundaries) {
+        code_points.push_back(tokens.at(index)->getStartIndex());
+    }
+
+    auto offsets = toByteOffsets(source, code_points);
+    offsets.front() = 0;
+    return offsets;
+}
+
+// Swaps the units touched by a selection for their formatted text and keeps the others
+// verbatim; `offset` is where the units' text starts in the source
+auto splice(std::string_view text,
+            std::size_t offset,
+            const std::vector<FormattedUnit>& units,
+            std::span<const ByteRange> selected) -> std::string
+{
+    if (units.empty()) {
+        return std::string{text};
+    }
+
+    std::string result{};
+    result.reserve(text.size());
+
+    for (const auto& unit : units) {
+        const ByteRange chunk{.begin = offset, .end = offset + unit.source.size()};
+        const auto touched = std::ranges::any_of(
+          selected, [&chunk](const ByteRange& range) { return chunk.overlaps(range); });
+
+        result += touched ? unit.formatted : unit.source;
+        offset = chunk.end;
+    }
+
+    return result;
+}
+
+// What the one-shot entry points keep of the parse; the parse tree went with its context
+struct Parsed
+{
+    ast::DesignFile root;
+    std::vector<builder::verify::SemanticToken> tokens; ///< For verifying the output
+};
+
+auto parse(std::string_view source, const common::CancellationToken& cancellation) -> Parsed
+{
+    auto ctx = builder::createContext(source);
+    ctx.cancellation = cancellation;
+
+    auto root = builder::build(ctx);
+    const auto tokens = ctx.tokens->getTokens();
+
+    return Parsed{.root = std::move(root), .tokens = builder::verify::collectSemantic(tokens)};
+}
+
+// Same text as emit::format() on the design file, but unchanged units come from the cache.
+// Takes the AST by value and releases every unit as soon as it has been rendered.
+auto render(ast::DesignFile root,
+            const common::Config& config,
+            const common::CancellationToken& cancellation) -> std::string
+{
+    if (root.units.empty()) {
+        return emit::format(root, config, cancellation);
+    }
+
+    auto& cache = RenderCache::instance();
+
+    std::string result{};
+    for (auto& unit : root.units) {
+        // Same layout as the design file printer: every unit ends with a line break
+        result += cache.render(unit, config, cancellation);
+        result += '\n';
+        unit = {};
+    }
+
+    return result;
+}
+
+// `original` holds live tokens or semantic ones collected before their stream was released
+template<typename Original>
+auto verify(std::span<Original> original, std::string_view formatted, builder::Context& ctx)
+  -> std::expected<void, FormatError>
+{
+    // Lexing the output is part of verifying it
+    const common::stats::Timer timer{common::stats::Phase::VERIFY, common::stats::Scope::INCLUSIVE};
+
+    builder::loadContext(ctx, formatted);
+    const auto tokens = ctx.tokens->getTokens();
+
+    if (const auto result = builder::verify::ensureSafety(original, std::span{tokens}); !result) {
+        return std::unexpected(FormatError{result.error().message});
+    }
+
+    return {};
+}
+
+template<typename Original>
+auto verify(std::span<Original> original, std::string_view formatted)
+  -> std::expected<void, FormatError>
+{
+    builder::Context ctx{};
+    return verify(original, formatted, ctx);
+}
+
+// Splits an already lexed source into units and formats and verifies each of them; units
+// are rendered through the render cache unless `cached` is false
+auto formatUnits(std::string_view source,
+                 builder::Context& ctx,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation,
+                 bool cached = true) -> std::expected<std::vector<FormattedUnit>, FormatError>
+{
+    ctx.cancellation = cancellation;
+
+    std::vector<ast::DesignUnit> units{};
+    std::vector<std::size_t> first_tokens{};
+
+    builder::buildIncremental(ctx, [&](ast::DesignUnit unit, builder::TokenSpan span) {
+        units.push_back(std::move(unit));
+        first_tokens.push_back(span.start);
+    });
+
+    if (units.empty()) {
+        return std::vector<FormattedUnit>{};
+    }
+
+    // The first chunk also owns the trivia at the top of the file
+    first_tokens.front() = 0;
+
+    std::vector<std::size_t> code_points{};
+    code_points.reserve(first_tokens.size());
+    for (const auto index : first_tokens) {
+        code_points.push_back(ctx.tokens->get(index)->getStartIndex());
+    }
+
+    auto offsets = toByteOffsets(source, code_points);
+    offsets.push_back(source.size());
+    first_tokens.push_back(ctx.tokens->size());
+
+    const auto tokens = ctx.tokens->getTokens();
+    const std::span all_tokens{tokens};
+
+    std::vector<FormattedUnit> result{};
+    result.reserve(units.size());
+
+    for (std::size_t k = 0; k < units.size(); ++k) {
+        // Same layout as the design file printer: every unit ends with a line break
+        auto formatted = cached ? RenderCache::instance().render(units.at(k), config, cancellation)
+                                : emit::format(units.at(k), config, cancellation);
+        formatted += '\n';
+
+        const auto unit_tokens =
+          all_tokens.subspan(first_tokens.at(k), first_tokens.at(k + 1) - first_tokens.at(k));
+        if (auto verified = verify(unit_tokens, formatted); !verified) {
+            return std::unexpected(std::move(verified.error()));
+        }
+
+        result.push_back(FormattedUnit{
+          .source = std::string{source.substr(offsets.at(k), offsets.at(k + 1) - offsets.at(k))},
+          .ast = std::move(units.at(k)),
+          .formatted = std::move(formatted),
+        });
+    }
+
+    return result;
+}
+
+} // namespace
+
+auto readSource(const std::filesystem::path& path) -> std::string
+{
+    const common::stats::Timer timer{common::stats::Phase::READ};
+
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error(std::format("Failed to open input file: {}", path.string()));
+    }
+
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+auto writeSource(const std::filesystem::path& path, std::string_view text) -> void
+{
+    static_cast<void>(writeSource(path, [text](std::ostream& file) {
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return true;
+    }));
+}
+
+auto writeSource(const std::filesystem::path& path,
+                 const std::function<bool(std::ostream&)>& write) -> bool
+{
+    // Formatting inside the callback is charged to its own phases
+    const common::stats::Timer timer{common::stats::Phase::WRITE};
+
+    // Same directory, so the rename cannot cross file systems; hidden and without a VHDL
+    // extension, so watchers filtering on either ignore it
+    auto temporary = path;
+    temporary.replace_filename(std::format(".{}.vhdl-fmt~", path.filename().string()));
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error(
+              std::format("Failed to open temporary file: {}", temporary.string()));
+        }
+
+        const auto discard = [&file, &temporary] {
+            file.close();
+            std::error_code ignored{};
+            std::filesystem::remove(temporary, ignored);
+        };
+
+        auto keep = false;
+        try {
+            keep = write(file);
+            file.flush();
+        }
+        catch (...) {
+            discard();
+            throw;
+        }
+
+        if (!keep) {
+            discard();
+            return false;
+        }
+
+        if (!file) {
+            discard();
+            throw std::runtime_error(
+              std::format("Failed to write temporary file: {}", temporary.string()));
+        }
+    }
+
+    std::error_code ec{};
+    const auto permissions = std::filesystem::status(path, ec).permissions();
+    if (!ec) {
+        std::filesystem::permissions(temporary, permissions, ec);
+    }
+
+    std::filesystem::rename(temporary, path);
+    return true;
+}
+
+auto isVhdlFile(const std::filesystem::path& path) -> bool
+{
+    auto extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) -> char {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    return extension == ".vhd" || extension == ".vhdl";
+}
+
+auto formatSource(std::string_view source,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation)
+  -> std::expected<std::string, FormatError>
+{
+    // Each phase releases what the next does not need: the parse tree and token stream go
+    // with the context once the AST is built, the AST goes unit by unit while rendering
+    auto [root, tokens] = parse(source, cancellation);
+    const auto formatted = render(std::move(root), config, cancellation);
+
+    builder::Context output{};
+    if (auto verified = verify(std::span{std::as_const(tokens)}, formatted, output); !verified) {
+        return std::unexpected(std::move(verified.error()));
+    }
+
+    return formatted;
+}
+
+auto formatSource(std::string_view source,
+                  const common::Config& config,
+                  Workspace& workspace,
+                  const common::CancellationToken& cancellation)
+  -> std::expected<std::string, FormatError>
+{
+    builder::loadContext(workspace.source, source);
+    workspace.source.cancellation = cancellation;
+    auto root = builder::build(workspace.source);
+
+    // The tokens stay for verification, the parse tree is not needed any more
+    workspace.source.parser->reset();
+
+    auto formatted = render(std::move(root), config, cancellation);
+
+    const auto tokens = workspace.source.tokens->getTokens();
+    if (auto verified = verify(std::span{tokens}, formatted, workspace.output); !verified) {
+        return std::unexpected(std::move(verified.error()));
+    }
+
+    return formatted;
+}
+
+auto formatEdits(std::string_view source,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<TextEdit>, FormatError>
+{
+    auto [root, tokens] = parse(source, cancellation);
+    const auto rendered = emit::formatWithSpans(root, config, cancellation);
+    root = {};
+
+    if (auto verified = verify(std::span{std::as_const(tokens)}, rendered.text); !verified) {
+        return std::unexpected(std::move(verified.error()));
+    }
+
+    return computeEdits(source, rendered.text, rendered.spans);
+}
+
+auto formatVariants(std::string_view source,
+                    std::span<const common::Config> configs,
+                    unsigned jobs,
+                    const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<emit::Variant>, FormatError>
+{
+    auto [root, tokens] = parse(source, cancellation);
+    auto variants = emit::formatVariants(root, configs, jobs, cancellation);
+    root = {};
+
+    builder::Context output{};
+    for (const auto& variant : variants) {
+        if (auto verified = verify(std::span{std::as_const(tokens)}, variant.text, output);
+            !verified)
+        {
+            return std::unexpected(std::move(verified.error()));
+        }
+    }
+
+    return variants;
+}
+
+auto explainLayout(std::string_view source,
+                   const common::Config& config,
+                   const common::CancellationToken& cancellation) -> std::string
+{
+    const auto root = parse(source, cancellation).root;
+    const auto decisions = emit::explainLayout(root, config, cancellation);
+
+    // Offsets of the line starts, to find the line of a byte offset
+    std::vector<std::size_t> line_starts{0};
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        if (source.at(i) == '\n') {
+            line_starts.push_back(i + 1);
+        }
+    }
+
+    std::string result = std::format(
+      "{:>7} {:>9} {:<7} {:>6} {:>5}\n", "source", "output", "group", "width", "room");
+
+    for (const auto& decision : decisions) {
+        const auto source_line =
+          decision.source.empty()
+            ? std::string{"-"}
+            : std::to_string(std::ranges::upper_bound(line_starts, decision.source.begin)
+                             - line_starts.begin());
+        const auto position = std::format("{}:{}", decision.line + 1, decision.column + 1);
+        const auto width =
+          decision.width < 0 ? std::string{"hard"} : std::to_string(decision.width);
+
+        result += std::format("{:>7} {:>9} {:<7} {:>6} {:>5}\n",
+                              source_line,
+                              position,
+                              decision.flat ? "flat" : "broken",
+                              width,
+                              decision.remaining);
+    }
+
+    return result;
+}
+
+auto formatUnits(std::string_view source,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<FormattedUnit>, FormatError>
+{
+    auto ctx = builder::createContext(source);
+    return formatUnits(source, ctx, config, cancellation);
+}
+
+auto formatUnits(const builder::TokenStore& store,
+                 std::size_t begin,
+                 std::size_t end,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation)
+  -> std::expected<std::vector<FormattedUnit>, FormatError>
+{
+    auto ctx = builder::createContext(store, begin, end);
+    const auto text = std::string_view{store.text()}.substr(begin, end - begin);
+    return formatUnits(text, ctx, config, cancellation);
+}
+
+auto formatRange(std::string_view source,
+                 LineRange lines,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation)
+  -> std::expected<std::string, FormatError>
+{
+    return formatRanges(source, std::array{lines}, config, cancellation);
+}
+
+auto formatRanges(std::string_view source,
+                  std::span<const LineRange> lines,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation)
+  -> std::expected<std::string, FormatError>
+{
+    std::vector<ByteRange> selected{};
+    selected.reserve(lines.size());
+    for (const auto& range : lines) {
+        selected.push_back(ByteRange{.begin = lineOffset(source, range.first),
+                                     .end = lineOffset(source, range.last + 1)});
+    }
+
+    auto offsets = unitOffsets(source);
+    offsets.push_back(source.size());
+
+    // Runs of adjacent touched chunks are parsed together, untouched ones not at all
+    std::vector<ByteRange> regions{};
+    for (std::size_t k = 0; k + 1 < offsets.size(); ++k) {
+        const ByteRange chunk{.begin = offsets.at(k), .end = offsets.at(k + 1)};
+        const auto touched = std::ranges::any_of(
+          selected, [&chunk](const ByteRange& range) { return chunk.overlaps(range); });
+
+        if (!touched || chunk.begin == chunk.end) {
+            continue;
+        }
+
+        if (!regions.empty() && regions.back().end == chunk.begin) {
+            regions.back().end = chunk.end;
+        } else {
+            regions.push_back(chunk);
+        }
+    }
+
+    if (regions.empty()) {
+        return std::string{source};
+    }
+
+    try {
+        std::string result{};
+        result.reserve(source.size());
+        std::size_t pos{0};
+
+        for (const auto& region : regions) {
+            const auto text = source.substr(region.begin, region.end - region.begin);
+            const auto units = formatUnits(text, config, cancellation);
+            if (!units) {
+                return std::unexpected(units.error());
+            }
+
+            result.append(source.substr(pos, region.begin - pos));
+            result.append(splice(text, region.begin, *units, selected));
+            pos = region.end;
+        }
+
+        result.append(source.substr(pos));
+        return result;
+    }
+    catch (const std::runtime_error&) {
+        if (regions.front().begin == 0 && regions.front().end == source.size()) {
+            throw;
+        }
+    }
+
+    // The scan split a unit at a nested `end ... ;`, so let the full parse find the units
+    const auto units = formatUnits(source, config, cancellation);
+    if (!units) {
+        return std::unexpected(units.error());
+    }
+    return splice(source, 0, *units, selected);
+}
+
+auto formatStream(std::istream& input,
+                  std::ostream& output,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation,
+                  std::size_t block_size) -> std::expected<void, FormatError>
+{
+    // Chunks joined to the one at the front of `pending` after it failed to parse
+    constexpr std::size_t MAX_CHUNK_JOINS{2};
+
+    std::string pending{};
+    std::size_t joins{0};
+    auto at_end = false;
+
+    while (!at_end) {
+        // Read at least as much as is pending, so a unit spanning many blocks is lexed a
+        // logarithmic number of times rather than once per block
+        const auto old_size = pending.size();
+        const auto wanted = std::max(block_size, old_size);
+        {
+            const common::stats::Timer timer{common::stats::Phase::READ};
+            pending.resize(old_size + wanted);
+            input.read(std::span{pending}.subspan(old_size).data(),
+                       static_cast<std::streamsize>(wanted));
+            pending.resize(old_size + static_cast<std::size_t>(input.gcount()));
+            if (input.bad()) {
+                throw std::runtime_error("Failed to read the input");
+            }
+            at_end = !input;
+        }
+
+        // Tokens end before a line break, so whole lines lex as they would in the full file
+        const auto newline = pending.rfind('\n');
+        const auto complete =
+          at_end ? pending.size() : (newline == std::string::npos ? 0 : newline + 1);
+
+        auto offsets = unitOffsets(std::string_view{pending}.substr(0, complete));
+        if (at_end) {
+            offsets.push_back(pending.size());
+        }
+
+        // Every chunk but the last is complete; the last is kept until more has been read.
+        // Joins carried over from the previous read already failed, so they are not retried.
+        std::size_t start{0};
+        for (std::size_t k = joins + 1; k < offsets.size(); ++k) {
+            const auto text = std::string_view{pending}.substr(start, offsets.at(k) - start);
+
+            std::optional<std::vector<FormattedUnit>> units{};
+            try {
+                auto ctx = builder::createContext(text);
+                auto formatted = formatUnits(text, ctx, config, cancellation, false);
+                if (!formatted) {
+                    return std::unexpected(std::move(formatted.error()));
+                }
+                units = std::move(*formatted);
+            }
+            catch (const std::runtime_error&) {
+                // The scan may have split a unit at a nested `end ... ;`, so join the next
+                // chunk; past a few joins it is a real syntax error, reported right away
+                if (joins == MAX_CHUNK_JOINS || (at_end && k + 1 == offsets.size())) {
+                    throw;
+                }
+                ++joins;
+                continue;
+            }
+            joins = 0;
+
+            // Only a file without any design unit has a chunk without one
+            if (units->empty()) {
+                auto formatted = formatSource(text, config, cancellation);
+                if (!formatted) {
+                    return std::unexpected(std::move(formatted.error()));
+                }
+                const common::stats::Timer timer{common::stats::Phase::WRITE};
+                output << *formatted;
+            }
+
+            {
+                const common::stats::Timer timer{common::stats::Phase::WRITE};
+                for (const auto& unit : *units) {
+                    output << unit.formatted;
+                }
+            }
+            start = offsets.at(k);
+        }
+
+        pending.erase(0, start);
+    }
+
+    if (!output.flush()) {
+        throw std::runtime_error("Failed to write the formatted output");
+    }
+
+    return {};
+}
+
+} // namespace pipeline
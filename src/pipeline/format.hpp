@@ -0,0 +1,207 @@
+#ifndef PIPELINE_FORMAT_HPP
+#define PIPELINE_FORMAT_HPP
+
+#include "ast/nodes/design_units.hpp"
+#include "builder/ast_builder.hpp"
+#include "builder/token_store.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "emit/pretty_printer/variants.hpp"
+#include "pipeline/edits.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pipeline {
+
+/// @brief The formatter's output failed the token-equivalence check.
+struct FormatError final
+{
+    std::string message;
+};
+
+/// @brief One design unit, formatted on its own.
+///
+/// A unit's chunk starts at its first token and runs up to the first token of the next
+/// unit; the first chunk also owns any trivia at the top of the file. Trivia between two
+/// units binds to the earlier one, so formatting every chunk standalone and concatenating
+/// the results reproduces formatSource() on the whole file.
+struct FormattedUnit final
+{
+    std::string source;    ///< The chunk as it appears in the input
+    ast::DesignUnit ast;   ///< Translated unit
+    std::string formatted; ///< Rendered chunk, including its trailing newline
+};
+
+/// @brief Recognizers and buffers that formatSource() can reuse from one call to the next:
+///        one context for the source and one for re-lexing the output during verification.
+struct Workspace final
+{
+    builder::Context source{};
+    builder::Context output{};
+};
+
+/// @brief Inclusive, 1-based range of source lines.
+struct LineRange final
+{
+    std::size_t first;
+    std::size_t last;
+};
+
+/// @brief Reads a whole source file.
+/// @throws std::runtime_error if the file cannot be opened.
+[[nodiscard]]
+auto readSource(const std::filesystem::path& path) -> std::string;
+
+/// @brief Replaces a file's content through a temporary file and a rename, so that readers and
+///        file watchers never see it half written. The file keeps its permissions.
+/// @throws std::runtime_error if the temporary file cannot be written.
+auto writeSource(const std::filesystem::path& path, std::string_view text) -> void;
+
+/// @brief writeSource() for content that is produced piece by piece into the stream.
+/// @return Whether the file was replaced; it is left alone if `write` returns false or throws.
+/// @throws std::runtime_error if the temporary file cannot be written.
+auto writeSource(const std::filesystem::path& path,
+                 const std::function<bool(std::ostream&)>& write) -> bool;
+
+/// @brief Whether the path has a VHDL extension (.vhd, .vhdl, in any case).
+[[nodiscard]]
+auto isVhdlFile(const std::filesystem::path& path) -> bool;
+
+/// @brief Parses, formats and verifies a whole file.
+/// @note Each phase frees what the next one does not need: the parse tree and token stream
+///       once the AST is built, the AST unit by unit as it is printed. Verification works on
+///       a compact copy of the semantic tokens.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatSource(std::string_view source,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation = {})
+  -> std::expected<std::string, FormatError>;
+
+/// @brief formatSource() that keeps its lexer, parser and token buffers in the workspace, so
+///        a caller formatting many files sets them up only once.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatSource(std::string_view source,
+                  const common::Config& config,
+                  Workspace& workspace,
+                  const common::CancellationToken& cancellation = {})
+  -> std::expected<std::string, FormatError>;
+
+/// @brief Parses, formats and verifies a whole file, and returns the edits that turn the
+///        source into the formatted text instead of the text itself.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatEdits(std::string_view source,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation = {})
+  -> std::expected<std::vector<TextEdit>, FormatError>;
+
+/// @brief Parses a whole file once and formats and verifies it under every configuration,
+///        for tools that compare styles. Variants come back in the order of the configs.
+/// @param jobs Number of threads rendering the variants; 0 uses one per hardware thread.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatVariants(std::string_view source,
+                    std::span<const common::Config> configs,
+                    unsigned jobs = 1,
+                    const common::CancellationToken& cancellation = {})
+  -> std::expected<std::vector<emit::Variant>, FormatError>;
+
+/// @brief Parses and formats a whole file and explains every choice the renderer made
+///        between printing a group on one line and breaking it, for `--explain-layout`.
+/// @return One line per decision: the source line of the innermost node around the group,
+///         where the group starts in the output, the decision, and the width the group
+///         needs flat against the room left on the line.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto explainLayout(std::string_view source,
+                   const common::Config& config,
+                   const common::CancellationToken& cancellation = {}) -> std::string;
+
+/// @brief Parses the source one design unit at a time and formats and verifies every unit
+///        separately, so callers can cache and splice the results per unit.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatUnits(std::string_view source,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation = {})
+  -> std::expected<std::vector<FormattedUnit>, FormatError>;
+
+/// @brief formatUnits() over the bytes [begin, end) of a buffer that is already lexed, so
+///        that only the parser runs.
+/// @throws std::runtime_error on syntax errors, or if the range cuts through a token.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatUnits(const builder::TokenStore& store,
+                 std::size_t begin,
+                 std::size_t end,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation = {})
+  -> std::expected<std::vector<FormattedUnit>, FormatError>;
+
+/// @brief Formats only the design units that overlap the given lines and splices them
+///        back into the otherwise untouched source.
+/// @note Unit boundaries are found with a token scan, so only the selected units are
+///       parsed, rendered and verified. Should the scan have cut a unit in two, the whole
+///       file is parsed once to find the real boundaries.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatRange(std::string_view source,
+                 LineRange lines,
+                 const common::Config& config,
+                 const common::CancellationToken& cancellation = {})
+  -> std::expected<std::string, FormatError>;
+
+/// @brief formatRange() over several line ranges at once.
+/// @note Adjacent selected units are parsed together; units between two ranges are not
+///       parsed at all.
+/// @throws std::runtime_error on syntax errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatRanges(std::string_view source,
+                  std::span<const LineRange> lines,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation = {})
+  -> std::expected<std::string, FormatError>;
+
+/// @brief Smallest amount of input formatStream() reads at once.
+inline constexpr std::size_t STREAM_BLOCK_SIZE{1UZ << 20U};
+
+/// @brief Formats a source of any size one design unit at a time, writing every unit out as
+///        soon as it is verified and freeing it before the next one is read.
+///
+/// Input is read in blocks and only the lines read so far are lexed, to find where the next
+/// units start (see formatRange()). Peak memory follows the largest design unit instead of
+/// the file. The output matches formatSource(). Units do not go through the render cache,
+/// which would otherwise keep the whole output alive. A chunk that does not parse is joined
+/// with at most two following chunks, in case the scan cut a unit in two, before its syntax
+/// error is reported.
+/// @note On an error the output already holds the units before the failing one.
+/// @throws std::runtime_error on syntax errors and on read errors.
+/// @throws common::Cancelled once the token is cancelled.
+[[nodiscard]]
+auto formatStream(std::istream& input,
+                  std::ostream& output,
+                  const common::Config& config,
+                  const common::CancellationToken& cancellation = {},
+                  std::size_t block_size = STREAM_BLOCK_SIZE) -> std::expected<void, FormatError>;
+
+} // namespace pipeline
+
+#endif /* PIPELINE_FORMAT_HPP */
@@ -0,0 +1,140 @@
+#include "pipeline/render_cache.hpp"
+
+#include "ast/nodes/design_units.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "common/hash.hpp"
+#include "common/stats.hpp"
+#include "emit/format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace pipeline {
+
+namespace {
+
+auto hashConfig(const common::Config& config) -> std::uint64_t
+{
+    common::Fnv1a hash{};
+    hash.add(config.line_config.line_length)
+      .add(config.line_config.indent_size)
+      .add(config.indent_style)
+      .add(config.eol_format)
+      .add(config.port_map.align_signals)
+      .add(config.declarations.align_colons)
+      .add(config.declarations.align_types)
+      .add(config.declarations.align_initialization)
+      .add(config.casing.keywords)
+      .add(config.casing.constants)
+      .add(config.casing.identifiers)
+      .add(config.layout);
+    return hash.value();
+}
+
+auto cacheKey(std::uint64_t unit_hash, const common::Config& config) -> std::uint64_t
+{
+    return common::Fnv1a{}.add(unit_hash).add(hashConfig(config)).value();
+}
+
+} // namespace
+
+auto RenderCache::render(const ast::DesignUnit& unit,
+                         const common::Config& config,
+                         const common::CancellationToken& cancellation) -> std::string
+{
+    if (unit.hash == 0) {
+        return emit::format(unit, config, cancellation);
+    }
+
+    const auto key = cacheKey(unit.hash, config);
+
+    {
+        const std::scoped_lock lock{mutex_};
+        if (const auto* entry = lookup(key, unit.hash, config); entry != nullptr) {
+            ++stats_.hits;
+            common::stats::count(common::stats::Counter::RENDER_CACHE_HITS);
+            return entry->text;
+        }
+        ++stats_.misses;
+        common::stats::count(common::stats::Counter::RENDER_CACHE_MISSES);
+    }
+
+    // Rendered outside the lock so that workers formatting other files do not queue up
+    auto text = emit::format(unit, config, cancellation);
+
+    const std::scoped_lock lock{mutex_};
+    if (capacity_ == 0 || lookup(key, unit.hash, config) != nullptr) {
+        return text;
+    }
+
+    entries_.push_front(
+      Entry{.key = key, .unit_hash = unit.hash, .config = config, .text = text});
+    index_.emplace(key, entries_.begin());
+    evictLocked();
+
+    return text;
+}
+
+auto RenderCache::stats() -> RenderCacheStats
+{
+    const std::scoped_lock lock{mutex_};
+    auto result = stats_;
+    result.entries = entries_.size();
+    return result;
+}
+
+auto RenderCache::clear() -> void
+{
+    const std::scoped_lock lock{mutex_};
+    entries_.clear();
+    index_.clear();
+    stats_ = RenderCacheStats{};
+}
+
+auto RenderCache::setCapacity(std::size_t entries) -> void
+{
+    const std::scoped_lock lock{mutex_};
+    capacity_ = entries;
+    evictLocked();
+}
+
+auto RenderCache::lookup(std::uint64_t key, std::uint64_t unit_hash, const common::Config& config)
+  -> const Entry*
+{
+    // The full config is compared, so only a unit hash collision could serve a wrong entry
+    auto [first, last] = index_.equal_range(key);
+    for (; first != last; ++first) {
+        const auto it = first->second;
+        if (it->unit_hash == unit_hash && it->config == config) {
+            entries_.splice(entries_.begin(), entries_, it);
+            return &entries_.front();
+        }
+    }
+
+    return nullptr;
+}
+
+auto RenderCache::evictLocked() -> void
+{
+    while (entries_.size() > capacity_) {
+        const auto& oldest = entries_.back();
+
+        auto [first, last] = index_.equal_range(oldest.key);
+        for (; first != last; ++first) {
+            if (&*first->second == &oldest) {
+                index_.erase(first);
+                break;
+            }
+        }
+
+        entries_.pop_back();
+        ++stats_.evictions;
+        common::stats::count(common::stats::Counter::RENDER_CACHE_EVICTIONS);
+    }
+}
+
+} // namespace pipeline
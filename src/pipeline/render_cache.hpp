@@ -0,0 +1,100 @@
+#ifndef PIPELINE_RENDER_CACHE_HPP
+#define PIPELINE_RENDER_CACHE_HPP
+
+#include "ast/nodes/design_units.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pipeline {
+
+/// @brief Snapshot of the render cache counters.
+struct RenderCacheStats final
+{
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t evictions{0};
+    std::size_t entries{0};
+
+    /// @brief Fraction of lookups served from the cache, 0 before the first lookup.
+    [[nodiscard]]
+    auto hitRate() const -> double
+    {
+        const auto lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/// @brief Process-wide LRU of rendered design units, keyed by the unit's structural hash
+///        and the config it was rendered with.
+///
+/// Editors and watch loops reformat the same file over and over while only one unit
+/// changes; every other unit is then served verbatim without running the printer or the
+/// renderer. Units without a hash (not translated from a token stream) are always rendered.
+class RenderCache final
+{
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY{1024};
+
+    static auto instance() -> RenderCache&
+    {
+        static RenderCache instance;
+        return instance;
+    }
+
+    RenderCache(const RenderCache&) = delete;
+    auto operator=(const RenderCache&) -> RenderCache& = delete;
+    RenderCache(RenderCache&&) = delete;
+    auto operator=(RenderCache&&) -> RenderCache& = delete;
+    ~RenderCache() = default;
+
+    /// @brief Returns the unit's formatted text, rendering and storing it on a miss.
+    /// @throws common::Cancelled if the token is cancelled during a miss; nothing is stored.
+    [[nodiscard]]
+    auto render(const ast::DesignUnit& unit,
+                const common::Config& config,
+                const common::CancellationToken& cancellation = {}) -> std::string;
+
+    [[nodiscard]]
+    auto stats() -> RenderCacheStats;
+
+    /// @brief Drops every entry and resets the counters.
+    auto clear() -> void;
+
+    /// @brief Sets the maximum number of entries; 0 disables the cache.
+    auto setCapacity(std::size_t entries) -> void;
+
+  private:
+    RenderCache() = default;
+
+    struct Entry final
+    {
+        std::uint64_t key;
+        std::uint64_t unit_hash;
+        common::Config config;
+        std::string text;
+    };
+
+    // Caller holds `mutex_`
+    auto lookup(std::uint64_t key, std::uint64_t unit_hash, const common::Config& config)
+      -> const Entry*;
+    auto evictLocked() -> void;
+
+    std::mutex mutex_;
+    std::size_t capacity_{DEFAULT_CAPACITY};
+    RenderCacheStats stats_{};
+
+    // Most recently used first; the map points into the list
+    std::list<Entry> entries_{};
+    std::unordered_multimap<std::uint64_t, std::list<Entry>::iterator> index_{};
+};
+
+} // namespace pipeline
+
+#endif /* PIPELINE_RENDER_CACHE_HPP */
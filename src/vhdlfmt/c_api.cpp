@@ -0,0 +1,125 @@
+#include "vhdlfmt/formatter.hpp"
+#include "vhdlfmt/vhdlfmt.h"
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+struct vhdlfmt_formatter
+{
+    vhdlfmt::Formatter formatter;
+    std::string output{};
+    std::string error{};
+};
+
+namespace {
+
+auto statusOf(vhdlfmt::ErrorKind kind) -> vhdlfmt_status
+{
+    switch (kind) {
+        case vhdlfmt::ErrorKind::SYNTAX:
+            return VHDLFMT_SYNTAX_ERROR;
+        case vhdlfmt::ErrorKind::UNSAFE:
+            return VHDLFMT_UNSAFE;
+        case vhdlfmt::ErrorKind::CONFIG:
+            break;
+    }
+    return VHDLFMT_INTERNAL_ERROR;
+}
+
+} // namespace
+
+extern "C" {
+
+auto vhdlfmt_create() -> vhdlfmt_formatter*
+{
+    try {
+        return new vhdlfmt_formatter{.formatter = vhdlfmt::Formatter{}, .output = {}, .error = {}};
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+auto vhdlfmt_create_from_file(const char* config_path) -> vhdlfmt_formatter*
+{
+    try {
+        std::optional<std::filesystem::path> path{};
+        if (config_path != nullptr) {
+            path = std::filesystem::path{config_path};
+        }
+
+        auto formatter = vhdlfmt::Formatter::fromConfigFile(std::move(path));
+        if (!formatter) {
+            return nullptr;
+        }
+        return new vhdlfmt_formatter{.formatter = std::move(*formatter), .output = {}, .error = {}};
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+auto vhdlfmt_destroy(vhdlfmt_formatter* formatter) -> void
+{
+    delete formatter;
+}
+
+auto vhdlfmt_format(vhdlfmt_formatter* formatter,
+                    const char* source,
+                    std::size_t length,
+                    const char** output,
+                    std::size_t* output_length) -> vhdlfmt_status
+{
+    if (formatter == nullptr || (source == nullptr && length != 0) || output == nullptr
+        || output_length == nullptr)
+    {
+        if (formatter != nullptr) {
+            formatter->error = "Invalid argument";
+        }
+        return VHDLFMT_INVALID_ARGUMENT;
+    }
+
+    formatter->error.clear();
+
+    try {
+        const auto text = length == 0 ? std::string_view{} : std::string_view{source, length};
+
+        auto formatted = formatter->formatter.format(text);
+        if (!formatted) {
+            formatter->error = std::move(formatted.error().message);
+            return statusOf(formatted.error().kind);
+        }
+
+        // Reuse the session's buffer rather than handing out a fresh allocation per call
+        formatter->output.assign(*formatted);
+        *output = formatter->output.c_str();
+        *output_length = formatter->output.size();
+        return VHDLFMT_OK;
+    }
+    catch (const std::exception& e) {
+        formatter->error = e.what();
+        return VHDLFMT_INTERNAL_ERROR;
+    }
+    catch (...) {
+        formatter->error = "Unknown error";
+        return VHDLFMT_INTERNAL_ERROR;
+    }
+}
+
+auto vhdlfmt_set_prediction_cache_limit(std::size_t bytes) -> void
+{
+    vhdlfmt::Formatter::setPredictionCacheLimit(bytes);
+}
+
+auto vhdlfmt_last_error(const vhdlfmt_formatter* formatter) -> const char*
+{
+    return formatter == nullptr ? "" : formatter->error.c_str();
+}
+
+} // extern "C"
@@ -0,0 +1,63 @@
+#include "vhdlfmt/formatter.hpp"
+
+#include "builder/prediction_cache.hpp"
+#include "builder/warm_up.hpp"
+#include "cli/config_reader.hpp"
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace vhdlfmt {
+
+Formatter::Formatter(common::Config config) : config_{std::move(config)}
+{
+    static std::once_flag warmed_up{};
+    std::call_once(warmed_up, builder::warmUp);
+}
+
+auto Formatter::fromConfigFile(std::optional<std::filesystem::path> path)
+  -> std::expected<Formatter, Error>
+{
+    auto config = cli::ConfigReader{std::move(path)}.readConfigFile();
+    if (!config) {
+        return std::unexpected(Error{.kind = ErrorKind::CONFIG, .message = config.error().message});
+    }
+
+    return Formatter{*config};
+}
+
+auto Formatter::format(std::string_view source) -> std::expected<std::string, Error>
+{
+    try {
+        auto formatted = pipeline::formatSource(source, config_, workspace_);
+        if (!formatted) {
+            return std::unexpected(
+              Error{.kind = ErrorKind::UNSAFE, .message = std::move(formatted.error().message)});
+        }
+        return std::move(*formatted);
+    }
+    catch (const std::runtime_error& e) {
+        return std::unexpected(Error{.kind = ErrorKind::SYNTAX, .message = e.what()});
+    }
+}
+
+auto Formatter::setPredictionCacheLimit(std::size_t bytes) -> void
+{
+    builder::PredictionCache::instance().setCeiling(bytes);
+}
+
+auto Formatter::predictionCacheLimit() -> std::size_t
+{
+    return builder::PredictionCache::instance().ceiling();
+}
+
+} // namespace vhdlfmt
@@ -0,0 +1,74 @@
+#ifndef VHDLFMT_FORMATTER_HPP
+#define VHDLFMT_FORMATTER_HPP
+
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace vhdlfmt {
+
+enum class ErrorKind : std::uint8_t
+{
+    CONFIG, ///< The configuration file could not be read
+    SYNTAX, ///< The source is not valid VHDL
+    UNSAFE, ///< The output failed verification against the source
+};
+
+struct Error final
+{
+    ErrorKind kind;
+    std::string message;
+};
+
+/// @brief A formatting session for embedding the formatter in another program.
+///
+/// The session keeps its configuration, its lexer, parser and token buffers between calls,
+/// so formatting many sources pays for setting them up once. The parser's prediction caches
+/// and the unit render cache are shared by every session in the process and warmed up when
+/// the first one is created.
+///
+/// A session is not thread safe; give each thread its own.
+class Formatter final
+{
+  public:
+    explicit Formatter(common::Config config = {});
+
+    /// @brief A session configured from a YAML file, the way the command line reads it.
+    /// @param path The file to read, or nullopt for vhdl-fmt.yaml in the working directory.
+    [[nodiscard]]
+    static auto fromConfigFile(std::optional<std::filesystem::path> path)
+      -> std::expected<Formatter, Error>;
+
+    /// @brief Formats a whole file and verifies the result.
+    [[nodiscard]]
+    auto format(std::string_view source) -> std::expected<std::string, Error>;
+
+    /// @brief Bounds the shared prediction caches: past `bytes` they are cleared and warmed up
+    ///        again. 0 lets them grow without limit.
+    /// @note Applies to every session in the process; the default suits long-running hosts.
+    static auto setPredictionCacheLimit(std::size_t bytes) -> void;
+
+    [[nodiscard]]
+    static auto predictionCacheLimit() -> std::size_t;
+
+    [[nodiscard]]
+    auto config() const noexcept -> const common::Config&
+    {
+        return config_;
+    }
+
+  private:
+    common::Config config_;
+    pipeline::Workspace workspace_{};
+};
+
+} // namespace vhdlfmt
+
+#endif /* VHDLFMT_FORMATTER_HPP */
@@ -0,0 +1,52 @@
+#ifndef VHDLFMT_VHDLFMT_H
+#define VHDLFMT_VHDLFMT_H
+
+/* C interface to vhdlfmt::Formatter, for editors and tools that cannot link C++ directly. */
+
+#include <stddef.h> /* NOLINT(modernize-deprecated-headers) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct vhdlfmt_formatter vhdlfmt_formatter; /* NOLINT(modernize-use-using) */
+
+typedef enum /* NOLINT(modernize-use-using) */
+{
+    VHDLFMT_OK = 0,
+    VHDLFMT_SYNTAX_ERROR = 1,
+    VHDLFMT_UNSAFE = 2,
+    VHDLFMT_INVALID_ARGUMENT = 3,
+    VHDLFMT_INTERNAL_ERROR = 4
+} vhdlfmt_status;
+
+/* A session with the default configuration, or NULL if it could not be created. */
+vhdlfmt_formatter* vhdlfmt_create(void);
+
+/* A session configured from a YAML file; NULL selects vhdl-fmt.yaml in the working
+ * directory. Returns NULL if the file cannot be read. */
+vhdlfmt_formatter* vhdlfmt_create_from_file(const char* config_path);
+
+void vhdlfmt_destroy(vhdlfmt_formatter* formatter);
+
+/* Formats `length` bytes of `source`. On success `*output` points to `*output_length` bytes
+ * (NUL terminated) owned by the session, valid until the next call on it. */
+vhdlfmt_status vhdlfmt_format(vhdlfmt_formatter* formatter,
+                              const char* source,
+                              size_t length,
+                              const char** output,
+                              size_t* output_length);
+
+/* Clears the parser's prediction caches, shared by every session in the process, once they
+ * grow past `bytes`; 0 lets them grow without limit. The default suits long-running hosts. */
+void vhdlfmt_set_prediction_cache_limit(size_t bytes);
+
+/* Message for the last failed call on the session, or an empty string. Valid until the next
+ * call on it. */
+const char* vhdlfmt_last_error(const vhdlfmt_formatter* formatter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VHDLFMT_VHDLFMT_H */
@@ -0,0 +1,273 @@
+#include "watch/watcher.hpp"
+
+#include "builder/warm_up.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "common/hash.hpp"
+#include "common/logger.hpp"
+#include "pipeline/format.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <poll.h>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace watch {
+
+namespace {
+
+// Room for plenty of events per read; each carries a NUL padded file name
+constexpr std::size_t EVENT_BUFFER_SIZE = 64UZ * 1024;
+
+constexpr std::uint32_t FILE_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO;
+constexpr std::uint32_t WATCH_EVENTS = FILE_EVENTS | IN_CREATE | IN_DELETE_SELF | IN_ONLYDIR;
+
+auto hashText(std::string_view text) -> std::uint64_t
+{
+    return common::Fnv1a{}.add(text).value();
+}
+
+auto isHidden(const std::filesystem::path& path) -> bool
+{
+    return path.filename().string().starts_with('.');
+}
+
+auto systemError(std::string_view what) -> std::system_error
+{
+    return std::system_error{errno, std::generic_category(), std::string{what}};
+}
+
+} // namespace
+
+Watcher::Watcher(const std::filesystem::path& root,
+                 common::Config config,
+                 std::chrono::milliseconds debounce,
+                 std::optional<std::chrono::milliseconds> timeout_per_file) :
+  config_{config},
+  debounce_{debounce},
+  timeout_per_file_{timeout_per_file}
+{
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        throw systemError("inotify_init1");
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        const auto error = systemError("eventfd");
+        close(inotify_fd_);
+        throw error;
+    }
+
+    // Files that are already there are left alone until they are saved
+    std::set<std::string> existing{};
+    try {
+        addDirectory(root, existing);
+    }
+    catch (...) {
+        close(wake_fd_);
+        close(inotify_fd_);
+        throw;
+    }
+}
+
+Watcher::~Watcher()
+{
+    close(wake_fd_);
+    close(inotify_fd_);
+}
+
+auto Watcher::run() -> int
+{
+    builder::warmUp();
+
+    auto& logger = common::Logger::instance();
+    std::set<std::string> pending{};
+
+    while (true) {
+        std::array<pollfd, 2> fds{
+          pollfd{.fd = inotify_fd_, .events = POLLIN, .revents = 0},
+          pollfd{.fd = wake_fd_,    .events = POLLIN, .revents = 0},
+        };
+
+        // Block until something happens, or until a burst of saves has settled
+        const auto timeout = pending.empty() ? -1 : static_cast<int>(debounce_.count());
+        const auto ready = poll(fds.data(), fds.size(), timeout);
+
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.error("Watching failed: {}", std::strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        if ((fds.back().revents & POLLIN) != 0) {
+            return EXIT_SUCCESS;
+        }
+
+        if ((fds.front().revents & POLLIN) != 0) {
+            readEvents(pending);
+            continue;
+        }
+
+        for (const auto& path : std::exchange(pending, {})) {
+            formatFile(path);
+        }
+    }
+}
+
+auto Watcher::stop() noexcept -> void
+{
+    const std::uint64_t one{1};
+    static_cast<void>(write(wake_fd_, &one, sizeof(one)));
+}
+
+auto Watcher::addDirectory(const std::filesystem::path& directory, std::set<std::string>& pending)
+  -> void
+{
+    const auto wd = inotify_add_watch(inotify_fd_, directory.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+        throw systemError(std::format("Cannot watch {}", directory.string()));
+    }
+    directories_.insert_or_assign(wd, directory);
+
+    for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+        if (isHidden(entry.path())) {
+            continue;
+        }
+
+        if (entry.is_directory()) {
+            addDirectory(entry.path(), pending);
+        } else if (entry.is_regular_file() && pipeline::isVhdlFile(entry.path())) {
+            pending.insert(entry.path().string());
+        }
+    }
+}
+
+auto Watcher::readEvents(std::set<std::string>& pending) -> void
+{
+    alignas(inotify_event) std::array<std::byte, EVENT_BUFFER_SIZE> buffer{};
+
+    while (true) {
+        const auto length = read(inotify_fd_, buffer.data(), buffer.size());
+        if (length <= 0) {
+            return;
+        }
+
+        const auto events = std::span{buffer}.first(static_cast<std::size_t>(length));
+
+        for (std::size_t offset = 0; offset < events.size();) {
+            inotify_event event{};
+            std::memcpy(&event, events.subspan(offset).data(), sizeof(event));
+
+            // The name is padded with NULs up to `len`
+            std::string name{};
+            for (const auto byte : events.subspan(offset + sizeof(event), event.len)) {
+                if (byte == std::byte{0}) {
+                    break;
+                }
+                name.push_back(static_cast<char>(byte));
+            }
+            offset += sizeof(event) + event.len;
+
+            if ((event.mask & IN_Q_OVERFLOW) != 0) {
+                common::Logger::instance().warn("Too many changes at once, some saves were missed");
+                continue;
+            }
+
+            if ((event.mask & IN_IGNORED) != 0) {
+                directories_.erase(event.wd);
+                continue;
+            }
+
+            const auto directory = directories_.find(event.wd);
+            if (directory == directories_.end() || name.empty()) {
+                continue;
+            }
+
+            const auto path = directory->second / name;
+            if (isHidden(path)) {
+                continue;
+            }
+
+            if ((event.mask & IN_ISDIR) != 0) {
+                if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                    try {
+                        addDirectory(path, pending);
+                    }
+                    catch (const std::exception& e) {
+                        common::Logger::instance().warn("{}", e.what());
+                    }
+                }
+            } else if ((event.mask & FILE_EVENTS) != 0 && pipeline::isVhdlFile(path)) {
+                pending.insert(path.string());
+            }
+        }
+    }
+}
+
+auto Watcher::formatFile(const std::filesystem::path& path) -> void
+{
+    auto& logger = common::Logger::instance();
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        const auto source = pipeline::readSource(path);
+
+        // The rename that landed our own output
+        const auto hash = hashText(source);
+        if (const auto it = written_.find(path.string());
+            it != written_.end() && it->second == hash)
+        {
+            return;
+        }
+
+        const auto formatted = pipeline::formatSource(
+          source, config_, workspace_, common::CancellationToken::withBudget(timeout_per_file_));
+        if (!formatted) {
+            logger.error("{}: {}", path.string(), formatted.error().message);
+            return;
+        }
+
+        if (*formatted == source) {
+            written_.insert_or_assign(path.string(), hash);
+            return;
+        }
+
+        pipeline::writeSource(path, *formatted);
+        written_.insert_or_assign(path.string(), hashText(*formatted));
+
+        const std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+        logger.info("Formatted {} in {:.1f} ms", path.string(), elapsed.count());
+    }
+    catch (const common::Cancelled&) {
+        logger.error("{}: exceeded the time budget of {} ms, left untouched",
+                     path.string(),
+                     timeout_per_file_.value_or(std::chrono::milliseconds{}).count());
+    }
+    catch (const std::exception& e) {
+        // Mostly syntax errors in a file saved halfway through an edit
+        logger.warn("{}: {}", path.string(), e.what());
+    }
+}
+
+} // namespace watch
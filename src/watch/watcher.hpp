@@ -0,0 +1,82 @@
+#ifndef WATCH_WATCHER_HPP
+#define WATCH_WATCHER_HPP
+
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace watch {
+
+/// @brief Formats VHDL files below a directory whenever they are saved (Linux, inotify).
+///
+/// Saves are picked up as close-after-write events, or as a rename onto the file for
+/// editors that save through a temporary file. Events are collected until the tree has
+/// been quiet for the debounce period, then every saved file is formatted once. The
+/// parser's prediction caches and the unit render cache stay warm for the life of the
+/// process, so a save only parses the saved file and renders its changed units.
+///
+/// Results are written with pipeline::writeSource(). The rename that lands them is
+/// recognised by its content and does not trigger another round.
+class Watcher final
+{
+  public:
+    static constexpr std::chrono::milliseconds DEFAULT_DEBOUNCE{25};
+
+    /// @brief Starts watching the directory and every subdirectory but hidden ones.
+    /// @note Saves are recorded from here on, even before run() is called.
+    /// @param timeout_per_file Time a save may take to format before the file is left as is.
+    /// @throws std::system_error if inotify is unavailable.
+    Watcher(const std::filesystem::path& root,
+            common::Config config,
+            std::chrono::milliseconds debounce = DEFAULT_DEBOUNCE,
+            std::optional<std::chrono::milliseconds> timeout_per_file = std::nullopt);
+
+    ~Watcher();
+
+    Watcher(const Watcher&) = delete;
+    auto operator=(const Watcher&) -> Watcher& = delete;
+    Watcher(Watcher&&) = delete;
+    auto operator=(Watcher&&) -> Watcher& = delete;
+
+    /// @brief Formats saved files until stop() is called.
+    /// @return The process exit code.
+    [[nodiscard]]
+    auto run() -> int;
+
+    /// @brief Makes run() return; safe to call from another thread or a signal handler.
+    auto stop() noexcept -> void;
+
+  private:
+    int inotify_fd_{-1};
+    int wake_fd_{-1};
+    common::Config config_;
+    std::chrono::milliseconds debounce_;
+    std::optional<std::chrono::milliseconds> timeout_per_file_;
+    pipeline::Workspace workspace_{};
+
+    std::unordered_map<int, std::filesystem::path> directories_{};
+
+    /// Hash of the text last written to each file, to ignore our own renames
+    std::unordered_map<std::string, std::uint64_t> written_{};
+
+    /// @brief Watches the directory and its subdirectories and queues the VHDL files already
+    ///        in them, which may have been saved before the watch was in place.
+    auto addDirectory(const std::filesystem::path& directory, std::set<std::string>& pending)
+      -> void;
+
+    /// @brief Drains the inotify queue into the set of saved files.
+    auto readEvents(std::set<std::string>& pending) -> void;
+
+    auto formatFile(const std::filesystem::path& path) -> void;
+};
+
+} // namespace watch
+
+#endif /* WATCH_WATCHER_HPP */
@@ -0,0 +1,135 @@
+#include "builder/ast_builder.hpp"
+#include "builder/expression_parser.hpp"
+#include "builder/translator.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/// @brief Formats the code, translating expressions with or without the fast path.
+auto formatWith(std::string_view code, bool fast_expressions) -> std::string
+{
+    try {
+        auto ctx = builder::createContext(code);
+        auto* tree = builder::parse(ctx);
+        const auto root = builder::Translator{*ctx.tokens, fast_expressions}.buildDesignFile(tree);
+        return emit::format(root, common::Config{});
+    }
+    catch (const std::exception& e) {
+        return std::format("error: {}", e.what());
+    }
+}
+
+/// @brief Runs the fast path alone over a standalone expression.
+auto parseFast(std::string_view expr) -> bool
+{
+    auto ctx = builder::createContext(expr);
+    builder::TriviaBinder trivia{*ctx.tokens};
+    builder::ExpressionParser parser{*ctx.tokens, trivia};
+
+    // The last token is EOF
+    return parser.parse(0, ctx.tokens->size() - 2).has_value();
+}
+
+} // namespace
+
+TEST_CASE("ExpressionParser accepts common expressions", "[expressions][fast_path]")
+{
+    const auto expr = GENERATE(as<std::string_view>{},
+                               "a",
+                               "a + b * c",
+                               "-a + b",
+                               "not a and b",
+                               "abs x + 2 ** n",
+                               "a = b or c /= d",
+                               "x sll 2",
+                               "10 ns",
+                               "rising_edge(clk)",
+                               "resize(unsigned(data), 16)",
+                               "data(7 downto 0)",
+                               "mem(i)(j)",
+                               "work.pkg.func(a)",
+                               "data'length",
+                               "sig'stable(5 ns)",
+                               "(a + b) * c",
+                               "(a, b)",
+                               "x\"FF\" & '0'");
+
+    INFO(expr);
+    CHECK(parseFast(expr));
+}
+
+TEST_CASE("ExpressionParser declines unsupported expressions", "[expressions][fast_path]")
+{
+    const auto expr = GENERATE(as<std::string_view>{},
+                               "(others => '0')",
+                               "f(a => b)",
+                               "integer'(42)",
+                               "new node",
+                               "a -- comment\n + b",
+                               "x(natural range 0 to 3)");
+
+    INFO(expr);
+    CHECK_FALSE(parseFast(expr));
+}
+
+TEST_CASE("Expression fast path matches the CST translation", "[expressions][fast_path]")
+{
+    const auto expr = GENERATE(as<std::string_view>{},
+                               "a + b * c",
+                               "-a + b - c",
+                               "f(a, g(b))(1 downto 0)'length",
+                               "(a and b)\n\n     or c",
+                               "resize(unsigned(x), 8)",
+                               "data(7 downto 0)");
+
+    const auto code = std::format(R"(
+entity E is end E;
+
+architecture A of E is
+begin
+    process
+    begin
+        y <= {}; -- trailing
+
+        if {} then -- condition
+            z := {};
+        end if;
+    end process;
+end A;
+)",
+                                  expr,
+                                  expr,
+                                  expr);
+
+    INFO(code);
+    REQUIRE(formatWith(code, true) == formatWith(code, false));
+}
+
+TEST_CASE("Expression fast path matches the CST translation on the corpus",
+          "[expressions][fast_path]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        std::ifstream file{entry.path()};
+        std::stringstream buffer{};
+        buffer << file.rdbuf();
+        const auto code = buffer.str();
+
+        CHECK(formatWith(code, true) == formatWith(code, false));
+    }
+}
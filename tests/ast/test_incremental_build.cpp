@@ -0,0 +1,83 @@
+#include "ast/nodes/design_file.hpp"
+#include "builder/ast_builder.hpp"
+#include "builder/trivia/trivia_binder.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+auto formatWhole(std::string_view code) -> std::string
+{
+    auto ctx = builder::createContext(code);
+    return emit::format(builder::build(ctx), common::Config{});
+}
+
+auto formatIncremental(std::string_view code) -> std::string
+{
+    auto ctx = builder::createContext(code);
+    return emit::format(builder::buildIncremental(ctx), common::Config{});
+}
+
+} // namespace
+
+TEST_CASE("buildIncremental", "[builder][incremental]")
+{
+    SECTION("Delivers every unit to the sink in order")
+    {
+        constexpr std::string_view CODE = R"(
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity A is end A;
+
+-- Between units
+architecture rtl of A is begin end rtl;
+
+package P is end P;
+)";
+
+        auto ctx = builder::createContext(CODE);
+        std::vector<std::size_t> starts{};
+        builder::buildIncremental(ctx,
+                                  [&](const ast::DesignUnit& /*unit*/, builder::TokenSpan span) {
+                                      starts.push_back(span.start);
+                                  });
+
+        REQUIRE(starts.size() == 3);
+        REQUIRE(ctx.tokens->get(starts.at(0))->getText() == "library");
+        REQUIRE(ctx.tokens->get(starts.at(1))->getText() == "architecture");
+        REQUIRE(ctx.tokens->get(starts.at(2))->getText() == "package");
+        REQUIRE(formatIncremental(CODE) == formatWhole(CODE));
+    }
+
+    SECTION("Empty file yields no units")
+    {
+        auto ctx = builder::createContext(std::string_view{"-- only a comment\n"});
+        REQUIRE(builder::buildIncremental(ctx).units.empty());
+    }
+}
+
+TEST_CASE("buildIncremental matches build on the corpus", "[builder][incremental]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        std::ifstream file{entry.path()};
+        std::stringstream buffer{};
+        buffer << file.rdbuf();
+        const auto code = buffer.str();
+
+        CHECK(formatIncremental(code) == formatWhole(code));
+    }
+}
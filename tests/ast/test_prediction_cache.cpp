@@ -0,0 +1,133 @@
+#include "builder/ast_builder.hpp"
+#include "builder/prediction_cache.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view CODE = R"(
+entity E is
+    port (
+        clk : in std_logic;
+        q   : out std_logic_vector(7 downto 0)
+    );
+end E;
+
+architecture A of E is
+begin
+    process (clk)
+    begin
+        if rising_edge(clk) then
+            q <= std_logic_vector(unsigned(q) + 1);
+        end if;
+    end process;
+end A;
+)";
+
+auto formatCode() -> std::string
+{
+    auto ctx = builder::createContext(CODE);
+    return emit::format(builder::build(ctx), common::Config{});
+}
+
+} // namespace
+
+TEST_CASE("PredictionCache", "[builder][prediction_cache]")
+{
+    auto& cache = builder::PredictionCache::instance();
+
+    SECTION("Parsing fills the caches and clear() empties them")
+    {
+        static_cast<void>(formatCode());
+
+        const auto filled = cache.stats();
+        REQUIRE(filled.parser_states > 0);
+        REQUIRE(filled.lexer_states > 0);
+        REQUIRE(filled.contexts > 0);
+        REQUIRE(filled.approx_bytes > 0);
+
+        cache.clear();
+
+        const auto cleared = cache.stats();
+        REQUIRE(cleared.parser_states == 0);
+        REQUIRE(cleared.lexer_states == 0);
+        REQUIRE(cleared.contexts == 0);
+        REQUIRE(cleared.approx_bytes == 0);
+    }
+
+    SECTION("No ceiling never clears")
+    {
+        cache.setCeiling(0);
+        static_cast<void>(formatCode());
+
+        REQUIRE_FALSE(cache.enforceCeiling());
+        REQUIRE(cache.stats().parser_states > 0);
+
+        cache.setCeiling(builder::PredictionCache::DEFAULT_CEILING);
+    }
+
+    SECTION("Exceeding the ceiling clears the caches")
+    {
+        static_cast<void>(formatCode());
+
+        cache.setCeiling(1, false);
+        REQUIRE(cache.enforceCeiling());
+        REQUIRE(cache.stats().parser_states == 0);
+
+        cache.setCeiling(builder::PredictionCache::DEFAULT_CEILING);
+    }
+
+    SECTION("The ceiling is only measured once per interval")
+    {
+        static_cast<void>(formatCode());
+
+        cache.setCeiling(1, false);
+        REQUIRE(cache.enforceCeiling());
+
+        // Parsing enforces the ceiling too, which also counts as a call
+        static_cast<void>(formatCode());
+        REQUIRE_FALSE(cache.enforceCeiling());
+        REQUIRE(cache.stats().parser_states > 0);
+
+        // A new ceiling is measured straight away
+        cache.setCeiling(1, false);
+        REQUIRE(cache.enforceCeiling());
+
+        cache.setCeiling(builder::PredictionCache::DEFAULT_CEILING);
+    }
+
+    SECTION("Clearing does not disturb parses on other threads")
+    {
+        const auto expected = formatCode();
+
+        constexpr std::size_t THREADS = 4;
+        constexpr std::size_t RUNS = 20;
+
+        std::vector<std::string> results(THREADS * RUNS);
+        {
+            std::vector<std::jthread> workers{};
+            for (std::size_t t = 0; t < THREADS; ++t) {
+                workers.emplace_back([&results, t] {
+                    for (std::size_t run = 0; run < RUNS; ++run) {
+                        results.at((t * RUNS) + run) = formatCode();
+                    }
+                });
+            }
+
+            for (std::size_t run = 0; run < RUNS; ++run) {
+                cache.clear();
+            }
+        }
+
+        for (const auto& result : results) {
+            REQUIRE(result == expected);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#include "builder/ast_builder.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+
+TEST_CASE("Corpus parses without LL fallback", "[builder][sll]")
+{
+    const std::filesystem::path corpus{TEST_DATA_DIR "/vhdl"};
+    for (const auto& entry : std::filesystem::recursive_directory_iterator{corpus}) {
+        const auto extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".vhd" && extension != ".vhdl")) {
+            continue;
+        }
+        INFO(entry.path().filename().string());
+
+        auto ctx = builder::createContext(entry.path());
+        REQUIRE(builder::parse(ctx) != nullptr);
+
+        // Every grammar decision the corpus exercises must be resolvable by SLL prediction
+        CHECK_FALSE(ctx.used_ll_fallback);
+    }
+}
@@ -0,0 +1,61 @@
+#include "ast/nodes/design_file.hpp"
+#include "ast/nodes/design_units.hpp"
+#include "builder/ast_builder.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string_view>
+#include <variant>
+
+namespace {
+
+auto textOf(std::string_view source, const ast::NodeBase& node) -> std::string_view
+{
+    return source.substr(node.span.begin, node.span.end - node.span.begin);
+}
+
+} // namespace
+
+TEST_CASE("Nodes record the source they were parsed from", "[builder][spans]")
+{
+    // The comment holds multi-byte characters, so byte and code point offsets differ
+    constexpr std::string_view CODE = "-- \xC3\xA9t\xC3\xA9 \xE2\x82\xAC\n"
+                                      "library ieee;\n"
+                                      "entity A is\n"
+                                      "    port (clk : in std_logic; -- horloge \xC3\xA9\n"
+                                      "          q  : out bit);\n"
+                                      "end A;\n";
+
+    auto ctx = builder::createContext(CODE);
+    const auto root = builder::build(ctx);
+
+    REQUIRE(root.units.size() == 1);
+    const auto& unit = root.units.front();
+
+    SECTION("Design unit")
+    {
+        REQUIRE(textOf(CODE, unit).starts_with("library ieee;"));
+        REQUIRE(textOf(CODE, unit).ends_with("end A;"));
+        REQUIRE(ctx.tokens->get(unit.span.first_token)->getText() == "library");
+    }
+
+    SECTION("Context item")
+    {
+        REQUIRE(textOf(CODE, std::get<ast::LibraryClause>(unit.context.front())) == "library ieee;");
+    }
+
+    SECTION("Ports exclude their trivia and separators")
+    {
+        const auto& ports = std::get<ast::Entity>(unit.unit).port_clause.ports;
+
+        REQUIRE(ports.size() == 2);
+        REQUIRE(textOf(CODE, ports.at(0)) == "clk : in std_logic");
+        REQUIRE(textOf(CODE, ports.at(1)) == "q  : out bit");
+    }
+}
+
+TEST_CASE("Nodes built without a parse context have an empty span", "[builder][spans]")
+{
+    const ast::Entity entity{};
+
+    REQUIRE(entity.span.empty());
+}
@@ -0,0 +1,187 @@
+#include "builder/ast_builder.hpp"
+#include "builder/token_store.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+
+#include <algorithm>
+#include <antlr4-runtime/Token.h>
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view CODE = "entity A is\n"
+                                  "    port (x : in bit); -- input\n"
+                                  "end A;\n"
+                                  "\n"
+                                  "architecture rtl of A is\n"
+                                  "    signal s : bit := '0';\n"
+                                  "begin\n"
+                                  "    s <= x; -- caf\xC3\xA9\n"
+                                  "end rtl;\n";
+
+/// @brief Checks the store against lexing its text from scratch.
+auto matchesFreshLex(const builder::TokenStore& store) -> bool
+{
+    const auto ctx = builder::createContext(store.text());
+    const auto expected = ctx.tokens->getTokens();
+    const auto actual = store.tokens();
+
+    REQUIRE(actual.size() == expected.size());
+
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        const auto* lhs = actual.at(i);
+        const auto* rhs = expected.at(i);
+        INFO(std::string{"token "} + std::to_string(i) + " '" + rhs->getText() + "'");
+
+        if (lhs->getType() != rhs->getType() || lhs->getText() != rhs->getText()
+            || lhs->getChannel() != rhs->getChannel()
+            || lhs->getStartIndex() != rhs->getStartIndex()
+            || lhs->getStopIndex() != rhs->getStopIndex() || lhs->getLine() != rhs->getLine()
+            || lhs->getCharPositionInLine() != rhs->getCharPositionInLine()
+            || lhs->getTokenIndex() != i)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto edit(builder::TokenStore& store, std::string_view at, std::string_view text)
+  -> builder::TokenStore::Relexed
+{
+    const auto begin = store.text().find(at);
+    REQUIRE(begin != std::string::npos);
+    return store.applyEdit(begin, begin + at.size(), text);
+}
+
+} // namespace
+
+TEST_CASE("TokenStore lexes like the lexer", "[builder][token_store]")
+{
+    const builder::TokenStore store{std::string{CODE}};
+    REQUIRE(store.text() == CODE);
+    REQUIRE(matchesFreshLex(store));
+}
+
+TEST_CASE("TokenStore edits match a fresh lex", "[builder][token_store]")
+{
+    builder::TokenStore store{std::string{CODE}};
+
+    SECTION("Inside a line")
+    {
+        const auto relexed = edit(store, "x : in bit", "x, y : in bit_vector");
+        REQUIRE(matchesFreshLex(store));
+
+        // Only the edited line goes through the lexer
+        REQUIRE(relexed.tokens < 20);
+    }
+
+    SECTION("Growing an identifier")
+    {
+        edit(store, "rtl of", "rtl_2 of");
+        REQUIRE(matchesFreshLex(store));
+    }
+
+    SECTION("Adding and removing lines")
+    {
+        edit(store, "begin\n", "begin\n    s <= '1';\n\n");
+        REQUIRE(matchesFreshLex(store));
+
+        edit(store, "end A;\n\n", "end A;");
+        REQUIRE(matchesFreshLex(store));
+    }
+
+    SECTION("Multi-byte characters before the edit")
+    {
+        edit(store, "end rtl;", "end architecture rtl;");
+        REQUIRE(matchesFreshLex(store));
+    }
+
+    SECTION("At both ends of the buffer")
+    {
+        store.applyEdit(0, 0, "-- Header\n");
+        REQUIRE(matchesFreshLex(store));
+
+        const auto size = store.text().size();
+        store.applyEdit(size, size, "-- Footer");
+        REQUIRE(matchesFreshLex(store));
+
+        store.applyEdit(0, store.text().size(), "");
+        REQUIRE(matchesFreshLex(store));
+        REQUIRE(store.size() == 1);
+    }
+}
+
+TEST_CASE("TokenStore reports tokens that changed past the edit", "[builder][token_store]")
+{
+    builder::TokenStore store{std::string{"a <= b; c <= d;\ne <= f;\n"}};
+
+    const auto relexed = store.applyEdit(7, 7, "--");
+    REQUIRE(matchesFreshLex(store));
+
+    // The comment swallows the rest of the line, but not the next one
+    REQUIRE(relexed.begin == 7);
+    REQUIRE(relexed.end == store.text().find('\n'));
+}
+
+TEST_CASE("TokenStore relexes an apostrophe before a line break", "[builder][token_store]")
+{
+    builder::TokenStore store{std::string{"s <= '\nx';\n"}};
+    REQUIRE(matchesFreshLex(store));
+
+    // Without the `x` the apostrophes enclose the line break as a character literal
+    store.applyEdit(7, 8, "");
+    REQUIRE(matchesFreshLex(store));
+}
+
+TEST_CASE("TokenStore replays a range as if lexed on its own", "[builder][token_store]")
+{
+    const builder::TokenStore store{std::string{CODE}};
+    const auto begin = CODE.find("architecture");
+
+    auto ctx = builder::createContext(store, begin, CODE.size());
+    auto expected = builder::createContext(CODE.substr(begin));
+
+    REQUIRE(emit::format(builder::build(ctx), common::Config{})
+            == emit::format(builder::build(expected), common::Config{}));
+
+    REQUIRE_THROWS(static_cast<void>(store.replay(begin + 1, CODE.size())));
+}
+
+TEST_CASE("TokenStore matches a fresh lex on the corpus", "[builder][token_store]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        std::ifstream file{entry.path()};
+        std::stringstream buffer{};
+        buffer << file.rdbuf();
+
+        builder::TokenStore store{buffer.str()};
+        CHECK(matchesFreshLex(store));
+
+        // Delete and retype every tenth line
+        for (std::size_t line = 0, at = 0; at < store.text().size(); ++line) {
+            const auto next = std::min(store.text().find('\n', at), store.text().size());
+            if (line % 10 == 0) {
+                const auto text = store.text().substr(at, next - at);
+                store.applyEdit(at, next, "");
+                store.applyEdit(at, at, text);
+            }
+            at = next + 1;
+        }
+
+        CHECK(store.text() == buffer.str());
+        CHECK(matchesFreshLex(store));
+    }
+}
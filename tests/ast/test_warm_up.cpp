@@ -0,0 +1,12 @@
+#include "builder/ast_builder.hpp"
+#include "builder/warm_up.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Warm-up corpus parses without LL fallback", "[builder][warm_up]")
+{
+    // An LL fallback would leave the decisions it needed out of the primed SLL caches
+    auto ctx = builder::createContext(builder::warmUpCorpus());
+    REQUIRE(builder::parse(ctx) != nullptr);
+    CHECK_FALSE(ctx.used_ll_fallback);
+}
@@ -113,6 +113,12 @@ end Behavioral;
         return builder::Translator{*golden_ctx.tokens}.buildDesignFile(golden_tree);
     };
 
+    // 2.1 AST TRANSLATION without the expression fast path (CST ladder walk)
+    BENCHMARK("Stage 2.1: AST Translation (CST expressions)")
+    {
+        return builder::Translator{*golden_ctx.tokens, false}.buildDesignFile(golden_tree);
+    };
+
     // 3. PRETTY PRINTING (Doc Generation)
     BENCHMARK("Stage 3.0: Doc Generation (Visitor)")
     {
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <spawn.h>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Seconds = std::chrono::duration<double>;
+
+struct Corpus
+{
+    std::vector<std::filesystem::path> files;
+    std::uintmax_t bytes{0};
+};
+
+/// Measurements of one pass over the corpus
+struct Run
+{
+    unsigned jobs{0};
+    double wall_seconds{0.0};
+    double cpu_seconds{0.0};       ///< User and system time of every formatter process
+    long peak_rss_kilobytes{0};    ///< Largest of the formatter processes
+    std::vector<double> latencies; ///< Milliseconds per file, from spawn to exit, sorted
+    std::size_t failures{0};
+};
+
+auto collectCorpus(const std::filesystem::path& directory) -> Corpus
+{
+    Corpus corpus{};
+    for (const auto& entry : std::filesystem::recursive_directory_iterator{directory}) {
+        const auto extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".vhd" || extension == ".vhdl")) {
+            corpus.files.push_back(entry.path());
+            corpus.bytes += entry.file_size();
+        }
+    }
+
+    std::ranges::sort(corpus.files);
+    return corpus;
+}
+
+auto spawn(std::vector<std::string> command) -> pid_t
+{
+    std::vector<char*> argv{};
+    for (auto& arg : command) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    // Printing the formatted text is not what is measured
+    posix_spawn_file_actions_t actions{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    pid_t pid{0};
+    const auto error = posix_spawn(&pid, argv.front(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (error != 0) {
+        throw std::runtime_error(std::format("Cannot run {}: {}", command.front(), error));
+    }
+    return pid;
+}
+
+auto seconds(const timeval& time) -> double
+{
+    constexpr double MICROSECONDS{1e6};
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) / MICROSECONDS;
+}
+
+// Formats every file with at most `jobs` formatter processes at a time
+auto runCorpus(const Corpus& corpus,
+               const std::vector<std::string>& command,
+               unsigned jobs) -> Run
+{
+    Run run{.jobs = jobs};
+    std::unordered_map<pid_t, Clock::time_point> running{};
+    std::size_t next{0};
+
+    const auto start = Clock::now();
+    while (next < corpus.files.size() || !running.empty()) {
+        while (next < corpus.files.size() && running.size() < jobs) {
+            auto file_command = command;
+            file_command.push_back(corpus.files.at(next++).string());
+            running.emplace(spawn(std::move(file_command)), Clock::now());
+        }
+
+        int status{0};
+        rusage usage{};
+        const auto pid = wait4(-1, &status, 0, &usage);
+        if (pid < 0) {
+            throw std::runtime_error("wait4 failed");
+        }
+
+        const auto finished = Clock::now();
+        const auto it = running.find(pid);
+        if (it == running.end()) {
+            continue;
+        }
+
+        const std::chrono::duration<double, std::milli> latency = finished - it->second;
+        run.latencies.push_back(latency.count());
+        running.erase(it);
+
+        run.cpu_seconds += seconds(usage.ru_utime) + seconds(usage.ru_stime);
+        run.peak_rss_kilobytes = std::max(run.peak_rss_kilobytes, usage.ru_maxrss);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            ++run.failures;
+        }
+    }
+    run.wall_seconds = Seconds{Clock::now() - start}.count();
+
+    std::ranges::sort(run.latencies);
+    return run;
+}
+
+// Nearest rank percentile of sorted values
+auto percentile(const std::vector<double>& sorted, double fraction) -> double
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto rank =
+      static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted.at(std::clamp<std::size_t>(rank, 1, sorted.size()) - 1);
+}
+
+// 1, 2, 4, ... up to and including the most jobs
+auto jobCounts(unsigned most) -> std::vector<unsigned>
+{
+    std::vector<unsigned> counts{};
+    for (unsigned jobs = 1; jobs < most; jobs *= 2) {
+        counts.push_back(jobs);
+    }
+    counts.push_back(most);
+    return counts;
+}
+
+auto toJson(const Run& run, const Corpus& corpus, double baseline_wall) -> nlohmann::json
+{
+    constexpr double MEGABYTE{1024.0 * 1024.0};
+    const auto speedup = baseline_wall / run.wall_seconds;
+
+    return nlohmann::json{
+      {"jobs",                run.jobs                                                       },
+      {"wall_s",              run.wall_seconds                                               },
+      {"cpu_s",               run.cpu_seconds                                                },
+      {"peak_rss_kb",         run.peak_rss_kilobytes                                         },
+      {"files_per_s",         static_cast<double>(corpus.files.size()) / run.wall_seconds    },
+      {"mb_per_s",            static_cast<double>(corpus.bytes) / MEGABYTE / run.wall_seconds},
+      {"latency_ms",
+       {
+         {"p50", percentile(run.latencies, 0.50)},
+         {"p90", percentile(run.latencies, 0.90)},
+         {"p99", percentile(run.latencies, 0.99)},
+         {"max", run.latencies.empty() ? 0.0 : run.latencies.back()},
+       }                                                                                     },
+      {"speedup",             speedup                                                        },
+      {"parallel_efficiency", speedup / static_cast<double>(run.jobs)                        },
+      {"failures",            run.failures                                                   },
+    };
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    argparse::ArgumentParser program{"vhdl_cli_benchmark"};
+    program.add_description("Formats a corpus with the formatter executable, one process per "
+                            "file, at 1 to N processes at a time.");
+
+    program.add_argument("corpus")
+      .help("Directory of .vhd and .vhdl files")
+      .default_value(std::string{TEST_DATA_DIR "/vhdl"});
+    program.add_argument("--formatter")
+      .help("Formatter executable to measure")
+      .default_value(std::string{FORMATTER_PATH});
+    program.add_argument("-l", "--location").help("Configuration file passed to the formatter");
+    program.add_argument("-j", "--jobs")
+      .help("Most processes at a time; runs with 1, 2, 4, ... up to this")
+      .default_value(std::max(1U, std::thread::hardware_concurrency()))
+      .scan<'u', unsigned>();
+    program.add_argument("--repeat")
+      .help("Passes per process count; the fastest is kept")
+      .default_value(3U)
+      .scan<'u', unsigned>();
+    program.add_argument("-o", "--output").help("JSON file to write the results to");
+
+    try {
+        program.parse_args(argc, argv);
+
+        const auto corpus = collectCorpus(program.get<std::string>("corpus"));
+        if (corpus.files.empty()) {
+            throw std::runtime_error("The corpus has no VHDL files");
+        }
+
+        std::vector<std::string> command{program.get<std::string>("--formatter")};
+        if (const auto location = program.present("--location")) {
+            command.insert(command.end(), {"--location", *location});
+        }
+
+        const auto repeats = std::max(1U, program.get<unsigned>("--repeat"));
+        const auto most = std::max(1U, program.get<unsigned>("--jobs"));
+
+        std::cerr << std::format(
+          "{} files, {} bytes\n{:>5} {:>9} {:>9} {:>10} {:>9} {:>8} {:>8} {:>8} {:>8}\n",
+          corpus.files.size(),
+          corpus.bytes,
+          "jobs",
+          "wall s",
+          "cpu s",
+          "rss KiB",
+          "files/s",
+          "p50 ms",
+          "p99 ms",
+          "speedup",
+          "failed");
+
+        auto runs = nlohmann::json::array();
+        std::optional<double> baseline_wall{};
+        for (const auto jobs : jobCounts(most)) {
+            std::optional<Run> fastest{};
+            for (unsigned i = 0; i < repeats; ++i) {
+                auto run = runCorpus(corpus, command, jobs);
+                if (!fastest || run.wall_seconds < fastest->wall_seconds) {
+                    fastest = std::move(run);
+                }
+            }
+
+            const auto& run = *fastest;
+            if (!baseline_wall) {
+                baseline_wall = run.wall_seconds;
+            }
+
+            const auto json = toJson(run, corpus, *baseline_wall);
+            std::cerr << std::format("{:>5} {:>9.3f} {:>9.3f} {:>10} {:>9.1f} {:>8.1f} {:>8.1f} "
+                                     "{:>8.2f} {:>8}\n",
+                                     run.jobs,
+                                     run.wall_seconds,
+                                     run.cpu_seconds,
+                                     run.peak_rss_kilobytes,
+                                     json.at("files_per_s").get<double>(),
+                                     percentile(run.latencies, 0.50),
+                                     percentile(run.latencies, 0.99),
+                                     json.at("speedup").get<double>(),
+                                     run.failures);
+            runs.push_back(json);
+        }
+
+        const nlohmann::json report{
+          {"formatter", command.front()    },
+          {"files",     corpus.files.size()},
+          {"bytes",     corpus.bytes       },
+          {"runs",      runs               },
+        };
+
+        if (const auto path = program.present("--output")) {
+            std::ofstream{*path} << report.dump(2) << '\n';
+        } else {
+            std::cout << report.dump(2) << '\n';
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
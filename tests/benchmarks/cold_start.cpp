@@ -0,0 +1,96 @@
+#include "builder/ast_builder.hpp"
+#include "builder/prediction_cache.hpp"
+#include "builder/warm_up.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Roughly 50 lines, the size of a typical file opened in an editor
+constexpr std::string_view FIFTY_LINES = R"(
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+entity counter is
+    generic (
+        WIDTH : integer := 8
+    );
+    port (
+        clk   : in  std_logic;
+        rst   : in  std_logic;
+        en    : in  std_logic;
+        load  : in  std_logic;
+        value : in  std_logic_vector(WIDTH - 1 downto 0);
+        count : out std_logic_vector(WIDTH - 1 downto 0);
+        wrap  : out std_logic
+    );
+end entity counter;
+
+architecture rtl of counter is
+    signal cnt : unsigned(WIDTH - 1 downto 0) := (others => '0');
+    constant MAX : unsigned(WIDTH - 1 downto 0) := (others => '1');
+begin
+    count <= std_logic_vector(cnt);
+    wrap <= '1' when cnt = MAX and en = '1' else '0';
+
+    process (clk, rst)
+    begin
+        if rst = '1' then
+            cnt <= (others => '0');
+        elsif rising_edge(clk) then
+            if load = '1' then
+                cnt <= unsigned(value);
+            elsif en = '1' then
+                if cnt = MAX then
+                    cnt <= (others => '0');
+                else
+                    cnt <= cnt + 1;
+                end if;
+            end if;
+        end if;
+    end process;
+end architecture rtl;
+)";
+
+auto formatOnce() -> std::string
+{
+    auto ctx = builder::createContext(FIFTY_LINES);
+    return emit::format(builder::build(ctx), common::Config{});
+}
+
+} // namespace
+
+TEST_CASE("Time to first format", "[benchmark][cold_start]")
+{
+    // Each run starts from empty DFAs; "warm-up + first format" minus "warm-up" is the
+    // first-format latency once the caches have been primed
+    BENCHMARK("Cold start: first format")
+    {
+        builder::PredictionCache::instance().clear();
+        return formatOnce();
+    };
+
+    BENCHMARK("Cold start: warm-up")
+    {
+        builder::PredictionCache::instance().clear();
+        builder::warmUp();
+    };
+
+    BENCHMARK("Cold start: warm-up + first format")
+    {
+        builder::PredictionCache::instance().clear();
+        builder::warmUp();
+        return formatOnce();
+    };
+
+    BENCHMARK("Warm: format")
+    {
+        return formatOnce();
+    };
+}
@@ -0,0 +1,56 @@
+#include "benchmarks/stages.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+TEST_CASE("Corpus time per stage", "[benchmark][corpus]")
+{
+    for (const auto& file : benchmarks::corpusFiles()) {
+        auto workload = benchmarks::prepare(benchmarks::readFile(file));
+        const auto name = file.filename().string();
+
+        for (const auto& stage : benchmarks::stages()) {
+            BENCHMARK(std::format("Corpus {}: {}", stage.name, name))
+            {
+                return stage.run(workload);
+            };
+        }
+    }
+}
+
+TEST_CASE("Corpus throughput per stage", "[benchmark][corpus]")
+{
+    std::vector<benchmarks::Workload> workloads{};
+    std::size_t lines{0};
+    for (const auto& file : benchmarks::corpusFiles()) {
+        workloads.push_back(benchmarks::prepare(benchmarks::readFile(file)));
+        lines += workloads.back().lines;
+    }
+    REQUIRE(lines > 0);
+
+    // One pass over the whole corpus per stage, as a file-by-file run would see it
+    std::string report = std::format("{} lines in {} files\n", lines, workloads.size());
+    for (const auto& stage : benchmarks::stages()) {
+        const auto start = Clock::now();
+        for (auto& workload : workloads) {
+            stage.run(workload);
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        const auto kloc = static_cast<double>(lines) / 1000.0;
+        report += std::format("{:<10} {:>10.1f} KLOC/s\n", stage.name, kloc / elapsed.count());
+    }
+
+    WARN(report);
+}
@@ -0,0 +1,103 @@
+#include "benchmarks/stages.hpp"
+#include "generator/generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Sizes of the generated inputs; the largest is kept to what a ctest run can afford
+constexpr std::array<std::size_t, 4> SIZES{64UZ * 1024, 256UZ * 1024, 1024UZ * 1024, 4096UZ * 1024};
+
+// Each size is timed this many times and the fastest run kept, to shed scheduling noise
+constexpr std::size_t REPEATS{3};
+
+// Linear work fits an exponent near 1; a quadratic stage fits one near 2
+constexpr double MAX_SCALING_EXPONENT{1.3};
+
+struct Sample
+{
+    double lines;
+    double seconds;
+};
+
+auto fastestRun(const benchmarks::Stage& stage, benchmarks::Workload& workload) -> double
+{
+    auto fastest = std::numeric_limits<double>::max();
+    for (std::size_t i = 0; i < REPEATS; ++i) {
+        const auto start = Clock::now();
+        stage.run(workload);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        fastest = std::min(fastest, elapsed.count());
+    }
+    return fastest;
+}
+
+// Least squares slope of log(time) over log(lines)
+auto scalingExponent(std::span<const Sample> samples) -> double
+{
+    const auto count = static_cast<double>(samples.size());
+
+    double sum_x{0.0};
+    double sum_y{0.0};
+    double sum_xx{0.0};
+    double sum_xy{0.0};
+    for (const auto& sample : samples) {
+        const auto x = std::log(sample.lines);
+        const auto y = std::log(sample.seconds);
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+    }
+
+    return (count * sum_xy - sum_x * sum_y) / (count * sum_xx - sum_x * sum_x);
+}
+
+} // namespace
+
+TEST_CASE("Stages scale linearly with input size", "[benchmark][scaling]")
+{
+    std::vector<benchmarks::Workload> workloads{};
+    for (const auto size : SIZES) {
+        workloads.push_back(
+          benchmarks::prepare(generator::generate(generator::Options{.target_bytes = size})));
+    }
+
+    std::string report = std::format("{:<10} {:>8}", "stage", "exponent");
+    for (const auto& workload : workloads) {
+        report += std::format(" {:>9}", std::format("{}L", workload.lines));
+    }
+    report += "  (KLOC/s)\n";
+
+    for (const auto& stage : benchmarks::stages()) {
+        std::vector<Sample> samples{};
+        for (auto& workload : workloads) {
+            const auto lines = static_cast<double>(workload.lines);
+            samples.push_back(Sample{.lines = lines, .seconds = fastestRun(stage, workload)});
+        }
+
+        const auto exponent = scalingExponent(samples);
+        report += std::format("{:<10} {:>8.2f}", stage.name, exponent);
+        for (const auto& sample : samples) {
+            report += std::format(" {:>9.1f}", sample.lines / 1000.0 / sample.seconds);
+        }
+        report += '\n';
+
+        INFO(std::format("{} scales as lines^{:.2f}", stage.name, exponent));
+        CHECK(exponent <= MAX_SCALING_EXPONENT);
+    }
+
+    WARN(report);
+}
@@ -0,0 +1,62 @@
+#include "benchmarks/stages.hpp"
+#include "fuzz/work.hpp"
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Matches the default VHDL_FMT_FUZZ_SLOW of `make fuzz-perf`: the fuzzer saves inputs at or
+// above it, and each is checked in together with the fix that brings it back below
+constexpr double MAX_WORK_PER_BYTE{64.0};
+
+// Minimized inputs saved by the performance fuzzer, see tests/fuzz
+auto slowInputs() -> std::vector<std::filesystem::path>
+{
+    const std::filesystem::path directory{TEST_DATA_DIR "/slow"};
+
+    std::vector<std::filesystem::path> files{};
+    if (std::filesystem::is_directory(directory)) {
+        for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    std::ranges::sort(files);
+    return files;
+}
+
+} // namespace
+
+TEST_CASE("Fuzzer findings stay fast", "[benchmark][slow]")
+{
+    const auto files = slowInputs();
+    if (files.empty()) {
+        SKIP("No fuzzer findings in " TEST_DATA_DIR "/slow");
+    }
+
+    for (const auto& file : files) {
+        const auto source = benchmarks::readFile(file);
+        const auto name = file.filename().string();
+
+        const auto work = fuzz::measureWork(source);
+        INFO(std::format("{}: {} doc nodes, {} lookahead over {} bytes",
+                         name,
+                         work.doc_nodes,
+                         work.lookahead,
+                         work.bytes));
+        CHECK(work.perByte() <= MAX_WORK_PER_BYTE);
+
+        BENCHMARK(std::format("Slow input: {}", name))
+        {
+            return fuzz::measureWork(source).perByte();
+        };
+    }
+}
@@ -0,0 +1,161 @@
+#include "benchmarks/stages.hpp"
+
+#include "builder/ast_builder.hpp"
+#include "builder/translator.hpp"
+#include "builder/verifier.hpp"
+#include "common/config.hpp"
+#include "emit/format.hpp"
+#include "emit/pretty_printer.hpp"
+#include "emit/pretty_printer/renderer.hpp"
+
+#include <algorithm>
+#include <antlr4-runtime/BailErrorStrategy.h>
+#include <antlr4-runtime/atn/ParserATNSimulator.h>
+#include <antlr4-runtime/atn/PredictionMode.h>
+#include <array>
+#include <catch2/benchmark/catch_optimizer.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+const common::Config DEFAULT_CONFIG{};
+
+auto sllParse(Workload& workload) -> void
+{
+    Catch::Benchmark::keep_memory(parseWith(workload.parsing, antlr4::atn::PredictionMode::SLL));
+}
+
+auto llParse(Workload& workload) -> void
+{
+    Catch::Benchmark::keep_memory(parseWith(workload.parsing, antlr4::atn::PredictionMode::LL));
+}
+
+auto translate(Workload& workload) -> void
+{
+    auto root = builder::Translator{*workload.translating.tokens}.buildDesignFile(workload.tree);
+    Catch::Benchmark::keep_memory(&root);
+}
+
+auto buildDoc(Workload& workload) -> void
+{
+    auto doc = emit::PrettyPrinter{}.visit(workload.root);
+    Catch::Benchmark::keep_memory(&doc);
+}
+
+auto render(Workload& workload) -> void
+{
+    auto text = emit::Renderer{DEFAULT_CONFIG}.render(workload.doc);
+    Catch::Benchmark::keep_memory(&text);
+}
+
+auto verify(Workload& workload) -> void
+{
+    auto output = builder::createContext(std::string_view{workload.formatted});
+
+    // The inputs have to format correctly, so any failure is unexpected
+    if (const auto result =
+          builder::verify::ensureSafety(*workload.translating.tokens, *output.tokens);
+        !result) [[unlikely]]
+    {
+        throw std::runtime_error(result.error().message);
+    }
+}
+
+// Names of the SLL and LL stages match the corpus benchmarks that predate the others
+constexpr std::array STAGES{
+  Stage{.name = "SLL",       .run = sllParse },
+  Stage{.name = "LL",        .run = llParse  },
+  Stage{.name = "translate", .run = translate},
+  Stage{.name = "doc",       .run = buildDoc },
+  Stage{.name = "render",    .run = render   },
+  Stage{.name = "verify",    .run = verify   },
+};
+
+auto isVhdlFile(const std::filesystem::path& path) -> bool
+{
+    return path.extension() == ".vhd" || path.extension() == ".vhdl";
+}
+
+} // namespace
+
+auto corpusFiles() -> std::vector<std::filesystem::path>
+{
+    const auto* corpus = std::getenv("VHDL_FMT_CORPUS");
+    const auto directory = corpus != nullptr ? std::filesystem::path{corpus}
+                                             : std::filesystem::path{TEST_DATA_DIR} / "vhdl";
+
+    std::vector<std::filesystem::path> files{};
+    for (const auto& entry : std::filesystem::recursive_directory_iterator{directory}) {
+        if (entry.is_regular_file() && isVhdlFile(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+
+    std::ranges::sort(files);
+    return files;
+}
+
+auto readFile(const std::filesystem::path& path) -> std::string
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path.string());
+    }
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+auto lineCount(std::string_view source) -> std::size_t
+{
+    return static_cast<std::size_t>(std::ranges::count(source, '\n'));
+}
+
+auto parseWith(builder::Context& ctx, antlr4::atn::PredictionMode mode)
+  -> vhdlParser::Design_fileContext*
+{
+    ctx.parser->reset();
+
+    auto* interpreter = ctx.parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+    interpreter->setPredictionMode(mode);
+    ctx.parser->setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+    ctx.parser->removeErrorListeners();
+
+    return ctx.parser->design_file();
+}
+
+auto prepare(std::string source) -> Workload
+{
+    Workload workload{};
+    workload.source = std::move(source);
+    workload.lines = lineCount(workload.source);
+
+    workload.parsing = builder::createContext(std::string_view{workload.source});
+    workload.translating = builder::createContext(std::string_view{workload.source});
+    workload.tree = builder::parse(workload.translating);
+
+    workload.root =
+      builder::Translator{*workload.translating.tokens}.buildDesignFile(workload.tree);
+    workload.doc = emit::PrettyPrinter{}.visit(workload.root);
+    workload.formatted = emit::format(workload.root, DEFAULT_CONFIG);
+
+    return workload;
+}
+
+auto stages() -> std::span<const Stage>
+{
+    return STAGES;
+}
+
+} // namespace benchmarks
@@ -0,0 +1,67 @@
+#ifndef TESTS_BENCHMARKS_STAGES_HPP
+#define TESTS_BENCHMARKS_STAGES_HPP
+
+#include "ast/nodes/design_file.hpp"
+#include "builder/ast_builder.hpp"
+#include "emit/pretty_printer/doc.hpp"
+
+#include <antlr4-runtime/atn/PredictionMode.h>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmarks {
+
+/// @brief The VHDL files of the corpus directory, sorted.
+/// @note The directory is `$VHDL_FMT_CORPUS` when set, so that private code can be measured
+///       without checking it in, and the test data otherwise.
+[[nodiscard]]
+auto corpusFiles() -> std::vector<std::filesystem::path>;
+
+[[nodiscard]]
+auto readFile(const std::filesystem::path& path) -> std::string;
+
+[[nodiscard]]
+auto lineCount(std::string_view source) -> std::size_t;
+
+/// @brief Parses the whole context again with one prediction mode and no fallback.
+auto parseWith(builder::Context& ctx, antlr4::atn::PredictionMode mode)
+  -> vhdlParser::Design_fileContext*;
+
+/// @brief One input with the result of every stage computed once, so that each stage can be
+///        timed on its own.
+struct Workload final
+{
+    std::string source;
+    std::size_t lines{0};
+
+    builder::Context parsing;     ///< Parsed again by the parse stages
+    builder::Context translating; ///< Parsed once; owns `tree`
+    vhdlParser::Design_fileContext* tree{nullptr};
+
+    ast::DesignFile root;
+    emit::Doc doc{emit::Doc::empty()};
+    std::string formatted;
+};
+
+[[nodiscard]]
+auto prepare(std::string source) -> Workload;
+
+/// @brief A stage of the pipeline, run on a prepared workload.
+struct Stage final
+{
+    std::string_view name;
+    void (*run)(Workload&);
+};
+
+/// @brief SLL parse, LL parse, translation, document build, render and verification, in
+///        pipeline order.
+[[nodiscard]]
+auto stages() -> std::span<const Stage>;
+
+} // namespace benchmarks
+
+#endif /* TESTS_BENCHMARKS_STAGES_HPP */
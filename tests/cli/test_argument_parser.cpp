@@ -1,8 +1,10 @@
 #include "cli/argument_parser.hpp"
+#include "common/stats.hpp"
 
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <fstream>
@@ -213,3 +215,352 @@ TEST_CASE("ArgumentParser with flags set correctly", "[argument_parser]")
     // Cleanup
     std::filesystem::remove(temp_input);
 }
+
+TEST_CASE("ArgumentParser with a line range", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_lines.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Valid range")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--lines", "120:180", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getLineRange().has_value());
+        REQUIRE(parser.getLineRange()->first == 120);
+        REQUIRE(parser.getLineRange()->last == 180);
+    }
+
+    SECTION("No range")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE_FALSE(parser.getLineRange().has_value());
+    }
+
+    SECTION("Invalid range")
+    {
+        const auto range =
+          GENERATE(as<std::string_view>{}, "120", "0:5", "9:3", "a:b", "1:2x", ":4");
+
+        INFO(range);
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--lines", range, file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with an output mode", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_output.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Defaults to text")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getOutputMode() == cli::OutputMode::TEXT);
+    }
+
+    SECTION("Edits")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--output=edits", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getOutputMode() == cli::OutputMode::EDITS);
+    }
+
+    SECTION("Invalid combinations")
+    {
+        const auto extra = GENERATE(as<std::string_view>{}, "--write", "--output=diff");
+
+        INFO(extra);
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--output=edits", extra, file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with a timeout per file", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_timeout.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Valid timeout")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--timeout-per-file", "250", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getTimeoutPerFile() == std::chrono::milliseconds{250});
+    }
+
+    SECTION("No timeout")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE_FALSE(parser.getTimeoutPerFile().has_value());
+    }
+
+    SECTION("Invalid timeout")
+    {
+        const auto timeout = GENERATE(as<std::string_view>{}, "0", "-5", "1.5", "10ms", "");
+
+        INFO(timeout);
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--timeout-per-file", timeout, file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with a prediction cache limit", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_cache_limit.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Limit in MiB")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--prediction-cache-limit", "64", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getPredictionCacheLimit() == 64UZ * 1024 * 1024);
+    }
+
+    SECTION("Zero disables the limit")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--prediction-cache-limit", "0", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getPredictionCacheLimit() == 0UZ);
+    }
+
+    SECTION("No limit given")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE_FALSE(parser.getPredictionCacheLimit().has_value());
+    }
+
+    SECTION("Invalid limit")
+    {
+        const auto limit =
+          GENERATE(as<std::string_view>{}, "-1", "1.5", "64MiB", "", "18446744073709551615");
+
+        INFO(limit);
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--prediction-cache-limit", limit, file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with --stream", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_stream.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Stream a file")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--stream", "-w", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.isFlagSet(cli::ArgumentFlag::STREAM));
+        REQUIRE(parser.isFlagSet(cli::ArgumentFlag::WRITE));
+    }
+
+    SECTION("Needs a file")
+    {
+        const auto directory = std::filesystem::temp_directory_path().string();
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--stream", directory};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    SECTION("Cannot be combined with --lines")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--stream", "--lines", "1:1", file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with --stats", "[argument_parser]")
+{
+    if (!common::stats::COMPILED) {
+        SKIP("Built without statistics");
+    }
+
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_stats.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("No report unless asked")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE_FALSE(parser.getStatsFormat().has_value());
+    }
+
+    SECTION("Text report, before the input file")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--stats", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getStatsFormat() == cli::StatsFormat::TEXT);
+        REQUIRE(parser.getInputPath() == std::filesystem::canonical(temp_input));
+    }
+
+    SECTION("JSON report")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", file_path_str, "--stats=json"};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.getStatsFormat() == cli::StatsFormat::JSON);
+    }
+
+    SECTION("Unknown format")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--stats=xml", file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    SECTION("Cannot be combined with --lsp")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--stats", "--lsp"};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
+
+TEST_CASE("ArgumentParser with --explain-layout", "[argument_parser]")
+{
+    const std::filesystem::path temp_input =
+      std::filesystem::temp_directory_path() / "test_input_explain.vhd";
+
+    {
+        // Create temporary file
+        std::ofstream temp_input_file{temp_input};
+        temp_input_file << "entity test is end entity;";
+    }
+
+    const std::string file_path_str = temp_input.string();
+
+    SECTION("Explain a file")
+    {
+        const std::vector<std::string_view> args = {"vhdl-fmt", "--explain-layout", file_path_str};
+        const auto c_args = createArgs(args);
+        const cli::ArgumentParser parser{std::span<const char* const>{c_args}};
+
+        REQUIRE(parser.isFlagSet(cli::ArgumentFlag::EXPLAIN_LAYOUT));
+    }
+
+    SECTION("Cannot be combined with --write")
+    {
+        const std::vector<std::string_view> args = {
+          "vhdl-fmt", "--explain-layout", "--write", file_path_str};
+        const auto c_args = createArgs(args);
+
+        REQUIRE_THROWS(cli::ArgumentParser{std::span<const char* const>{c_args}});
+    }
+
+    // Cleanup
+    std::filesystem::remove(temp_input);
+}
@@ -41,6 +41,7 @@ TEST_CASE("ConfigReader with valid complete configuration file", "[config]")
     REQUIRE(config.casing.keywords == common::CaseStyle::LOWER);
     REQUIRE(config.casing.constants == common::CaseStyle::UPPER);
     REQUIRE(config.casing.identifiers == common::CaseStyle::LOWER);
+    REQUIRE(config.layout == common::LayoutMode::NETLIST);
 }
 
 TEST_CASE("ConfigReader with empty configuration file", "[config]")
@@ -64,6 +65,7 @@ TEST_CASE("ConfigReader with empty configuration file", "[config]")
     REQUIRE(config.casing.keywords == common::CaseStyle::LOWER);
     REQUIRE(config.casing.constants == common::CaseStyle::UPPER);
     REQUIRE(config.casing.identifiers == common::CaseStyle::LOWER);
+    REQUIRE(config.layout == common::LayoutMode::AUTO);
 }
 
 TEST_CASE("ConfigReader with non-existent configuration file", "[config]")
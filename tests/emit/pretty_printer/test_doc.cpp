@@ -1,3 +1,4 @@
+#include "ast/node.hpp"
 #include "common/config.hpp"
 #include "emit/pretty_printer/doc.hpp"
 #include "emit/pretty_printer/doc_impl.hpp"
@@ -7,10 +8,13 @@
 
 #include <algorithm>
 #include <array>
+#include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 using emit::Doc;
 using emit::test::defaultConfig;
@@ -218,6 +222,40 @@ TEST_CASE("Doc System", "[doc]")
             const Doc doc = Doc::group(Doc::text("A") / Doc::text("B") + Doc::hardlines(0));
             REQUIRE(render(doc, defaultConfig()) == "A\nB");
         }
+
+        SECTION("Measured groups lay out like groups")
+        {
+            const auto build = [](auto group) {
+                const Doc args = group(Doc::text("a,") / Doc::text("b,") / Doc::text("c"));
+                const Doc call = Doc::text("call(") + Doc::hang(args) + Doc::text(")");
+                return group(Doc::text("x") & Doc::text("<=") & Doc::hang(call) + Doc::text(";"));
+            };
+            const Doc grouped = build([](const Doc& doc) { return Doc::group(doc); });
+            const Doc measured = build([](const Doc& doc) { return Doc::measuredGroup(doc); });
+
+            auto config = defaultConfig();
+            for (std::uint16_t width = 1; width <= 30; ++width) {
+                config.line_config.line_length = width;
+                INFO(width);
+                REQUIRE(render(measured, config) == render(grouped, config));
+            }
+        }
+
+        SECTION("Measured groups never build a flat version")
+        {
+            const Doc doc = Doc::measuredGroup(Doc::text("hello") / Doc::text("world"));
+            const auto& node = std::get<emit::Union>(doc.getImpl()->value);
+
+            REQUIRE(node.flat == nullptr);
+            REQUIRE(node.width == 11);
+            REQUIRE(render(doc, defaultConfig()) == "hello world");
+        }
+
+        SECTION("Measured groups with a hard line always break")
+        {
+            const Doc doc = Doc::measuredGroup(Doc::text("hello") | Doc::text("world"));
+            REQUIRE(render(doc, defaultConfig()) == "hello\nworld");
+        }
     }
 
     // ==============================================================================
@@ -449,3 +487,33 @@ TEST_CASE("Doc System", "[doc]")
         }
     }
 }
+
+TEST_CASE("Renderer traces its group decisions", "[doc][trace]")
+{
+    auto config = defaultConfig();
+    config.line_config.line_length = 12;
+
+    const ast::SourceSpan span{.first_token = 0, .last_token = 1, .begin = 4, .end = 16};
+    const Doc doc = Doc::mark(Doc::group(Doc::text("hello") / Doc::text("world!!")), span)
+                  + Doc::hardline() + Doc::group(Doc::text("a") / Doc::text("b"));
+
+    std::vector<emit::LayoutDecision> decisions{};
+    emit::Renderer renderer{config};
+    renderer.trace(decisions);
+
+    REQUIRE(renderer.render(doc) == "hello\nworld!!\na b");
+    REQUIRE(decisions.size() == 2);
+
+    // Too wide for the line, so broken; the mark names the node it belongs to
+    CHECK_FALSE(decisions.front().flat);
+    CHECK(decisions.front().line == 0);
+    CHECK(decisions.front().column == 0);
+    CHECK(decisions.front().width == 13);
+    CHECK(decisions.front().remaining == 12);
+    CHECK(decisions.front().source.begin == span.begin);
+
+    CHECK(decisions.back().flat);
+    CHECK(decisions.back().line == 2);
+    CHECK(decisions.back().width == 3);
+    CHECK(decisions.back().source.empty());
+}
@@ -0,0 +1,86 @@
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "emit/pretty_printer/doc.hpp"
+#include "emit/pretty_printer/renderer.hpp"
+#include "emit/pretty_printer/variants.hpp"
+#include "emit/test_utils.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using emit::Doc;
+using emit::test::defaultConfig;
+
+namespace {
+
+auto makeConfigs() -> std::vector<common::Config>
+{
+    std::vector<common::Config> configs{};
+    for (std::uint16_t width = 10; width <= 40; width += 5) {
+        auto config = defaultConfig();
+        config.line_config.line_length = width;
+        config.line_config.indent_size = static_cast<std::uint8_t>(width % 4 + 1);
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+// Aligned declarations in a group that breaks or not depending on the width
+auto makeDoc() -> Doc
+{
+    const Doc first = Doc::text("clk", 0) & Doc::text(":") & Doc::keyword("in", 1);
+    const Doc second = Doc::text("data_in", 0) & Doc::text(":") & Doc::keyword("out", 1);
+    const Doc ports = Doc::align(first + Doc::text(";") / second);
+
+    return Doc::group(Doc::bracket(Doc::keyword("port") & Doc::text("("), ports, Doc::text(");")))
+         | Doc::text("end;");
+}
+
+} // namespace
+
+TEST_CASE("renderVariants matches one render per configuration", "[variants]")
+{
+    const auto configs = makeConfigs();
+    const auto doc = makeDoc();
+
+    for (const unsigned jobs : {1U, 4U, 0U}) {
+        const auto variants = emit::renderVariants(doc, configs, jobs);
+        REQUIRE(variants.size() == configs.size());
+
+        for (std::size_t k = 0; k < configs.size(); ++k) {
+            INFO("jobs " << jobs << ", line length " << configs.at(k).line_config.line_length);
+            CHECK(variants.at(k).text == emit::Renderer{configs.at(k)}.render(doc));
+        }
+    }
+}
+
+TEST_CASE("renderVariants counts lines and overflows", "[variants]")
+{
+    auto config = defaultConfig();
+    config.line_config.line_length = 10;
+
+    const Doc doc = Doc::text("short") | Doc::text("far too long for ten") | Doc::text("end");
+    const auto variants = emit::renderVariants(doc, std::vector{config});
+
+    REQUIRE(variants.size() == 1);
+    REQUIRE(variants.front().lines == 3);
+    REQUIRE(variants.front().overflows == 1);
+}
+
+TEST_CASE("renderVariants stops once cancelled", "[variants]")
+{
+    const auto configs = makeConfigs();
+    const auto cancellation = common::CancellationToken::withBudget();
+    cancellation.cancel();
+
+    // Enough documents for the renderer to poll the token
+    Doc doc = Doc::empty();
+    for (int i = 0; i < 4096; ++i) {
+        doc |= Doc::text("x");
+    }
+
+    REQUIRE_THROWS_AS(emit::renderVariants(doc, configs, 2, cancellation), common::Cancelled);
+}
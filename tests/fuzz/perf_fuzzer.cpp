@@ -0,0 +1,96 @@
+#include "fuzz/work.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+namespace {
+
+// Log2 buckets per measurement; a bucket first reached is new coverage to libFuzzer
+constexpr std::size_t BUCKETS{32};
+
+enum class Measure : std::uint8_t
+{
+    DOC_NODES_PER_BYTE,
+    LOOKAHEAD_PER_BYTE,
+    MAX_LOOKAHEAD,
+    MEASURE_COUNT,
+};
+
+constexpr auto MEASURE_COUNT = static_cast<std::size_t>(Measure::MEASURE_COUNT);
+
+// Ratios are bucketed in sixteenths so that the range below 1 per byte is not one bucket
+constexpr double FIXED_POINT{16.0};
+
+// libFuzzer clears this section before every input and reads it back as extra features, so
+// an input that does more work per byte than any before it is kept in the corpus even if it
+// reaches no new code
+[[gnu::used, gnu::section("__libfuzzer_extra_counters")]]
+std::array<std::uint8_t, BUCKETS * MEASURE_COUNT> work_counters{};
+
+auto record(Measure measure, std::uint64_t value) -> void
+{
+    const auto bucket = std::min<std::size_t>(std::bit_width(value), BUCKETS - 1);
+    work_counters.at((static_cast<std::size_t>(measure) * BUCKETS) + bucket) = 1;
+}
+
+auto fixedPoint(double ratio) -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(ratio * FIXED_POINT);
+}
+
+// Work per byte at which an input is reported as a finding, from VHDL_FMT_FUZZ_SLOW; 0 never
+auto slowThreshold() -> double
+{
+    static const double threshold = [] {
+        const auto* value = std::getenv("VHDL_FMT_FUZZ_SLOW");
+        return value != nullptr ? std::strtod(value, nullptr) : 0.0;
+    }();
+    return threshold;
+}
+
+} // namespace
+
+extern "C" auto LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) -> int
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    const auto bytes = std::span{data, size};
+    const auto work = fuzz::measureWork(
+      std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+
+    record(Measure::DOC_NODES_PER_BYTE, fixedPoint(work.docNodesPerByte()));
+    record(Measure::LOOKAHEAD_PER_BYTE, fixedPoint(work.lookaheadPerByte()));
+    record(Measure::MAX_LOOKAHEAD, work.max_lookahead);
+
+    static double worst{0.0};
+    if (work.perByte() > worst) {
+        worst = work.perByte();
+        std::cerr << std::format(
+          "#slowest {:.2f} work/byte: {} bytes, {} doc nodes, {} lookahead (max {}){}\n",
+          worst,
+          work.bytes,
+          work.doc_nodes,
+          work.lookahead,
+          work.max_lookahead,
+          work.formatted ? "" : ", rejected");
+    }
+
+    // Aborting hands the input to libFuzzer as a crash, which saves it and, under
+    // -minimize_crash=1, shrinks it while it stays above the threshold
+    if (slowThreshold() > 0.0 && work.perByte() >= slowThreshold()) {
+        std::cerr << std::format("Slow input: {:.2f} work/byte\n", work.perByte());
+        std::abort();
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef TESTS_FUZZ_WORK_HPP
+#define TESTS_FUZZ_WORK_HPP
+
+#include "builder/ast_builder.hpp"
+#include "common/config.hpp"
+#include "common/stats.hpp"
+#include "emit/format.hpp"
+
+#include <algorithm>
+#include <antlr4-runtime/atn/DecisionInfo.h>
+#include <antlr4-runtime/atn/ParseInfo.h>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string_view>
+
+namespace fuzz {
+
+/// @brief What formatting one input cost, counted rather than timed so that it is the same
+///        on every machine and every run.
+struct Work final
+{
+    std::size_t bytes{0};
+    std::uint64_t doc_nodes{0};     ///< Document nodes built, measured flat or rebuilt by alignment
+    std::uint64_t lookahead{0};     ///< Tokens the parser looked ahead over, summed over decisions
+    std::uint64_t max_lookahead{0}; ///< Longest lookahead of a single decision
+    bool formatted{false};          ///< False if the input did not parse
+
+    /// Everything counted, per input byte; what the fuzzer maximizes and the benchmarks bound
+    [[nodiscard]]
+    auto perByte() const -> double
+    {
+        return static_cast<double>(doc_nodes + lookahead)
+             / static_cast<double>(std::max(bytes, 1UZ));
+    }
+
+    [[nodiscard]]
+    auto docNodesPerByte() const -> double
+    {
+        return static_cast<double>(doc_nodes) / static_cast<double>(std::max(bytes, 1UZ));
+    }
+
+    [[nodiscard]]
+    auto lookaheadPerByte() const -> double
+    {
+        return static_cast<double>(lookahead) / static_cast<double>(std::max(bytes, 1UZ));
+    }
+};
+
+/// @brief Parses and formats `source` the way builder::buildFromString() and emit::format()
+///        do, with the parser profiling its decisions.
+/// @note Document nodes are counted through common::stats, so they read 0 in builds without
+///       ENABLE_STATS. Resets the statistics registry.
+inline auto measureWork(std::string_view source) -> Work
+{
+    using common::stats::Counter;
+
+    auto& registry = common::stats::Registry::instance();
+    registry.enable();
+    registry.reset();
+
+    Work work{.bytes = source.size()};
+
+    auto ctx = builder::createContext(source);
+    ctx.parser->setProfile(true);
+
+    try {
+        const auto root = builder::build(ctx);
+        static_cast<void>(emit::format(root, common::Config{}));
+        work.formatted = true;
+    }
+    catch (const std::exception&) {
+        // Syntax errors: the lookahead spent before giving up still counts
+    }
+
+    for (const auto& decision : ctx.parser->getParseInfo().getDecisionInfo()) {
+        work.lookahead +=
+          static_cast<std::uint64_t>(decision.SLL_TotalLook + decision.LL_TotalLook);
+        work.max_lookahead = std::max(
+          {work.max_lookahead,
+           static_cast<std::uint64_t>(decision.SLL_MaxLook),
+           static_cast<std::uint64_t>(decision.LL_MaxLook)});
+    }
+
+    const auto stats = registry.snapshot();
+    for (const auto counter :
+         {Counter::DOC_NODES, Counter::FITS_NODES, Counter::ALIGN_REBUILT_NODES})
+    {
+        work.doc_nodes += stats.counters.at(static_cast<std::size_t>(counter));
+    }
+
+    registry.enable(false);
+    return work;
+}
+
+} // namespace fuzz
+
+#endif /* TESTS_FUZZ_WORK_HPP */
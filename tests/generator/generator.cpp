@@ -0,0 +1,484 @@
+#include "generator/generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace generator {
+
+namespace {
+
+constexpr std::size_t INDENT_WIDTH{4};
+
+// Processes per architecture; each drives its own share of the signals
+constexpr std::size_t PROCESSES{2};
+
+// Statements per sequential block are drawn from 1 to this
+constexpr std::size_t MAX_BLOCK_STATEMENTS{3};
+
+constexpr std::array<std::string_view, 3> ARITHMETIC_OPERATORS{"+", "-", "*"};
+constexpr std::array<std::string_view, 6> RELATIONAL_OPERATORS{"=", "/=", "<", "<=", ">", ">="};
+constexpr std::array<std::string_view, 2> LOGICAL_OPERATORS{"and", "or"};
+
+constexpr std::array<std::string_view, 12> WORDS{
+  "latch", "the", "value", "when", "enabled", "counter", "wraps", "around", "before", "reset",
+  "state", "pipeline",
+};
+
+/// SplitMix64; unlike the distributions of <random>, gives the same sequence everywhere
+class Random final
+{
+  public:
+    explicit Random(std::uint64_t seed) : state_{seed} {}
+
+    auto next() -> std::uint64_t
+    {
+        state_ += 0x9E37'79B9'7F4A'7C15;
+        auto z = state_;
+        z = (z ^ (z >> 30U)) * 0xBF58'476D'1CE4'E5B9;
+        z = (z ^ (z >> 27U)) * 0x94D0'49BB'1331'11EB;
+        return z ^ (z >> 31U);
+    }
+
+    /// A number from 0 to bound - 1
+    auto below(std::size_t bound) -> std::size_t
+    {
+        return static_cast<std::size_t>(next() % std::max<std::size_t>(bound, 1));
+    }
+
+    auto chance(double probability) -> bool
+    {
+        // The top 53 bits, as a double in [0, 1)
+        constexpr double SCALE{0x1.0p-53};
+        return static_cast<double>(next() >> 11U) * SCALE < probability;
+    }
+
+    template<typename Range>
+    auto pick(const Range& range) -> const auto&
+    {
+        return range.at(below(range.size()));
+    }
+
+  private:
+    std::uint64_t state_;
+};
+
+/// Writes one entity and architecture pair
+class UnitWriter final
+{
+  public:
+    UnitWriter(const Options& options, Random& random, std::size_t index) :
+      options_{options},
+      random_{random},
+      name_{std::format("unit_{}", index)}
+    {}
+
+    auto write() -> std::string
+    {
+        declareNames();
+
+        line("library ieee;");
+        line("use ieee.std_logic_1164.all;");
+        blank();
+        entity();
+        blank();
+        architecture();
+        blank();
+
+        return std::move(text_);
+    }
+
+  private:
+    const Options& options_;
+    Random& random_;
+    std::string name_;
+    std::string text_;
+    std::size_t depth_{0};
+
+    std::vector<std::string> inputs_;
+    std::vector<std::string> outputs_;
+    std::vector<std::string> generics_;
+    std::vector<std::string> constants_;
+    std::vector<std::string> signals_;
+
+    // Names an expression may read, and the variables it may assign, where it is written
+    std::vector<std::string> readable_;
+    std::vector<std::string> variables_;
+    std::vector<std::string> driven_;
+    std::size_t loops_{0};
+
+    auto declareNames() -> void
+    {
+        const auto outputs = options_.ports / 2;
+        for (std::size_t i = 0; i < options_.ports - outputs; ++i) {
+            inputs_.push_back(std::format("in_{}", i));
+        }
+        for (std::size_t i = 0; i < outputs; ++i) {
+            outputs_.push_back(std::format("out_{}", i));
+        }
+        for (std::size_t i = 0; i < options_.generics; ++i) {
+            generics_.push_back(std::format("G_{}", i));
+        }
+        for (std::size_t i = 0; i < 2; ++i) {
+            constants_.push_back(std::format("C_{}", i));
+        }
+        for (std::size_t i = 0; i < 2 * PROCESSES; ++i) {
+            signals_.push_back(std::format("s_{}", i));
+        }
+
+        readable_ = inputs_;
+        readable_.insert(readable_.end(), generics_.begin(), generics_.end());
+        readable_.insert(readable_.end(), constants_.begin(), constants_.end());
+        readable_.insert(readable_.end(), signals_.begin(), signals_.end());
+    }
+
+    // --- Text ---
+
+    auto line(std::string_view content) -> void
+    {
+        text_.append(depth_ * INDENT_WIDTH, ' ');
+        text_ += content;
+        text_ += '\n';
+    }
+
+    auto blank() -> void
+    {
+        text_ += '\n';
+    }
+
+    // Blank lines and comments, before a declaration or statement
+    auto trivia() -> void
+    {
+        if (random_.chance(options_.blank_line_density)) {
+            blank();
+        }
+        if (random_.chance(options_.comment_density)) {
+            std::string comment{"--"};
+            for (std::size_t i = 0, words = 2 + random_.below(5); i < words; ++i) {
+                comment += ' ';
+                comment += random_.pick(WORDS);
+            }
+            line(comment);
+        }
+    }
+
+    // Items of a generic or port list, the last without its semicolon
+    auto list(std::string_view keyword, const std::vector<std::string>& items) -> void
+    {
+        line(std::format("{} (", keyword));
+        ++depth_;
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            line(items.at(i) + (i + 1 < items.size() ? ";" : ""));
+        }
+        --depth_;
+        line(");");
+    }
+
+    // --- Expressions ---
+
+    auto primary() -> std::string
+    {
+        if (readable_.empty() || random_.chance(0.25)) {
+            return std::to_string(random_.below(256));
+        }
+        return random_.pick(readable_);
+    }
+
+    auto expression(std::size_t depth) -> std::string
+    {
+        const auto operands = 1 + random_.below(options_.expression_width);
+
+        std::string result = operand(depth);
+        for (std::size_t i = 1; i < operands; ++i) {
+            const auto& op = random_.pick(ARITHMETIC_OPERATORS);
+            result += std::format(" {} {}", op, operand(depth));
+        }
+        return result;
+    }
+
+    auto operand(std::size_t depth) -> std::string
+    {
+        if (depth > 0 && random_.chance(0.5)) {
+            return std::format("({})", expression(depth - 1));
+        }
+        return primary();
+    }
+
+    auto condition() -> std::string
+    {
+        const auto depth = options_.expression_depth / 2;
+        auto result = expression(depth);
+        result += std::format(" {} ", random_.pick(RELATIONAL_OPERATORS));
+        result += expression(depth);
+
+        if (random_.chance(0.3)) {
+            result += std::format(" {} ", random_.pick(LOGICAL_OPERATORS));
+            result += primary();
+            result += std::format(" {} ", random_.pick(RELATIONAL_OPERATORS));
+            result += primary();
+        }
+        return result;
+    }
+
+    auto value() -> std::string
+    {
+        return expression(options_.expression_depth);
+    }
+
+    // --- Design units ---
+
+    auto entity() -> void
+    {
+        line(std::format("entity {} is", name_));
+        ++depth_;
+
+        if (!generics_.empty()) {
+            std::vector<std::string> generics{};
+            for (const auto& generic : generics_) {
+                const auto initial = 1 + random_.below(32);
+                generics.push_back(std::format("{} : integer := {}", generic, initial));
+            }
+            list("generic", generics);
+        }
+
+        std::vector<std::string> ports{"clk : in std_logic"};
+        for (const auto& input : inputs_) {
+            ports.push_back(std::format("{} : in integer", input));
+        }
+        for (const auto& output : outputs_) {
+            ports.push_back(std::format("{} : out integer", output));
+        }
+        list("port", ports);
+
+        --depth_;
+        line(std::format("end entity {};", name_));
+    }
+
+    auto architecture() -> void
+    {
+        line(std::format("architecture rtl of {} is", name_));
+        ++depth_;
+
+        for (const auto& constant : constants_) {
+            trivia();
+            line(std::format("constant {} : integer := {};", constant, random_.below(256)));
+        }
+        for (const auto& signal : signals_) {
+            trivia();
+            line(std::format("signal {} : integer;", signal));
+        }
+
+        --depth_;
+        line("begin");
+        ++depth_;
+
+        // Each output is driven by one concurrent assignment
+        for (std::size_t i = 0; i < outputs_.size(); ++i) {
+            trivia();
+            if (random_.chance(0.5)) {
+                conditionalAssign(outputs_.at(i));
+            } else {
+                selectedAssign(outputs_.at(i));
+            }
+        }
+
+        for (std::size_t i = 0; i < PROCESSES; ++i) {
+            trivia();
+            process(i);
+        }
+
+        --depth_;
+        line("end architecture rtl;");
+    }
+
+    // --- Concurrent statements ---
+
+    auto conditionalAssign(const std::string& target) -> void
+    {
+        const auto chosen = value();
+        const auto when = condition();
+        line(std::format("{} <= {} when {} else {};", target, chosen, when, value()));
+    }
+
+    auto selectedAssign(const std::string& target) -> void
+    {
+        line(std::format("with {} select {} <=", primarySelector(), target));
+        ++depth_;
+        line(std::format("{} when 0,", value()));
+        line(std::format("{} when 1 | 2,", value()));
+        line(std::format("{} when others;", value()));
+        --depth_;
+    }
+
+    auto primarySelector() -> std::string
+    {
+        return inputs_.empty() ? random_.pick(signals_) : random_.pick(inputs_);
+    }
+
+    auto process(std::size_t index) -> void
+    {
+        // Every signal is driven by one process only
+        driven_.clear();
+        for (std::size_t i = index; i < signals_.size(); i += PROCESSES) {
+            driven_.push_back(signals_.at(i));
+        }
+        variables_ = {std::format("v_{}", index), std::format("w_{}", index)};
+        loops_ = 0;
+
+        line("process (clk)");
+        ++depth_;
+        for (const auto& variable : variables_) {
+            line(std::format("variable {} : integer := 0;", variable));
+        }
+        --depth_;
+        line("begin");
+        ++depth_;
+
+        const auto readable = readable_.size();
+        readable_.insert(readable_.end(), variables_.begin(), variables_.end());
+
+        line("if rising_edge(clk) then");
+        ++depth_;
+        block(options_.nesting_depth);
+        --depth_;
+        line("end if;");
+
+        readable_.resize(readable);
+
+        --depth_;
+        line("end process;");
+    }
+
+    // --- Sequential statements ---
+
+    auto block(std::size_t depth) -> void
+    {
+        for (std::size_t i = 0, count = 1 + random_.below(MAX_BLOCK_STATEMENTS); i < count; ++i) {
+            trivia();
+            statement(depth);
+        }
+    }
+
+    auto statement(std::size_t depth) -> void
+    {
+        if (depth > 0) {
+            switch (random_.below(6)) {
+                case 0:
+                case 1:
+                    ifStatement(depth);
+                    return;
+                case 2:
+                    caseStatement(depth);
+                    return;
+                case 3:
+                    forLoop(depth);
+                    return;
+                default:
+                    break;
+            }
+        }
+
+        assignment();
+    }
+
+    auto assignment() -> void
+    {
+        if (driven_.empty() || random_.chance(0.3)) {
+            const auto& variable = random_.pick(variables_);
+            line(std::format("{} := {};", variable, value()));
+        } else {
+            const auto& signal = random_.pick(driven_);
+            line(std::format("{} <= {};", signal, value()));
+        }
+    }
+
+    auto ifStatement(std::size_t depth) -> void
+    {
+        line(std::format("if {} then", condition()));
+        nested(depth);
+
+        for (std::size_t i = 0, alternatives = random_.below(3); i < alternatives; ++i) {
+            line(std::format("elsif {} then", condition()));
+            nested(depth);
+        }
+
+        if (random_.chance(0.5)) {
+            line("else");
+            nested(depth);
+        }
+
+        line("end if;");
+    }
+
+    auto caseStatement(std::size_t depth) -> void
+    {
+        line(std::format("case {} is", primarySelector()));
+        ++depth_;
+
+        const auto choices = 1 + random_.below(3);
+        for (std::size_t i = 0; i < choices; ++i) {
+            line(std::format("when {} =>", i));
+            nested(depth);
+        }
+        line("when others =>");
+        nested(depth);
+
+        --depth_;
+        line("end case;");
+    }
+
+    auto forLoop(std::size_t depth) -> void
+    {
+        auto iterator = std::format("i_{}", loops_++);
+        line(std::format("for {} in 0 to {} loop", iterator, 1 + random_.below(15)));
+
+        readable_.push_back(std::move(iterator));
+        nested(depth);
+        readable_.pop_back();
+
+        line("end loop;");
+    }
+
+    auto nested(std::size_t depth) -> void
+    {
+        ++depth_;
+        block(depth - 1);
+        --depth_;
+    }
+};
+
+} // namespace
+
+auto generate(const Options& options, std::ostream& out) -> std::size_t
+{
+    Random random{options.seed};
+    std::size_t bytes{0};
+
+    for (std::size_t unit = 0;
+         options.units > 0 ? unit < options.units : bytes < options.target_bytes;
+         ++unit)
+    {
+        const auto text = UnitWriter{options, random, unit}.write();
+        out << text;
+        bytes += text.size();
+    }
+
+    return bytes;
+}
+
+auto generate(const Options& options) -> std::string
+{
+    std::ostringstream out{};
+    generate(options, out);
+    return std::move(out).str();
+}
+
+} // namespace generator
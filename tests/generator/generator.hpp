@@ -0,0 +1,47 @@
+#ifndef TESTS_GENERATOR_GENERATOR_HPP
+#define TESTS_GENERATOR_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace generator {
+
+/// @brief The shape of the generated code. The defaults look like ordinary RTL.
+struct Options final
+{
+    std::uint64_t seed{1};
+
+    /// Entity and architecture pairs are generated until the output reaches this size, so it
+    /// overshoots by at most one pair
+    std::size_t target_bytes{64UZ * 1024};
+
+    /// Entity and architecture pairs to generate instead, if not 0; target_bytes is ignored
+    std::size_t units{0};
+
+    std::size_t ports{8};    ///< Data ports per entity besides the clock, half of them inputs
+    std::size_t generics{2}; ///< Generics per entity
+
+    std::size_t expression_depth{2}; ///< Levels of parenthesized subexpressions
+    std::size_t expression_width{3}; ///< Most operands joined by the operators of one level
+
+    std::size_t nesting_depth{2}; ///< Levels of if, case and for inside a clocked process
+
+    double comment_density{0.1};    ///< Chance of a comment line before a declaration or statement
+    double blank_line_density{0.1}; ///< Chance of a blank line before a declaration or statement
+};
+
+/// @brief Writes syntactically valid VHDL, restricted to the constructs the translator
+///        supports, one entity and architecture pair at a time.
+/// @note The same options give the same bytes on every platform, so workloads can be
+///       regenerated instead of checked in.
+/// @return The number of bytes written.
+auto generate(const Options& options, std::ostream& out) -> std::size_t;
+
+[[nodiscard]]
+auto generate(const Options& options) -> std::string;
+
+} // namespace generator
+
+#endif /* TESTS_GENERATOR_GENERATOR_HPP */
@@ -0,0 +1,124 @@
+#include "generator/generator.hpp"
+
+#include <argparse/argparse.hpp>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace {
+
+// A byte count with an optional K, M or G suffix (powers of 1024)
+auto parseSize(std::string_view text) -> std::size_t
+{
+    std::size_t multiplier{1};
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K':
+                multiplier = 1024UZ;
+                break;
+            case 'M':
+                multiplier = 1024UZ * 1024;
+                break;
+            case 'G':
+                multiplier = 1024UZ * 1024 * 1024;
+                break;
+            default:
+                break;
+        }
+    }
+    const auto digits = multiplier == 1 ? text : text.substr(0, text.size() - 1);
+
+    std::size_t value{0};
+    const auto* const last = std::to_address(digits.end());
+    const auto [ptr, ec] = std::from_chars(digits.data(), last, value);
+
+    if (ec != std::errc{} || ptr != last || digits.empty()) {
+        throw std::runtime_error(
+          std::format("Invalid size, expected e.g. 64K or 500M: '{}'", text));
+    }
+
+    return value * multiplier;
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    generator::Options options{};
+
+    argparse::ArgumentParser program{"vhdl_generate"};
+    program.add_description("Writes reproducible synthetic VHDL for stress and performance tests.");
+
+    program.add_argument("--seed").default_value(options.seed).scan<'u', std::uint64_t>();
+    program.add_argument("--size")
+      .help("Generates until the output reaches this many bytes (K, M and G suffixes)")
+      .default_value(std::string{"64K"});
+    program.add_argument("--units")
+      .help("Entity and architecture pairs to generate instead of --size")
+      .default_value(options.units)
+      .scan<'u', std::size_t>();
+    program.add_argument("--ports").default_value(options.ports).scan<'u', std::size_t>();
+    program.add_argument("--generics").default_value(options.generics).scan<'u', std::size_t>();
+    program.add_argument("--expression-depth")
+      .help("Levels of parenthesized subexpressions")
+      .default_value(options.expression_depth)
+      .scan<'u', std::size_t>();
+    program.add_argument("--expression-width")
+      .help("Most operands joined by the operators of one level")
+      .default_value(options.expression_width)
+      .scan<'u', std::size_t>();
+    program.add_argument("--nesting-depth")
+      .help("Levels of if, case and for inside a clocked process")
+      .default_value(options.nesting_depth)
+      .scan<'u', std::size_t>();
+    program.add_argument("--comment-density")
+      .help("Chance of a comment line before a declaration or statement")
+      .default_value(options.comment_density)
+      .scan<'g', double>();
+    program.add_argument("--blank-line-density")
+      .help("Chance of a blank line before a declaration or statement")
+      .default_value(options.blank_line_density)
+      .scan<'g', double>();
+    program.add_argument("-o", "--output").help("File to write instead of stdout");
+
+    try {
+        program.parse_args(argc, argv);
+
+        options.seed = program.get<std::uint64_t>("--seed");
+        options.target_bytes = parseSize(program.get<std::string>("--size"));
+        options.units = program.get<std::size_t>("--units");
+        options.ports = program.get<std::size_t>("--ports");
+        options.generics = program.get<std::size_t>("--generics");
+        options.expression_depth = program.get<std::size_t>("--expression-depth");
+        options.expression_width = program.get<std::size_t>("--expression-width");
+        options.nesting_depth = program.get<std::size_t>("--nesting-depth");
+        options.comment_density = program.get<double>("--comment-density");
+        options.blank_line_density = program.get<double>("--blank-line-density");
+
+        if (const auto path = program.present("--output")) {
+            std::ofstream out{*path, std::ios::binary};
+            if (!out) {
+                throw std::runtime_error(std::format("Cannot write {}", *path));
+            }
+            generator::generate(options, out);
+        } else {
+            generator::generate(options, std::cout);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+#include "common/config.hpp"
+#include "generator/generator.hpp"
+#include "pipeline/format.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <string_view>
+
+namespace {
+
+auto occurrences(std::string_view text, std::string_view word) -> std::size_t
+{
+    std::size_t count{0};
+    for (auto pos = text.find(word); pos != std::string_view::npos;
+         pos = text.find(word, pos + word.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Generator output depends on the seed only", "[generator]")
+{
+    const generator::Options options{.seed = 7, .target_bytes = 16UZ * 1024};
+
+    CHECK(generator::generate(options) == generator::generate(options));
+    CHECK(generator::generate(options)
+          != generator::generate(generator::Options{.seed = 8, .target_bytes = 16UZ * 1024}));
+}
+
+TEST_CASE("Generator stops at the requested size", "[generator]")
+{
+    SECTION("Bytes")
+    {
+        const auto text = generator::generate(generator::Options{.target_bytes = 32UZ * 1024});
+        CHECK(text.size() >= 32UZ * 1024);
+    }
+
+    SECTION("Units")
+    {
+        const auto text = generator::generate(generator::Options{.units = 3});
+        CHECK(occurrences(text, "end entity") == 3);
+        CHECK(occurrences(text, "end architecture") == 3);
+    }
+}
+
+TEST_CASE("Generator density knobs", "[generator]")
+{
+    const auto silent = generator::generate(generator::Options{.comment_density = 0.0});
+    CHECK(occurrences(silent, "--") == 0);
+
+    const auto chatty = generator::generate(generator::Options{.comment_density = 1.0});
+    CHECK(occurrences(chatty, "--") > 0);
+}
+
+TEST_CASE("Generated code of every shape formats and verifies", "[generator]")
+{
+    const auto options = GENERATE(
+      generator::Options{},
+      generator::Options{.seed = 2, .ports = 0, .generics = 0},
+      generator::Options{.seed = 3, .expression_depth = 0, .expression_width = 1},
+      generator::Options{.seed = 4, .expression_depth = 6, .expression_width = 6},
+      generator::Options{.seed = 5, .nesting_depth = 0},
+      generator::Options{.seed = 6, .nesting_depth = 5},
+      generator::Options{.seed = 7, .comment_density = 0.8, .blank_line_density = 0.8});
+
+    const auto source = generator::generate(options);
+    INFO("seed " << options.seed);
+
+    // Verification re-lexes the output, so this also checks that nothing was lost
+    CHECK(pipeline::formatSource(source, common::Config{}).has_value());
+}
@@ -0,0 +1,203 @@
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "lsp/document.hpp"
+#include "pipeline/format.hpp"
+
+#include <algorithm>
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view CODE = "entity A is\n"
+                                  "port (x : in bit);\n"
+                                  "end A;\n"
+                                  "\n"
+                                  "entity B is end B;\n"
+                                  "\n"
+                                  "architecture rtl of A is\n"
+                                  "signal s:bit;\n"
+                                  "begin\n"
+                                  "s<=x;\n"
+                                  "end rtl;\n";
+
+auto applyEdits(std::string text, std::vector<lsp::TextEdit> edits) -> std::string
+{
+    // Back to front, so earlier offsets stay valid
+    std::ranges::sort(edits, {}, &lsp::TextEdit::begin);
+    for (const auto& edit : edits | std::views::reverse) {
+        text.replace(edit.begin, edit.end - edit.begin, edit.text);
+    }
+    return text;
+}
+
+auto formatWhole(std::string_view source) -> std::string
+{
+    const auto formatted = pipeline::formatSource(source, common::Config{});
+    REQUIRE(formatted.has_value());
+    return *formatted;
+}
+
+auto formatDocument(lsp::Document& doc) -> std::string
+{
+    const auto edits = doc.format(0, doc.text().size());
+    REQUIRE(edits.has_value());
+    return applyEdits(doc.text(), *edits);
+}
+
+} // namespace
+
+TEST_CASE("Document formatting matches the whole-file formatter", "[lsp][document]")
+{
+    lsp::Document doc{std::string{CODE}, common::Config{}};
+    REQUIRE(formatDocument(doc) == formatWhole(CODE));
+}
+
+TEST_CASE("Document edits only re-parse the touched unit", "[lsp][document]")
+{
+    lsp::Document doc{std::string{CODE}, common::Config{}};
+    static_cast<void>(formatDocument(doc));
+    REQUIRE(doc.parsedBytes() == CODE.size());
+
+    const std::string_view anchor{"entity B is"};
+    const auto insert_at = doc.text().find(anchor) + anchor.size();
+    doc.replace(insert_at, insert_at, " port (y : out bit);");
+
+    const auto before = doc.parsedBytes();
+    const auto text = doc.text();
+    REQUIRE(formatDocument(doc) == formatWhole(text));
+
+    // Unit B's chunk runs up to the architecture
+    const auto chunk_size = text.find("architecture") - text.find("entity B");
+    REQUIRE(doc.parsedBytes() - before == chunk_size);
+}
+
+TEST_CASE("Document formatting resumes after a cancelled request", "[lsp][document]")
+{
+    lsp::Document doc{std::string{CODE}, common::Config{}};
+    static_cast<void>(formatDocument(doc));
+
+    const std::string_view anchor{"entity B is"};
+    const auto insert_at = doc.text().find(anchor) + anchor.size();
+    doc.replace(insert_at, insert_at, " port (y : out bit);");
+
+    const auto cancellation = common::CancellationToken::withBudget();
+    cancellation.cancel();
+    REQUIRE_THROWS_AS(doc.format(0, doc.text().size(), cancellation), common::Cancelled);
+
+    const auto text = doc.text();
+    REQUIRE(formatDocument(doc) == formatWhole(text));
+}
+
+TEST_CASE("Document edits invalidate units whose tokens changed", "[lsp][document]")
+{
+    constexpr std::string_view LINE = "entity A is end A; entity B is end B;\n";
+    lsp::Document doc{std::string{LINE}, common::Config{}};
+    static_cast<void>(formatDocument(doc));
+
+    // Only touches unit A, but the comment swallows unit B as well
+    const auto at = LINE.find(';') + 1;
+    doc.replace(at, at, "--");
+    REQUIRE(formatDocument(doc) == formatWhole(doc.text()));
+}
+
+TEST_CASE("Document edits that add or move units", "[lsp][document]")
+{
+    lsp::Document doc{std::string{CODE}, common::Config{}};
+    static_cast<void>(formatDocument(doc));
+
+    SECTION("Appending a unit")
+    {
+        const auto end = doc.text().size();
+        doc.replace(end, end, "\npackage P is end P;\n");
+        REQUIRE(formatDocument(doc) == formatWhole(doc.text()));
+    }
+
+    SECTION("Moving a context clause to the next unit")
+    {
+        const auto at = doc.text().find("entity B");
+        doc.replace(at, at, "library ieee;\n");
+        REQUIRE(formatDocument(doc) == formatWhole(doc.text()));
+    }
+
+    SECTION("Recovering from a syntax error")
+    {
+        const auto at = doc.text().find("end A;");
+        doc.replace(at, at + 6, "");
+        REQUIRE_THROWS(doc.format(0, doc.text().size()));
+
+        doc.replace(at, at, "end A;");
+        REQUIRE(formatDocument(doc) == formatWhole(CODE));
+    }
+
+    SECTION("Replacing the whole buffer")
+    {
+        doc.replace(0, doc.text().size(), "entity C is end C;\n");
+        REQUIRE(formatDocument(doc) == formatWhole("entity C is end C;\n"));
+    }
+}
+
+TEST_CASE("Document range formatting is limited to overlapping units", "[lsp][document]")
+{
+    lsp::Document doc{std::string{CODE}, common::Config{}};
+
+    const auto in_a = doc.text().find("port");
+    const auto edits = doc.format(in_a, in_a);
+
+    REQUIRE(edits.has_value());
+    REQUIRE(edits->size() == 1);
+    REQUIRE(edits->front().begin == 0);
+    REQUIRE(edits->front().end == doc.text().find("entity B"));
+}
+
+TEST_CASE("Document positions", "[lsp][document]")
+{
+    // "-- " + U+00E9 (2 bytes) + U+1F600 (4 bytes, a surrogate pair in UTF-16)
+    const lsp::Document doc{"-- \xC3\xA9\xF0\x9F\x98\x80\r\nab", common::Config{}};
+
+    SECTION("UTF-16")
+    {
+        REQUIRE(doc.offsetAt({.line = 0, .character = 4}, lsp::PositionEncoding::UTF16) == 5);
+        REQUIRE(doc.offsetAt({.line = 0, .character = 6}, lsp::PositionEncoding::UTF16) == 9);
+        REQUIRE(doc.offsetAt({.line = 0, .character = 99}, lsp::PositionEncoding::UTF16) == 9);
+        REQUIRE(doc.offsetAt({.line = 1, .character = 1}, lsp::PositionEncoding::UTF16) == 12);
+
+        const auto position = doc.positionAt(9, lsp::PositionEncoding::UTF16);
+        REQUIRE(position.line == 0);
+        REQUIRE(position.character == 6);
+    }
+
+    SECTION("UTF-8")
+    {
+        REQUIRE(doc.offsetAt({.line = 0, .character = 5}, lsp::PositionEncoding::UTF8) == 5);
+
+        const auto position = doc.positionAt(12, lsp::PositionEncoding::UTF8);
+        REQUIRE(position.line == 1);
+        REQUIRE(position.character == 1);
+    }
+}
+
+TEST_CASE("Document positions follow edits", "[lsp][document]")
+{
+    lsp::Document doc{"entity A is\nend A;\n\nentity B is\nend B;\n", common::Config{}};
+
+    doc.replace(0, 0, "-- one\n-- two\n");
+    doc.replace(doc.text().find("end A;\n\n"), doc.text().find("entity B"), "end A; ");
+    doc.replace(doc.text().size(), doc.text().size(), "\n\n");
+    doc.replace(3, 9, "x\ny");
+
+    // The same buffer indexed from scratch
+    const lsp::Document fresh{doc.text(), common::Config{}};
+    for (std::size_t offset = 0; offset <= doc.text().size(); ++offset) {
+        INFO("offset " << offset);
+        const auto edited = doc.positionAt(offset, lsp::PositionEncoding::UTF8);
+        const auto expected = fresh.positionAt(offset, lsp::PositionEncoding::UTF8);
+        REQUIRE(edited.line == expected.line);
+        REQUIRE(edited.character == expected.character);
+    }
+}
@@ -0,0 +1,152 @@
+#include "lsp/inbox.hpp"
+#include "lsp/transport.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using nlohmann::json;
+
+constexpr std::string_view URI{"file:///work/top.vhd"};
+
+auto frame(const std::vector<std::string>& bodies) -> std::stringstream
+{
+    std::stringstream stream{};
+    lsp::Transport writer{stream, stream};
+    for (const auto& body : bodies) {
+        writer.write(body);
+    }
+    return stream;
+}
+
+auto formatting(int id) -> std::string
+{
+    return json{
+      {"jsonrpc", "2.0"                                              },
+      {"id",      id                                                 },
+      {"method",  "textDocument/formatting"                          },
+      {"params",  {{"textDocument", {{"uri", URI}}}, {"options", {}}}},
+    }
+      .dump();
+}
+
+auto cancel(int id) -> std::string
+{
+    return json{
+      {"jsonrpc", "2.0"            },
+      {"method",  "$/cancelRequest"},
+      {"params",  {{"id", id}}     },
+    }
+      .dump();
+}
+
+auto didChange() -> std::string
+{
+    return json{
+      {"jsonrpc", "2.0"                   },
+      {"method",  "textDocument/didChange"},
+      {"params",
+       {{"textDocument", {{"uri", URI}, {"version", 2}}},
+        {"contentChanges", json::array({{{"text", "entity A is end A;\n"}}})}}},
+    }
+      .dump();
+}
+
+} // namespace
+
+// Whether a request was still queued or already in flight when its cancellation was read
+// depends on the reader thread; taking the cancellation with next() settles it either way.
+
+TEST_CASE("Inbox cancels requests in flight", "[lsp][inbox]")
+{
+    auto input = frame({formatting(2), cancel(2), formatting(3)});
+    std::stringstream output{};
+    lsp::Transport transport{input, output};
+    lsp::Inbox inbox{transport, std::nullopt};
+
+    const auto first = inbox.next();
+    REQUIRE(first.kind == lsp::Inbound::Kind::MESSAGE);
+    REQUIRE(inbox.next().message.at("method") == "$/cancelRequest");
+
+    REQUIRE(first.cancellation.isCancelled());
+    REQUIRE_FALSE(inbox.finish());
+
+    const auto second = inbox.next();
+    REQUIRE(second.message.at("id") == 3);
+    REQUIRE_FALSE(second.cancellation.isCancelled());
+    REQUIRE_FALSE(inbox.finish());
+
+    REQUIRE(inbox.next().kind == lsp::Inbound::Kind::CLOSED);
+}
+
+TEST_CASE("Inbox cancels queued requests", "[lsp][inbox]")
+{
+    auto input = frame({formatting(2), formatting(3), cancel(3)});
+    std::stringstream output{};
+    lsp::Transport transport{input, output};
+    lsp::Inbox inbox{transport, std::nullopt};
+
+    const auto first = inbox.next();
+    REQUIRE_FALSE(inbox.finish());
+
+    const auto second = inbox.next();
+    REQUIRE(inbox.next().message.at("method") == "$/cancelRequest");
+
+    REQUIRE_FALSE(first.cancellation.isCancelled());
+    REQUIRE(second.cancellation.isCancelled());
+    REQUIRE_FALSE(inbox.finish());
+}
+
+TEST_CASE("Inbox supersedes requests on a changed document", "[lsp][inbox]")
+{
+    auto input = frame({formatting(2), didChange(), formatting(3)});
+    std::stringstream output{};
+    lsp::Transport transport{input, output};
+    lsp::Inbox inbox{transport, std::nullopt};
+
+    const auto first = inbox.next();
+    REQUIRE(inbox.next().message.at("method") == "textDocument/didChange");
+
+    REQUIRE(first.cancellation.isCancelled());
+    REQUIRE(inbox.finish());
+
+    // Requests made after the change see the new text
+    const auto second = inbox.next();
+    REQUIRE_FALSE(second.cancellation.isCancelled());
+    REQUIRE_FALSE(inbox.finish());
+}
+
+TEST_CASE("Inbox applies the time budget to every request", "[lsp][inbox]")
+{
+    auto input = frame({formatting(2)});
+    std::stringstream output{};
+    lsp::Transport transport{input, output};
+    lsp::Inbox inbox{transport, std::chrono::milliseconds{0}};
+
+    const auto request = inbox.next();
+    REQUIRE(request.cancellation.isCancelled());
+    REQUIRE_FALSE(inbox.finish());
+}
+
+TEST_CASE("Inbox reports unreadable messages", "[lsp][inbox]")
+{
+    auto input = frame({"{not json", formatting(2)});
+    std::stringstream output{};
+    lsp::Transport transport{input, output};
+    lsp::Inbox inbox{transport, std::nullopt};
+
+    const auto invalid = inbox.next();
+    REQUIRE(invalid.kind == lsp::Inbound::Kind::INVALID_JSON);
+    REQUIRE_FALSE(invalid.error.empty());
+
+    REQUIRE(inbox.next().kind == lsp::Inbound::Kind::MESSAGE);
+    REQUIRE_FALSE(inbox.finish());
+    REQUIRE(inbox.next().kind == lsp::Inbound::Kind::CLOSED);
+}
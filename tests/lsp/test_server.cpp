@@ -0,0 +1,206 @@
+#include "common/config.hpp"
+#include "lsp/document.hpp"
+#include "lsp/server.hpp"
+#include "lsp/transport.hpp"
+#include "pipeline/format.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using nlohmann::json;
+
+constexpr std::string_view URI{"file:///work/top.vhd"};
+constexpr std::string_view CODE = "entity A is\nport (x : in bit);\nend A;\n";
+
+/// @brief Runs a server over the given messages and returns its exit code and replies.
+auto serve(const std::vector<json>& messages) -> std::pair<int, std::vector<json>>
+{
+    std::stringstream input{};
+    std::stringstream output{};
+
+    {
+        lsp::Transport writer{input, input};
+        for (const auto& message : messages) {
+            writer.write(message.dump());
+        }
+    }
+
+    lsp::Transport transport{input, output};
+    const auto exit_code = lsp::Server{transport, common::Config{}}.run();
+
+    std::vector<json> replies{};
+    lsp::Transport reader{output, output};
+    while (const auto body = reader.read()) {
+        replies.push_back(json::parse(*body));
+    }
+
+    return {exit_code, replies};
+}
+
+auto request(int id, std::string_view method, json params = json::object()) -> json
+{
+    return json{
+      {"jsonrpc", "2.0"          },
+      {"id",      id             },
+      {"method",  method         },
+      {"params",  std::move(params)},
+    };
+}
+
+auto notification(std::string_view method, json params = json::object()) -> json
+{
+    return json{
+      {"jsonrpc", "2.0"          },
+      {"method",  method         },
+      {"params",  std::move(params)},
+    };
+}
+
+auto didOpen(std::string_view text) -> json
+{
+    return notification("textDocument/didOpen",
+                        {
+                          {"textDocument",
+                           {{"uri", URI}, {"languageId", "vhdl"}, {"version", 1}, {"text", text}}},
+    });
+}
+
+auto applyEdits(std::string_view text, const json& edits) -> std::string
+{
+    // Positions refer to the original text; apply back to front
+    const lsp::Document doc{std::string{text}, common::Config{}};
+    std::string result{text};
+
+    for (auto it = edits.rbegin(); it != edits.rend(); ++it) {
+        const auto& range = it->at("range");
+        const auto to_offset = [&doc](const json& position) {
+            return doc.offsetAt({.line = position.at("line").get<std::size_t>(),
+                                 .character = position.at("character").get<std::size_t>()},
+                                lsp::PositionEncoding::UTF16);
+        };
+
+        const auto begin = to_offset(range.at("start"));
+        const auto end = to_offset(range.at("end"));
+        result.replace(begin, end - begin, it->at("newText").get<std::string>());
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Server formats an open document", "[lsp][server]")
+{
+    const auto [exit_code, replies] = serve({
+      request(1, "initialize"),
+      notification("initialized"),
+      didOpen(CODE),
+      request(2, "textDocument/formatting", {{"textDocument", {{"uri", URI}}}, {"options", {}}}),
+      request(3, "shutdown"),
+      notification("exit"),
+    });
+
+    REQUIRE(exit_code == EXIT_SUCCESS);
+    REQUIRE(replies.size() == 3);
+
+    const auto& capabilities = replies.at(0).at("result").at("capabilities");
+    REQUIRE(capabilities.at("documentFormattingProvider") == true);
+    REQUIRE(capabilities.at("positionEncoding") == "utf-16");
+
+    const auto formatted = pipeline::formatSource(CODE, common::Config{});
+    REQUIRE(formatted.has_value());
+    REQUIRE(applyEdits(CODE, replies.at(1).at("result")) == *formatted);
+
+    REQUIRE(replies.at(2).at("result").is_null());
+}
+
+TEST_CASE("Server applies incremental changes", "[lsp][server]")
+{
+    const auto change = notification(
+      "textDocument/didChange",
+      {
+        {"textDocument", {{"uri", URI}, {"version", 2}}},
+        {"contentChanges",
+         json::array({{{"range",
+                        {{"start", {{"line", 0}, {"character", 7}}},
+                         {"end", {{"line", 0}, {"character", 8}}}}},
+                       {"text", "Top"}}})},
+    });
+
+    const auto [exit_code, replies] = serve({
+      request(1, "initialize"),
+      didOpen(CODE),
+      change,
+      request(2, "textDocument/formatting", {{"textDocument", {{"uri", URI}}}}),
+      request(3, "shutdown"),
+      notification("exit"),
+    });
+
+    REQUIRE(exit_code == EXIT_SUCCESS);
+
+    const std::string_view changed = "entity Top is\nport (x : in bit);\nend A;\n";
+    const auto formatted = pipeline::formatSource(changed, common::Config{});
+    REQUIRE(formatted.has_value());
+    REQUIRE(applyEdits(changed, replies.at(1).at("result")) == *formatted);
+}
+
+TEST_CASE("Server negotiates UTF-8 positions", "[lsp][server]")
+{
+    const auto [exit_code, replies] = serve({
+      request(1,
+              "initialize",
+              {{"capabilities", {{"general", {{"positionEncodings", {"utf-8", "utf-16"}}}}}}}),
+      notification("exit"),
+    });
+
+    REQUIRE(exit_code == EXIT_FAILURE);
+    REQUIRE(replies.at(0).at("result").at("capabilities").at("positionEncoding") == "utf-8");
+}
+
+TEST_CASE("Server error responses", "[lsp][server]")
+{
+    const auto code_of = [](const json& reply) { return reply.at("error").at("code").get<int>(); };
+
+    SECTION("Requests before initialize")
+    {
+        const auto [exit_code, replies] = serve({request(1, "shutdown"), notification("exit")});
+
+        REQUIRE(exit_code == EXIT_FAILURE);
+        REQUIRE(code_of(replies.at(0)) == static_cast<int>(lsp::ErrorCode::SERVER_NOT_INITIALIZED));
+    }
+
+    SECTION("Unknown methods and documents, syntax errors")
+    {
+        const auto [exit_code, replies] = serve({
+          request(1, "initialize"),
+          request(2, "textDocument/hover"),
+          request(3, "textDocument/formatting", {{"textDocument", {{"uri", "file:///nope"}}}}),
+          didOpen("entity A is"),
+          request(4, "textDocument/formatting", {{"textDocument", {{"uri", URI}}}}),
+          request(5,
+                  "textDocument/onTypeFormatting",
+                  {{"textDocument", {{"uri", URI}}},
+                   {"position", {{"line", 0}, {"character", 11}}},
+                   {"ch", ";"}}),
+          request(6, "shutdown"),
+          notification("exit"),
+        });
+
+        REQUIRE(exit_code == EXIT_SUCCESS);
+        REQUIRE(code_of(replies.at(1)) == static_cast<int>(lsp::ErrorCode::METHOD_NOT_FOUND));
+        REQUIRE(code_of(replies.at(2)) == static_cast<int>(lsp::ErrorCode::INVALID_PARAMS));
+        REQUIRE(code_of(replies.at(3)) == static_cast<int>(lsp::ErrorCode::REQUEST_FAILED));
+
+        // Incomplete input while typing is not an error
+        REQUIRE(replies.at(4).at("result") == json::array());
+    }
+}
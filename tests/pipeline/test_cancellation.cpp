@@ -0,0 +1,153 @@
+#include "builder/ast_builder.hpp"
+#include "common/cancellation.hpp"
+#include "common/config.hpp"
+#include "pipeline/changes.hpp"
+#include "pipeline/format.hpp"
+#include "pipeline/render_cache.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view CODE = R"(entity A is
+port(clk : in std_logic);
+end A;
+
+architecture rtl of A is begin end rtl;
+)";
+
+auto cancelled() -> common::CancellationToken
+{
+    auto token = common::CancellationToken::withBudget();
+    token.cancel();
+    return token;
+}
+
+} // namespace
+
+TEST_CASE("Cancellation tokens", "[pipeline][cancellation]")
+{
+    SECTION("A default token is never cancelled")
+    {
+        const common::CancellationToken token{};
+        token.cancel();
+
+        REQUIRE_FALSE(token.isCancelled());
+        REQUIRE_NOTHROW(token.check());
+    }
+
+    SECTION("Copies share the flag")
+    {
+        const auto token = common::CancellationToken::withBudget();
+        const auto copy = token;
+
+        REQUIRE_FALSE(copy.isCancelled());
+        token.cancel();
+        REQUIRE(copy.isCancelled());
+    }
+
+    SECTION("A spent budget counts as a timeout")
+    {
+        const auto token = common::CancellationToken::withBudget(std::chrono::milliseconds{0});
+
+        REQUIRE(token.isCancelled());
+        try {
+            token.check();
+            FAIL("check() did not throw");
+        }
+        catch (const common::Cancelled& e) {
+            REQUIRE(e.timedOut());
+        }
+    }
+
+    SECTION("poll() reads the flag every time and the clock on the first call")
+    {
+        const auto spent = common::CancellationToken::withBudget(std::chrono::milliseconds{0});
+        REQUIRE_THROWS_AS(spent.poll(), common::Cancelled);
+
+        const auto token = common::CancellationToken::withBudget();
+        token.poll();
+        token.cancel();
+        REQUIRE_THROWS_AS(token.poll(), common::Cancelled);
+    }
+}
+
+TEST_CASE("Cancelled formatting throws", "[pipeline][cancellation]")
+{
+    const common::Config config{};
+    pipeline::RenderCache::instance().clear();
+
+    REQUIRE_THROWS_AS(pipeline::formatSource(CODE, config, cancelled()), common::Cancelled);
+    REQUIRE_THROWS_AS(pipeline::formatEdits(CODE, config, cancelled()), common::Cancelled);
+    REQUIRE_THROWS_AS(pipeline::formatUnits(CODE, config, cancelled()), common::Cancelled);
+    REQUIRE_THROWS_AS(
+      pipeline::formatRanges(CODE, std::array{pipeline::LineRange{.first = 1, .last = 1}}, config,
+                             cancelled()),
+      common::Cancelled);
+
+    // The parser bailed out before any unit was rendered
+    REQUIRE(pipeline::RenderCache::instance().stats().entries == 0);
+}
+
+TEST_CASE("A workspace formats again after a cancelled run", "[pipeline][cancellation]")
+{
+    const common::Config config{};
+    pipeline::Workspace workspace{};
+
+    REQUIRE_THROWS_AS(pipeline::formatSource(CODE, config, workspace, cancelled()),
+                      common::Cancelled);
+
+    const auto formatted = pipeline::formatSource(CODE, config, workspace);
+    const auto expected = pipeline::formatSource(CODE, config);
+    REQUIRE(formatted.has_value());
+    REQUIRE(expected.has_value());
+    REQUIRE(*formatted == *expected);
+}
+
+TEST_CASE("A cancelled render is not cached", "[pipeline][cancellation]")
+{
+    const common::Config config{};
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    auto ctx = builder::createContext(CODE);
+    const auto root = builder::build(ctx);
+    REQUIRE_FALSE(root.units.empty());
+
+    REQUIRE_THROWS_AS(cache.render(root.units.front(), config, cancelled()), common::Cancelled);
+    REQUIRE(cache.stats().entries == 0);
+
+    REQUIRE_FALSE(cache.render(root.units.front(), config).empty());
+    REQUIRE(cache.stats().entries == 1);
+}
+
+TEST_CASE("formatChanges reports files over their time budget", "[pipeline][cancellation]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "test_timeout_per_file.vhd";
+    {
+        std::ofstream file{path};
+        file << CODE;
+    }
+
+    const std::array changes{
+      pipeline::FileChanges{.path = path, .lines = {pipeline::LineRange{.first = 1, .last = 5}}},
+    };
+
+    const auto results = pipeline::formatChanges(changes, common::Config{}, 1,
+                                                 std::chrono::milliseconds{0});
+    REQUIRE(results.size() == 1);
+    REQUIRE_FALSE(results.front().formatted.has_value());
+    REQUIRE(results.front().formatted.error().message.contains("time budget"));
+
+    // Without a budget the same file formats
+    const auto unlimited = pipeline::formatChanges(changes, common::Config{}, 1);
+    REQUIRE(unlimited.front().formatted.has_value());
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,109 @@
+#include "common/config.hpp"
+#include "pipeline/changes.hpp"
+#include "pipeline/format.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("parseChanges reads a unified diff", "[pipeline][changes]")
+{
+    constexpr std::string_view DIFF = "diff --git a/rtl/top.vhd b/rtl/top.vhd\n"
+                                      "index 1111111..2222222 100644\n"
+                                      "--- a/rtl/top.vhd\n"
+                                      "+++ b/rtl/top.vhd\n"
+                                      "@@ -10,3 +12,4 @@ architecture rtl of top is\n"
+                                      "-    signal a : bit;\n"
+                                      "+    signal b : bit;\n"
+                                      "@@ -40,2 +43,0 @@\n"
+                                      "-    -- removed\n"
+                                      "diff --git a/README.md b/README.md\n"
+                                      "--- a/README.md\n"
+                                      "+++ b/README.md\n"
+                                      "@@ -1 +1 @@\n"
+                                      "diff --git a/old.vhd b/old.vhd\n"
+                                      "--- a/old.vhd\n"
+                                      "+++ /dev/null\n"
+                                      "@@ -1,3 +0,0 @@\n"
+                                      "--- a/PKG.VHDL\r\n"
+                                      "+++ b/PKG.VHDL\t2024-01-01 00:00:00\r\n"
+                                      "@@ -1 +1 @@\r\n";
+
+    const auto changes = pipeline::parseChanges(DIFF);
+
+    REQUIRE(changes.size() == 2);
+
+    REQUIRE(changes.at(0).path == "rtl/top.vhd");
+    REQUIRE(changes.at(0).lines.size() == 2);
+    REQUIRE(changes.at(0).lines.at(0).first == 12);
+    REQUIRE(changes.at(0).lines.at(0).last == 15);
+
+    // A pure deletion touches the line before it
+    REQUIRE(changes.at(0).lines.at(1).first == 43);
+    REQUIRE(changes.at(0).lines.at(1).last == 43);
+
+    REQUIRE(changes.at(1).path == "PKG.VHDL");
+    REQUIRE(changes.at(1).lines.at(0).first == 1);
+    REQUIRE(changes.at(1).lines.at(0).last == 1);
+}
+
+TEST_CASE("parseChanges reads path:first:last lines", "[pipeline][changes]")
+{
+    const auto changes = pipeline::parseChanges("# comment\n"
+                                                "a.vhd:1:5\n"
+                                                "\n"
+                                                "dir/b.vhd:7:7\n"
+                                                "a.vhd:20:30\n");
+
+    REQUIRE(changes.size() == 2);
+    REQUIRE(changes.at(0).path == "a.vhd");
+    REQUIRE(changes.at(0).lines.size() == 2);
+    REQUIRE(changes.at(0).lines.at(1).first == 20);
+    REQUIRE(changes.at(1).path == "dir/b.vhd");
+
+    REQUIRE_THROWS(pipeline::parseChanges("a.vhd:5\n"));
+    REQUIRE_THROWS(pipeline::parseChanges("a.vhd:9:3\n"));
+    REQUIRE_THROWS(pipeline::parseChanges("a.vhd:x:3\n"));
+}
+
+TEST_CASE("formatChanges formats every file on the pool", "[pipeline][changes]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "vhdl_fmt_changes";
+    std::filesystem::create_directories(dir);
+
+    constexpr std::string_view CODE = "entity   A is end A;\nentity   B is end B;\n";
+
+    std::vector<pipeline::FileChanges> changes{};
+    const auto add = [&](std::string_view name, std::size_t line) {
+        changes.push_back(pipeline::FileChanges{.path = dir / name,
+                                                .lines = {{.first = line, .last = line}}});
+    };
+
+    for (const auto* name : {"one.vhd", "two.vhd", "three.vhd", "four.vhd"}) {
+        std::ofstream{dir / name} << CODE;
+        add(name, 2);
+    }
+    std::ofstream{dir / "broken.vhd"} << "entity A is\n";
+    add("broken.vhd", 1);
+    add("missing.vhd", 1);
+
+    const auto expected = pipeline::formatRange(CODE, {.first = 2, .last = 2}, common::Config{});
+    REQUIRE(expected.has_value());
+
+    const auto results = pipeline::formatChanges(changes, common::Config{}, 3);
+
+    REQUIRE(results.size() == changes.size());
+    for (std::size_t i = 0; i < 4; ++i) {
+        REQUIRE(results.at(i).path == changes.at(i).path);
+        REQUIRE(results.at(i).source == CODE);
+        REQUIRE(results.at(i).formatted.value() == *expected);
+    }
+    REQUIRE_FALSE(results.at(4).formatted.has_value());
+    REQUIRE_FALSE(results.at(5).formatted.has_value());
+
+    std::filesystem::remove_all(dir);
+}
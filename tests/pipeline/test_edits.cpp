@@ -0,0 +1,95 @@
+#include "common/config.hpp"
+#include "pipeline/edits.hpp"
+#include "pipeline/format.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+auto editsFor(std::string_view source) -> std::vector<pipeline::TextEdit>
+{
+    const auto edits = pipeline::formatEdits(source, common::Config{});
+    REQUIRE(edits.has_value());
+
+    // Sorted and disjoint, so they can be applied in one pass
+    for (std::size_t i = 1; i < edits->size(); ++i) {
+        REQUIRE(edits->at(i - 1).offset + edits->at(i - 1).length < edits->at(i).offset);
+    }
+
+    return *edits;
+}
+
+auto formatWhole(std::string_view source) -> std::string
+{
+    const auto formatted = pipeline::formatSource(source, common::Config{});
+    REQUIRE(formatted.has_value());
+    return *formatted;
+}
+
+} // namespace
+
+TEST_CASE("Applying the edits reproduces formatSource", "[pipeline][edits]")
+{
+    const auto code = GENERATE(as<std::string_view>{},
+                               "entity A is end A;\n",
+                               "ENTITY   A IS END A;",
+                               "-- \xC3\xA9t\xC3\xA9\nentity A is\nport(clk:in bit;q:out bit);\nend A;\n",
+                               "architecture rtl of A is\n"
+                               "  signal s : bit; -- inline\n"
+                               "begin\n"
+                               "  s <= a   and b;\n"
+                               "end rtl;\n");
+
+    INFO(code);
+    REQUIRE(pipeline::applyEdits(code, editsFor(code)) == formatWhole(code));
+}
+
+TEST_CASE("Applying the edits reproduces formatSource on the corpus", "[pipeline][edits]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        CHECK(pipeline::applyEdits(source, editsFor(source)) == formatWhole(source));
+    }
+}
+
+TEST_CASE("Formatted input needs no edits", "[pipeline][edits]")
+{
+    const auto formatted = formatWhole("entity A is\nport(clk:in bit);\nend A;\n");
+
+    REQUIRE(editsFor(formatted).empty());
+}
+
+TEST_CASE("Edits only cover the bytes that change", "[pipeline][edits]")
+{
+    const auto formatted = formatWhole("entity A is\nport(clk:in bit;q:out bit);\nend A;\n");
+
+    // One stray run of spaces inside an otherwise formatted file
+    auto source = formatted;
+    source.insert(source.find(" bit"), "   ");
+
+    const auto edits = editsFor(source);
+
+    REQUIRE(edits.size() == 1);
+    REQUIRE(edits.front().length == 3);
+    REQUIRE(edits.front().replacement.empty());
+}
+
+TEST_CASE("computeEdits without spans falls back to one trimmed edit", "[pipeline][edits]")
+{
+    const auto edits = pipeline::computeEdits("entity   A", "entity A", {});
+
+    REQUIRE(edits.size() == 1);
+    REQUIRE(edits.front().offset == 7);
+    REQUIRE(edits.front().length == 2);
+    REQUIRE(edits.front().replacement.empty());
+}
@@ -0,0 +1,436 @@
+#include "common/config.hpp"
+#include "common/stats.hpp"
+#include "pipeline/format.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <ios>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+auto concatFormatted(std::string_view source) -> std::string
+{
+    const auto units = pipeline::formatUnits(source, common::Config{});
+    REQUIRE(units.has_value());
+
+    std::string formatted{};
+    std::string chunks{};
+    for (const auto& unit : *units) {
+        formatted += unit.formatted;
+        chunks += unit.source;
+    }
+
+    // The chunks tile the input without gaps or overlap
+    REQUIRE(chunks == source);
+    return formatted;
+}
+
+auto formatWhole(std::string_view source) -> std::string
+{
+    const auto formatted = pipeline::formatSource(source, common::Config{});
+    REQUIRE(formatted.has_value());
+    return *formatted;
+}
+
+auto formatStreamed(std::string_view source, std::size_t block_size) -> std::string
+{
+    std::istringstream input{std::string{source}};
+    std::ostringstream output{};
+
+    const auto result = pipeline::formatStream(input, output, common::Config{}, {}, block_size);
+    REQUIRE(result.has_value());
+    return output.str();
+}
+
+} // namespace
+
+TEST_CASE("formatUnits matches formatSource", "[pipeline]")
+{
+    const auto code = GENERATE(as<std::string_view>{},
+                               "entity A is end A;\n",
+                               "-- File header\n\nentity A is end A;\narchitecture rtl of A is begin end rtl;\n",
+                               "entity A is end A; -- inline\n\n\n-- Before B\nentity B is end B;\n",
+                               "library ieee;\nuse ieee.std_logic_1164.all;\nentity A is end A;\n"
+                               "library ieee;\npackage P is end P;\n-- trailing\n",
+                               "-- \xC3\xA9t\xC3\xA9 \xE2\x82\xAC\nentity A is end A;\n-- \xF0\x9F\x98\x80\n"
+                               "entity B is end B;\n");
+
+    INFO(code);
+    REQUIRE(concatFormatted(code) == formatWhole(code));
+}
+
+TEST_CASE("formatUnits matches formatSource on the corpus", "[pipeline]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        CHECK(concatFormatted(source) == formatWhole(source));
+    }
+}
+
+TEST_CASE("A reused workspace formats like a fresh parse", "[pipeline]")
+{
+    pipeline::Workspace workspace{};
+
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        const auto formatted = pipeline::formatSource(source, common::Config{}, workspace);
+        REQUIRE(formatted.has_value());
+        CHECK(*formatted == formatWhole(source));
+    }
+}
+
+TEST_CASE("formatUnits on a file without design units", "[pipeline]")
+{
+    const auto units = pipeline::formatUnits("-- nothing to see\n", common::Config{});
+
+    REQUIRE(units.has_value());
+    REQUIRE(units->empty());
+}
+
+TEST_CASE("Syntax errors are reported as exceptions", "[pipeline]")
+{
+    REQUIRE_THROWS(pipeline::formatUnits("entity A is", common::Config{}));
+    REQUIRE_THROWS(pipeline::formatSource("entity A is", common::Config{}));
+}
+
+TEST_CASE("formatRange over the whole file matches formatSource", "[pipeline][range]")
+{
+    const auto source = std::string_view{"library ieee;\nuse ieee.std_logic_1164.all;\n"
+                                         "entity   A is end A;\n"
+                                         "architecture rtl of A is begin end rtl;\n"};
+
+    const auto formatted =
+      pipeline::formatRange(source, {.first = 1, .last = 100}, common::Config{});
+
+    REQUIRE(formatted.has_value());
+    REQUIRE(*formatted == formatWhole(source));
+}
+
+TEST_CASE("formatRange only touches the units overlapping the lines", "[pipeline][range]")
+{
+    const auto source = std::string_view{"entity   A is end A;\n"
+                                         "-- between\n"
+                                         "entity   B is\n"
+                                         "end B;\n"
+                                         "entity   C is end C;\n"};
+
+    const auto units = pipeline::formatUnits(source, common::Config{});
+    REQUIRE(units.has_value());
+    REQUIRE(units->size() == 3);
+
+    SECTION("Middle unit")
+    {
+        const auto formatted =
+          pipeline::formatRange(source, {.first = 4, .last = 4}, common::Config{});
+
+        REQUIRE(formatted.has_value());
+        REQUIRE(*formatted == units->at(0).source + units->at(1).formatted + units->at(2).source);
+    }
+
+    SECTION("Trivia between units belongs to the earlier unit")
+    {
+        const auto formatted =
+          pipeline::formatRange(source, {.first = 2, .last = 2}, common::Config{});
+
+        REQUIRE(formatted.has_value());
+        REQUIRE(*formatted == units->at(0).formatted + units->at(1).source + units->at(2).source);
+    }
+
+    SECTION("Past the end of the file")
+    {
+        const auto formatted =
+          pipeline::formatRange(source, {.first = 50, .last = 60}, common::Config{});
+
+        REQUIRE(formatted.has_value());
+        REQUIRE(*formatted == source);
+    }
+}
+
+TEST_CASE("formatRanges leaves the units between two ranges alone", "[pipeline][range]")
+{
+    const auto source = std::string_view{"entity   A is end A;\n"
+                                         "entity   B is end B;\n"
+                                         "entity   C is end C;\n"};
+
+    const auto units = pipeline::formatUnits(source, common::Config{});
+    REQUIRE(units.has_value());
+    REQUIRE(units->size() == 3);
+
+    const std::vector<pipeline::LineRange> lines{
+      {.first = 1, .last = 1},
+      {.first = 3, .last = 3}
+    };
+    const auto formatted = pipeline::formatRanges(source, lines, common::Config{});
+
+    REQUIRE(formatted.has_value());
+    REQUIRE(*formatted == units->at(0).formatted + units->at(1).source + units->at(2).formatted);
+}
+
+TEST_CASE("formatRange recovers from a unit split by the boundary scan", "[pipeline][range]")
+{
+    // The `use` clause after `end component;` looks like the start of a design unit
+    const auto source = std::string_view{"entity   A is end A;\n"
+                                         "architecture rtl of A is\n"
+                                         "    component C is end component;\n"
+                                         "    use work.P.all;\n"
+                                         "    signal   s : bit;\n"
+                                         "begin end rtl;\n"};
+
+    const auto units = pipeline::formatUnits(source, common::Config{});
+    REQUIRE(units.has_value());
+    REQUIRE(units->size() == 2);
+
+    const auto formatted =
+      pipeline::formatRange(source, {.first = 5, .last = 5}, common::Config{});
+
+    REQUIRE(formatted.has_value());
+    REQUIRE(*formatted == units->at(0).source + units->at(1).formatted);
+}
+
+TEST_CASE("formatRange over the corpus matches formatSource", "[pipeline][range]")
+{
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        const auto formatted =
+          pipeline::formatRange(source,
+                                {.first = 1, .last = source.size() + 1},
+                                common::Config{});
+
+        REQUIRE(formatted.has_value());
+        CHECK(*formatted == formatWhole(source));
+    }
+}
+
+TEST_CASE("formatRange reports syntax errors in the selected units", "[pipeline][range]")
+{
+    REQUIRE_THROWS(pipeline::formatRange(
+      "entity A is end A;\nentity B is\n", {.first = 2, .last = 2}, common::Config{}));
+}
+
+TEST_CASE("formatStream matches formatSource whatever the block size", "[pipeline][stream]")
+{
+    const auto block_size = GENERATE(1UZ, 64UZ, 4096UZ, pipeline::STREAM_BLOCK_SIZE);
+
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string() << " in blocks of " << block_size);
+
+        const auto source = pipeline::readSource(entry.path());
+        CHECK(formatStreamed(source, block_size) == formatWhole(source));
+    }
+}
+
+TEST_CASE("formatStream joins a unit split by the boundary scan", "[pipeline][stream]")
+{
+    const auto source = std::string_view{"entity   A is end A;\n"
+                                         "architecture rtl of A is\n"
+                                         "    component C is end component;\n"
+                                         "    use work.P.all;\n"
+                                         "    signal   s : bit;\n"
+                                         "begin end rtl;\n"};
+
+    const auto block_size = GENERATE(1UZ, 16UZ, pipeline::STREAM_BLOCK_SIZE);
+    INFO(block_size);
+
+    REQUIRE(formatStreamed(source, block_size) == formatWhole(source));
+}
+
+TEST_CASE("formatStream on a file without design units", "[pipeline][stream]")
+{
+    const auto source = std::string_view{"-- nothing to see\n"};
+    REQUIRE(formatStreamed(source, 4) == formatWhole(source));
+}
+
+TEST_CASE("formatStream reports syntax errors as exceptions", "[pipeline][stream]")
+{
+    std::istringstream input{"entity A is end A;\nentity B is\n"};
+    std::ostringstream output{};
+
+    REQUIRE_THROWS(pipeline::formatStream(input, output, common::Config{}));
+}
+
+TEST_CASE("formatStream reports a syntax error before reading on", "[pipeline][stream]")
+{
+    std::string source{"entity A is end A;\nentity B is port (x : in bit end B;\n"};
+    for (std::size_t i = 0; i < 100; ++i) {
+        source += std::format("entity E{} is end E{};\n", i, i);
+    }
+
+    std::istringstream input{source};
+    std::ostringstream output{};
+
+    REQUIRE_THROWS(pipeline::formatStream(input, output, common::Config{}, {}, 64));
+    CHECK_FALSE(input.eof());
+    CHECK(output.str().find("E99") == std::string::npos);
+}
+
+TEST_CASE("formatStream reports read errors", "[pipeline][stream]")
+{
+    std::istringstream input{"entity A is end A;\n"};
+    input.setstate(std::ios::badbit);
+    std::ostringstream output{};
+
+    REQUIRE_THROWS_AS(pipeline::formatStream(input, output, common::Config{}), std::runtime_error);
+}
+
+TEST_CASE("writeSource leaves the file alone when the writer gives up", "[pipeline][stream]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "vhdl-fmt-write-source.vhd";
+    pipeline::writeSource(path, "entity A is end A;\n");
+
+    const auto replaced = pipeline::writeSource(path, [](std::ostream& output) {
+        output << "entity B";
+        return false;
+    });
+
+    REQUIRE_FALSE(replaced);
+    REQUIRE(pipeline::readSource(path) == "entity A is end A;\n");
+    REQUIRE_FALSE(
+      std::filesystem::exists(path.parent_path() / ".vhdl-fmt-write-source.vhd.vhdl-fmt~"));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("The netlist layout matches the standard one", "[pipeline][layout]")
+{
+    // A generated body, with assignments too long for one line
+    std::string netlist{"entity top is end top;\narchitecture syn of top is\nbegin\n"};
+    for (std::size_t i = 0; i < 300; ++i) {
+        netlist += std::format("n{} <= n{} and n{} or not (n{} xor carry_chain_{});\n",
+                               i,
+                               i + 1,
+                               i + 2,
+                               i + 3,
+                               i % 7 == 0 ? std::string(80, 'x') : std::to_string(i));
+    }
+    netlist += "end syn;\n";
+
+    std::vector<std::string> sources{netlist};
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        sources.push_back(pipeline::readSource(entry.path()));
+    }
+
+    for (const auto& source : sources) {
+        const auto standard = pipeline::formatSource(
+          source, common::Config{.layout = common::LayoutMode::STANDARD});
+        REQUIRE(standard.has_value());
+
+        for (const auto layout : {common::LayoutMode::AUTO, common::LayoutMode::NETLIST}) {
+            const auto formatted = pipeline::formatSource(source, common::Config{.layout = layout});
+            REQUIRE(formatted.has_value());
+            CHECK(*formatted == *standard);
+        }
+    }
+}
+
+TEST_CASE("formatVariants matches formatSource under every config", "[pipeline][variants]")
+{
+    std::vector<common::Config> configs{};
+    for (const std::uint16_t width : {40, 80, 120}) {
+        for (const std::uint8_t indent : {2, 4}) {
+            configs.push_back(
+              common::Config{.line_config = {.line_length = width, .indent_size = indent}});
+        }
+    }
+
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        const auto variants = pipeline::formatVariants(source, configs, 0);
+        REQUIRE(variants.has_value());
+        REQUIRE(variants->size() == configs.size());
+
+        for (std::size_t k = 0; k < configs.size(); ++k) {
+            const auto formatted = pipeline::formatSource(source, configs.at(k));
+            REQUIRE(formatted.has_value());
+            CHECK(variants->at(k).text == *formatted);
+        }
+    }
+}
+
+TEST_CASE("Statistics cover every phase of a format", "[pipeline][stats]")
+{
+    if (!common::stats::COMPILED) {
+        SKIP("Built without statistics");
+    }
+
+    using common::stats::Counter;
+    using common::stats::Phase;
+
+    auto& registry = common::stats::Registry::instance();
+    registry.reset();
+    registry.enable();
+
+    // A unit no other test renders, so the render cache has nothing for it
+    const auto formatted = pipeline::formatSource(
+      "entity stats_probe is port (x : in bit); end stats_probe;\n", common::Config{});
+
+    registry.enable(false);
+    const auto stats = registry.snapshot();
+    registry.reset();
+
+    REQUIRE(formatted.has_value());
+
+    const auto counter = [&stats](Counter c) {
+        return stats.counters.at(static_cast<std::size_t>(c));
+    };
+    CHECK(counter(Counter::TOKENS) > 0);
+    CHECK(counter(Counter::CST_NODES) > counter(Counter::AST_NODES));
+    CHECK(counter(Counter::AST_NODES) > 0);
+    CHECK(counter(Counter::DOC_NODES) > 0);
+
+    for (const auto phase : {Phase::LEX, Phase::SLL_PARSE, Phase::TRANSLATE, Phase::DOC_BUILD,
+                             Phase::RENDER, Phase::VERIFY}) {
+        INFO(common::stats::PHASE_NAMES.at(static_cast<std::size_t>(phase)));
+        CHECK(stats.phases.at(static_cast<std::size_t>(phase)).count() > 0);
+    }
+}
+
+TEST_CASE("explainLayout names the source line of every group", "[pipeline][explain]")
+{
+    common::Config config{};
+    config.line_config.line_length = 30;
+
+    const auto report = pipeline::explainLayout(
+      "entity A is\n  port (clk : in bit; rst : in bit; data : out bit);\nend A;\n", config);
+
+    std::istringstream lines{report};
+    std::string line{};
+    REQUIRE(std::getline(lines, line));
+    CHECK(line.find("source") != std::string::npos);
+
+    // The port clause is too wide for the line and comes from line 2 of the source
+    auto broken_on_line_two = false;
+    while (std::getline(lines, line)) {
+        std::istringstream fields{line};
+        std::string source_line{};
+        std::string position{};
+        std::string decision{};
+        fields >> source_line >> position >> decision;
+        broken_on_line_two = broken_on_line_two || (source_line == "2" && decision == "broken");
+    }
+    CHECK(broken_on_line_two);
+}
@@ -0,0 +1,187 @@
+#include "builder/ast_builder.hpp"
+#include "common/config.hpp"
+#include "common/stats.hpp"
+#include "emit/format.hpp"
+#include "pipeline/format.hpp"
+#include "pipeline/render_cache.hpp"
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view CODE = R"(-- Header
+entity A is
+port(clk : in std_logic);
+end A;
+
+architecture rtl of A is begin end rtl; -- trailing
+)";
+
+auto formatUncached(std::string_view source, const common::Config& config) -> std::string
+{
+    auto ctx = builder::createContext(source);
+    const auto root = builder::build(ctx);
+    return emit::format(root, config);
+}
+
+auto formatCached(std::string_view source, const common::Config& config) -> std::string
+{
+    const auto formatted = pipeline::formatSource(source, config);
+    REQUIRE(formatted.has_value());
+    return *formatted;
+}
+
+} // namespace
+
+TEST_CASE("Repeated units are served from the render cache", "[pipeline][render_cache]")
+{
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    const auto first = formatCached(CODE, common::Config{});
+    REQUIRE(cache.stats().misses == 2);
+    REQUIRE(cache.stats().hits == 0);
+
+    const auto second = formatCached(CODE, common::Config{});
+    REQUIRE(second == first);
+    REQUIRE(cache.stats().hits == 2);
+    REQUIRE(cache.stats().entries == 2);
+    REQUIRE(cache.stats().hitRate() == 0.5);
+}
+
+TEST_CASE("Render cache lookups are counted in the statistics", "[pipeline][render_cache]")
+{
+    if (!common::stats::COMPILED) {
+        SKIP("Built without statistics");
+    }
+
+    using common::stats::Counter;
+
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    auto& registry = common::stats::Registry::instance();
+    registry.reset();
+    registry.enable();
+
+    formatCached(CODE, common::Config{});
+    formatCached(CODE, common::Config{});
+
+    registry.enable(false);
+    const auto stats = registry.snapshot();
+    registry.reset();
+
+    CHECK(stats.counters.at(static_cast<std::size_t>(Counter::RENDER_CACHE_MISSES)) == 2);
+    CHECK(stats.counters.at(static_cast<std::size_t>(Counter::RENDER_CACHE_HITS)) == 2);
+    CHECK(stats.counters.at(static_cast<std::size_t>(Counter::RENDER_CACHE_EVICTIONS)) == 0);
+}
+
+TEST_CASE("Only changed units miss the render cache", "[pipeline][render_cache]")
+{
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    formatCached(CODE, common::Config{});
+
+    SECTION("Edited architecture")
+    {
+        const std::string edited{
+          "-- Header\nentity A is\nport(clk : in std_logic);\nend A;\n\n"
+          "architecture rtl of A is signal s : bit; begin end rtl; -- trailing\n"};
+
+        REQUIRE(formatCached(edited, common::Config{}) == formatUncached(edited, common::Config{}));
+        REQUIRE(cache.stats().hits == 1);
+        REQUIRE(cache.stats().misses == 3);
+    }
+
+    SECTION("Edited trivia")
+    {
+        const std::string edited{
+          "-- Header\nentity A is\nport(clk : in std_logic);\nend A;\n\n"
+          "architecture rtl of A is begin end rtl; -- changed\n"};
+
+        REQUIRE(formatCached(edited, common::Config{}) == formatUncached(edited, common::Config{}));
+        REQUIRE(cache.stats().hits == 1);
+    }
+
+    SECTION("Re-indented source")
+    {
+        const std::string edited{
+          "-- Header\nentity A is\n    port(clk : in std_logic);\nend A;\n\n"
+          "architecture rtl of A is begin end rtl; -- trailing\n"};
+
+        REQUIRE(formatCached(edited, common::Config{}) == formatUncached(edited, common::Config{}));
+        REQUIRE(cache.stats().hits == 2);
+    }
+
+    SECTION("Different config")
+    {
+        const common::Config upper{.casing = {.keywords = common::CaseStyle::UPPER}};
+
+        REQUIRE(formatCached(CODE, upper) == formatUncached(CODE, upper));
+        REQUIRE(cache.stats().hits == 0);
+        REQUIRE(cache.stats().entries == 4);
+    }
+}
+
+TEST_CASE("A unit keeps the leading trivia only when it comes first", "[pipeline][render_cache]")
+{
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    const std::string alone{"-- Note\nentity B is end B;\n"};
+    const std::string after{"entity A is end A;\n-- Note\nentity B is end B;\n"};
+
+    REQUIRE(formatCached(alone, common::Config{}) == formatUncached(alone, common::Config{}));
+    REQUIRE(formatCached(after, common::Config{}) == formatUncached(after, common::Config{}));
+}
+
+TEST_CASE("The render cache evicts the least recently used units", "[pipeline][render_cache]")
+{
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+    cache.setCapacity(1);
+
+    formatCached(CODE, common::Config{});
+    REQUIRE(cache.stats().entries == 1);
+    REQUIRE(cache.stats().evictions == 1);
+
+    const std::string single{"entity B is end B;\n"};
+    formatCached(single, common::Config{});
+    formatCached(single, common::Config{});
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(cache.stats().evictions == 2);
+
+    cache.setCapacity(0);
+    REQUIRE(cache.stats().entries == 0);
+    REQUIRE(formatCached(CODE, common::Config{}) == formatUncached(CODE, common::Config{}));
+    REQUIRE(cache.stats().entries == 0);
+
+    cache.setCapacity(pipeline::RenderCache::DEFAULT_CAPACITY);
+    cache.clear();
+}
+
+TEST_CASE("Cached formatting matches the uncached printer on the corpus",
+          "[pipeline][render_cache]")
+{
+    auto& cache = pipeline::RenderCache::instance();
+    cache.clear();
+
+    for (const auto& entry :
+         std::filesystem::directory_iterator{std::filesystem::path{TEST_DATA_DIR} / "vhdl"}) {
+        INFO(entry.path().filename().string());
+
+        const auto source = pipeline::readSource(entry.path());
+        const auto expected = formatUncached(source, common::Config{});
+
+        CHECK(formatCached(source, common::Config{}) == expected);
+        CHECK(formatCached(source, common::Config{}) == expected);
+    }
+
+    CHECK(cache.stats().hits >= cache.stats().misses);
+}
@@ -0,0 +1,71 @@
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+#include "vhdlfmt/formatter.hpp"
+#include "vhdlfmt/vhdlfmt.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view UNFORMATTED = "ENTITY a IS\nport(x:in bit);\nEND a;\n";
+
+} // namespace
+
+TEST_CASE("C API formats into the session buffer", "[vhdlfmt][c_api]")
+{
+    auto* formatter = vhdlfmt_create();
+    REQUIRE(formatter != nullptr);
+
+    const auto expected = pipeline::formatSource(UNFORMATTED, common::Config{});
+    REQUIRE(expected.has_value());
+
+    const char* output = nullptr;
+    std::size_t length = 0;
+    for (int round = 0; round < 2; ++round) {
+        const auto status =
+          vhdlfmt_format(formatter, UNFORMATTED.data(), UNFORMATTED.size(), &output, &length);
+        REQUIRE(status == VHDLFMT_OK);
+        REQUIRE(std::string_view{output, length} == *expected);
+        REQUIRE(std::string_view{vhdlfmt_last_error(formatter)}.empty());
+    }
+
+    vhdlfmt_destroy(formatter);
+}
+
+TEST_CASE("C API reports errors", "[vhdlfmt][c_api]")
+{
+    auto* formatter = vhdlfmt_create();
+    REQUIRE(formatter != nullptr);
+
+    const char* output = nullptr;
+    std::size_t length = 0;
+
+    const std::string_view broken = "entity a is port(; end;";
+    REQUIRE(vhdlfmt_format(formatter, broken.data(), broken.size(), &output, &length)
+            == VHDLFMT_SYNTAX_ERROR);
+    REQUIRE_FALSE(std::string_view{vhdlfmt_last_error(formatter)}.empty());
+
+    REQUIRE(vhdlfmt_format(formatter, nullptr, 1, &output, &length) == VHDLFMT_INVALID_ARGUMENT);
+    REQUIRE(vhdlfmt_format(nullptr, broken.data(), broken.size(), &output, &length)
+            == VHDLFMT_INVALID_ARGUMENT);
+
+    vhdlfmt_destroy(formatter);
+}
+
+TEST_CASE("C API rejects an unreadable configuration", "[vhdlfmt][c_api]")
+{
+    REQUIRE(vhdlfmt_create_from_file("/nonexistent/vhdl-fmt.yaml") == nullptr);
+}
+
+TEST_CASE("C API sets the prediction cache limit", "[vhdlfmt][c_api]")
+{
+    const auto previous = vhdlfmt::Formatter::predictionCacheLimit();
+
+    vhdlfmt_set_prediction_cache_limit(0);
+    REQUIRE(vhdlfmt::Formatter::predictionCacheLimit() == 0);
+
+    vhdlfmt_set_prediction_cache_limit(previous);
+}
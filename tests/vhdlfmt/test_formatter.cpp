@@ -0,0 +1,83 @@
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+#include "vhdlfmt/formatter.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view UNFORMATTED = "ENTITY a IS\nport(x:in bit);\nEND a;\n";
+
+auto dataFile(std::string_view directory, std::string_view name) -> std::filesystem::path
+{
+    return std::filesystem::path{TEST_DATA_DIR} / directory / name;
+}
+
+} // namespace
+
+TEST_CASE("Formatter matches formatSource", "[vhdlfmt]")
+{
+    vhdlfmt::Formatter formatter{};
+
+    const auto expected = pipeline::formatSource(UNFORMATTED, common::Config{});
+    REQUIRE(expected.has_value());
+
+    const auto formatted = formatter.format(UNFORMATTED);
+    REQUIRE(formatted.has_value());
+    REQUIRE(*formatted == *expected);
+}
+
+TEST_CASE("Formatter reuses its session across sources", "[vhdlfmt]")
+{
+    vhdlfmt::Formatter formatter{};
+
+    for (const auto* const name : {"ports.vhd", "comments.vhd", "big.vhd", "ports.vhd"}) {
+        const auto source = pipeline::readSource(dataFile("vhdl", name));
+        const auto expected = pipeline::formatSource(source, common::Config{});
+        REQUIRE(expected.has_value());
+
+        const auto formatted = formatter.format(source);
+        REQUIRE(formatted.has_value());
+        REQUIRE(*formatted == *expected);
+    }
+}
+
+TEST_CASE("Formatter recovers after a syntax error", "[vhdlfmt]")
+{
+    vhdlfmt::Formatter formatter{};
+
+    const auto broken = formatter.format("entity a is port(; end;");
+    REQUIRE_FALSE(broken.has_value());
+    REQUIRE(broken.error().kind == vhdlfmt::ErrorKind::SYNTAX);
+
+    const auto formatted = formatter.format(UNFORMATTED);
+    REQUIRE(formatted.has_value());
+}
+
+TEST_CASE("Formatter reads its configuration file", "[vhdlfmt]")
+{
+    const auto formatter =
+      vhdlfmt::Formatter::fromConfigFile(dataFile("config_file", "valid_complete.yaml"));
+    REQUIRE(formatter.has_value());
+    REQUIRE(formatter->config().line_config.line_length == 120);
+
+    const auto missing = vhdlfmt::Formatter::fromConfigFile(dataFile("config_file", "none.yaml"));
+    REQUIRE_FALSE(missing.has_value());
+    REQUIRE(missing.error().kind == vhdlfmt::ErrorKind::CONFIG);
+}
+
+TEST_CASE("Formatter bounds the prediction caches", "[vhdlfmt]")
+{
+    const auto previous = vhdlfmt::Formatter::predictionCacheLimit();
+    REQUIRE(previous > 0);
+
+    vhdlfmt::Formatter::setPredictionCacheLimit(1);
+    vhdlfmt::Formatter formatter{};
+    REQUIRE(formatter.format(UNFORMATTED).has_value());
+    REQUIRE(vhdlfmt::Formatter::predictionCacheLimit() == 1);
+
+    vhdlfmt::Formatter::setPredictionCacheLimit(previous);
+}
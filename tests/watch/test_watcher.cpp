@@ -0,0 +1,139 @@
+#include "common/config.hpp"
+#include "pipeline/format.hpp"
+#include "watch/watcher.hpp"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr std::string_view UNFORMATTED = "ENTITY a IS\nport(x:in bit);\nEND a;\n";
+constexpr auto TIMEOUT = std::chrono::seconds{5};
+
+auto save(const std::filesystem::path& path, std::string_view text) -> void
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file << text;
+}
+
+auto contentOf(const std::filesystem::path& path) -> std::string
+{
+    return pipeline::readSource(path);
+}
+
+/// @brief Polls the file until it holds the expected text or the timeout expires.
+auto waitFor(const std::filesystem::path& path, std::string_view expected) -> bool
+{
+    const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (std::filesystem::exists(path) && contentOf(path) == expected) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    return false;
+}
+
+/// @brief A fresh directory that is removed with the fixture.
+class TempDirectory final
+{
+  public:
+    TempDirectory() :
+      path_{std::filesystem::temp_directory_path() / "vhdl_fmt_watch_test"}
+    {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDirectory()
+    {
+        std::filesystem::remove_all(path_);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    auto operator=(const TempDirectory&) -> TempDirectory& = delete;
+    TempDirectory(TempDirectory&&) = delete;
+    auto operator=(TempDirectory&&) -> TempDirectory& = delete;
+
+    [[nodiscard]]
+    auto path() const -> const std::filesystem::path&
+    {
+        return path_;
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+} // namespace
+
+TEST_CASE("Watcher formats VHDL files when they are saved", "[watch]")
+{
+    const TempDirectory dir{};
+    const auto existing = dir.path() / "existing.vhd";
+    save(existing, UNFORMATTED);
+
+    watch::Watcher watcher{dir.path(), common::Config{}, std::chrono::milliseconds{5}};
+    std::atomic<int> exit_code{-1};
+    std::jthread thread{[&watcher, &exit_code] { exit_code = watcher.run(); }};
+
+    const auto expected = pipeline::formatSource(UNFORMATTED, common::Config{});
+    REQUIRE(expected.has_value());
+
+    SECTION("A saved file is formatted in place")
+    {
+        const auto file = dir.path() / "top.vhd";
+        save(file, UNFORMATTED);
+        REQUIRE(waitFor(file, *expected));
+
+        // Only the output and no temporary file is left behind
+        std::size_t entries{0};
+        for (const auto& entry : std::filesystem::directory_iterator{dir.path()}) {
+            static_cast<void>(entry);
+            ++entries;
+        }
+        REQUIRE(entries == 2);
+    }
+
+    SECTION("Files in new subdirectories are watched too")
+    {
+        const auto subdirectory = dir.path() / "rtl";
+        std::filesystem::create_directory(subdirectory);
+
+        const auto file = subdirectory / "core.VHDL";
+        save(file, UNFORMATTED);
+        REQUIRE(waitFor(file, *expected));
+    }
+
+    SECTION("Other files and files with syntax errors are left alone")
+    {
+        const auto notes = dir.path() / "notes.txt";
+        save(notes, UNFORMATTED);
+
+        const auto broken = dir.path() / "broken.vhd";
+        save(broken, "entity a is");
+
+        // A file saved afterwards shows that the others have been handled
+        const auto file = dir.path() / "last.vhd";
+        save(file, UNFORMATTED);
+        REQUIRE(waitFor(file, *expected));
+
+        REQUIRE(contentOf(notes) == UNFORMATTED);
+        REQUIRE(contentOf(broken) == "entity a is");
+    }
+
+    watcher.stop();
+    thread.join();
+    REQUIRE(exit_code == 0);
+
+    // Not saved while watched
+    REQUIRE(contentOf(existing) == UNFORMATTED);
+}